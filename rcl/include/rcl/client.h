@@ -24,6 +24,7 @@ extern "C"
 
 #include "rcl/macros.h"
 #include "rcl/node.h"
+#include "rcl/statistics.h"
 #include "rcl/visibility_control.h"
 
 /// Internal rcl client implementation struct.
@@ -231,8 +232,17 @@ rcl_client_get_default_options(void);
  * Allocates Memory   | No
  * Thread-Safe        | Yes [1]
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | Maybe [2]
  * <i>[1] for unique pairs of clients and requests, see above for more</i>
+ * <i>[2] no if the client has a request window</i>
+ *
+ * If the client has a request window, see rcl_client_init_request_window(),
+ * the request is tracked as in flight while holding the mutex of the window,
+ * so sends are serialized with each other and with the functions using it.
+ * Its slot is reserved before sending, by the sequence number following the
+ * last one; should the middleware give the request another number whose slot
+ * is taken, the request is sent but not tracked, so its response can only be
+ * taken with rcl_take_response().
  *
  * \param[in] client handle to the client which will make the response
  * \param[in] ros_request type-erased pointer to the ROS request message
@@ -240,6 +250,10 @@ rcl_client_get_default_options(void);
  * \return `RCL_RET_OK` if the request was sent successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
  * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_CLIENT_REQUEST_WINDOW_FULL` if the request window of the
+ *         client has no room for the request, which is then not sent, or
+ * \return `RCL_RET_CLIENT_REQUEST_NOT_TRACKED` if the request was sent, with
+ *         `sequence_number` set, but the request window could not track it, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
 RCL_PUBLIC
@@ -264,14 +278,20 @@ rcl_send_request(const rcl_client_t * client, const void * ros_request, int64_t
  * struct of the correct type, into which the response from the service will be
  * copied.
  *
+ * Responses are taken in the order they arrive.
+ * If the client has a request window, the request the response answers is
+ * no longer in flight, but the responses which rcl_client_take_response_for()
+ * kept for later are not returned by this function.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | Maybe [1]
  * Thread-Safe        | No
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | Maybe [2]
  * <i>[1] only if required when filling the message, avoided for fixed sizes</i>
+ * <i>[2] no if the client has a request window</i>
  *
  * \param[in] client handle to the client which will take the response
  * \param[inout] request_header pointer to the request header
@@ -300,6 +320,241 @@ rcl_take_response(
   rmw_request_id_t * request_header,
   void * ros_response);
 
+/// Track the requests in flight to take their responses by sequence number.
+/**
+ * Up to `window_size` requests sent by rcl_send_request() are tracked in a
+ * table indexed by their sequence number, so that
+ * rcl_client_take_response_for() finds the response of any of them without
+ * the caller keeping its own map of the requests in flight.
+ * Sending more requests than that fails until responses are taken or
+ * requests are cancelled with rcl_client_cancel_request().
+ *
+ * A response taken while looking for another one is kept in a preallocated
+ * response of `response_size` bytes, initialized once with `init_function`
+ * and finalized with `fini_function` when the client is finalized.
+ * These are the `__init` and `__fini` functions generated for the response
+ * type in C, and `response_size` is `sizeof` the response structure.
+ * About as many responses as the window size, rounded up to a power of two,
+ * are preallocated.
+ *
+ * A client has at most one request window.
+ * The window is guarded by a mutex, so the functions using it can be called
+ * concurrently with each other and with rcl_send_request(), but not with
+ * this function or rcl_client_fini().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] client the client owning the request window
+ * \param[in] window_size the maximum number of requests in flight
+ * \param[in] response_size the size of one response in bytes
+ * \param[in] init_function the function initializing one response
+ * \param[in] fini_function the function finalizing one response
+ * \return `RCL_RET_OK` if the request window was created, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_ALREADY_INIT` if the client already has a request window, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if a response failed to initialize.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_init_request_window(
+  const rcl_client_t * client,
+  size_t window_size,
+  size_t response_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function);
+
+/// Take the response to the request with the given sequence number.
+/**
+ * The responses which are available are taken until the one answering the
+ * request is found, and those answering other requests in flight are kept
+ * for later calls; rcl_wait() reports the client as ready while it keeps any.
+ * Responses to requests which are not in flight, e.g. cancelled ones, are dropped.
+ * Once its response is taken, the request is no longer in flight.
+ *
+ * The response is handed out by swapping the contents of `ros_response` with
+ * the kept response, so `ros_response` must be an initialized response
+ * message, and its previous contents are reused for later responses rather
+ * than finalized.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ * <i>[1] only if required when filling the message, avoided for fixed sizes</i>
+ *
+ * \param[in] client the client which sent the request
+ * \param[in] sequence_number the sequence number of the request, as given by rcl_send_request()
+ * \param[out] response_header the header of the response
+ * \param[inout] ros_response type-erased pointer to an initialized ROS response message
+ * \return `RCL_RET_OK` if the response was taken successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or if the
+ *         request is not in flight, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the client has no request window, or
+ * \return `RCL_RET_CLIENT_TAKE_FAILED` if the response has not arrived yet, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_take_response_for(
+  const rcl_client_t * client,
+  int64_t sequence_number,
+  rmw_service_info_t * response_header,
+  void * ros_response);
+
+/// Stop tracking a request in flight, whose response is then dropped.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] client the client which sent the request
+ * \param[in] sequence_number the sequence number of the request
+ * \return `RCL_RET_OK` if the request was cancelled, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if the request is not in flight, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the client has no request window.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_cancel_request(const rcl_client_t * client, int64_t sequence_number);
+
+/// Set the timeout of the requests which the client sends from now on.
+/**
+ * A request which is still in flight once its timeout elapsed, measured from
+ * when it was sent on the steady clock, expires.
+ * Expired requests stay in flight until they are swept with
+ * rcl_client_sweep_expired_requests(), and rcl_wait() wakes up when the
+ * earliest of them expires and reports the client as ready, like it does for
+ * timers, so that no timer is needed per request.
+ * rcl_wait_ex() also flags the client as timed out, see
+ * rcl_wait_set_ready_entity_t::client_timed_out.
+ *
+ * A negative timeout, the default, lets requests wait for their response forever.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] client the client whose requests time out
+ * \param[in] timeout the timeout of each request in nanoseconds, or negative for none
+ * \return `RCL_RET_OK` if the timeout was set, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the client has no request window.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_set_default_request_timeout(const rcl_client_t * client, int64_t timeout);
+
+/// Set the timeout of a request in flight, counted from now.
+/**
+ * This overrides the timeout the request was sent with, see
+ * rcl_client_set_default_request_timeout().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] client the client which sent the request
+ * \param[in] sequence_number the sequence number of the request
+ * \param[in] timeout the timeout of the request in nanoseconds, or negative for none
+ * \return `RCL_RET_OK` if the timeout was set, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if the request is not in flight, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the client has no request window, or
+ * \return `RCL_RET_ERROR` if reading the steady clock failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_set_request_timeout(
+  const rcl_client_t * client,
+  int64_t sequence_number,
+  int64_t timeout);
+
+/// Stop tracking the requests which expired, and get their sequence numbers.
+/**
+ * Up to `capacity` expired requests leave the request window, as if they were
+ * cancelled with rcl_client_cancel_request(), and their sequence numbers are
+ * stored in `sequence_numbers`, in no particular order.
+ * If `count` is `capacity`, more requests may have expired.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] client the client which sent the requests
+ * \param[out] sequence_numbers storage for `capacity` sequence numbers
+ * \param[in] capacity the number of sequence numbers `sequence_numbers` can hold
+ * \param[out] count the number of expired requests swept
+ * \return `RCL_RET_OK` if the expired requests were swept, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the client has no request window, or
+ * \return `RCL_RET_ERROR` if reading the steady clock failed.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_sweep_expired_requests(
+  const rcl_client_t * client,
+  int64_t * sequence_numbers,
+  size_t capacity,
+  size_t * count);
+
+/// Get the number of requests of the client which are in flight.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] client the client to be queried
+ * \param[out] in_flight_count the number of requests in flight
+ * \return `RCL_RET_OK` if the count was retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the client has no request window.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_get_in_flight_count(const rcl_client_t * client, size_t * in_flight_count);
+
 /// Get the name of the service that this client will request a response from.
 /**
  * This function returns the client's internal service name string.
@@ -407,6 +662,28 @@ RCL_PUBLIC
 bool
 rcl_client_is_valid(const rcl_client_t * client);
 
+/// Get the counters of the requests sent and the responses taken by a client.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] client the client to be queried
+ * \param[out] statistics the counters of the client
+ * \return `RCL_RET_OK` if the counters were retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_get_statistics(const rcl_client_t * client, rcl_client_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
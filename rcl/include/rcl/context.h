@@ -26,6 +26,7 @@ extern "C"
 #include "rcl/arguments.h"
 #include "rcl/init_options.h"
 #include "rcl/macros.h"
+#include "rcl/time.h"
 #include "rcl/types.h"
 #include "rcl/visibility_control.h"
 
@@ -311,6 +312,38 @@ RCL_WARN_UNUSED
 rmw_context_t *
 rcl_context_get_rmw_context(rcl_context_t * context);
 
+/// Return pointer to the ROS time source of the given context.
+/**
+ * Clocks initialized with `rcl_ros_clock_init_attached()` from this clock share a single
+ * ROS time source, so setting the ROS time override once, e.g. when a `/clock` message is
+ * received, updates all of them.
+ * The returned clock is owned by the context and must not be finalized by the caller, but
+ * clocks attached to it may outlive the context.
+ *
+ * If context is `NULL`, then `NULL` is returned.
+ * If context is zero-initialized, then `NULL` is returned.
+ * If context is uninitialized, then it is undefined behavior.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] it must not be called concurrently with rcl_context_fini(), which finalizes the
+ *    returned clock; attaching clocks to the returned clock from several threads is safe,
+ *    see `rcl_ros_clock_init_attached()`</i>
+ *
+ * \param[in] context object from which the ROS clock should be retrieved.
+ * \return pointer to the ROS clock of the context, or
+ * \return `NULL` if there was an error
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_clock_t *
+rcl_context_get_ros_clock(rcl_context_t * context);
+
 #ifdef __cplusplus
 }
 #endif
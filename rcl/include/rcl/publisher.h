@@ -24,6 +24,7 @@ extern "C"
 
 #include "rcl/macros.h"
 #include "rcl/node.h"
+#include "rcl/statistics.h"
 #include "rcl/visibility_control.h"
 
 /// Internal rcl publisher implementation struct.
@@ -197,10 +198,65 @@ RCL_WARN_UNUSED
 rcl_publisher_options_t
 rcl_publisher_get_default_options(void);
 
+/// Preallocate a pool of messages to loan when the middleware cannot loan.
+/**
+ * If the middleware cannot loan messages for this publisher, the messages
+ * loaned by rcl_borrow_loaned_message() are taken from a pool of `pool_size`
+ * messages of `message_size` bytes instead, each initialized once with
+ * `init_function` and finalized with `fini_function` when the pool is
+ * finalized along with the publisher.
+ * These are the `__init` and `__fini` functions generated for the message
+ * type in C, and `message_size` is `sizeof` the message structure.
+ * If the middleware can loan messages, no pool is created and its loans are
+ * used as before.
+ *
+ * A `pool_size` of `0` sizes the pool by the depth of the actual QoS of the
+ * publisher, which is then required to be non-zero.
+ *
+ * Messages of the pool are published by copy with rcl_publish_loaned_message(),
+ * which returns them to the pool, so that code written against loaned messages
+ * fills preallocated messages rather than allocating one per publish.
+ *
+ * A publisher has at most one pool, see rcl_publisher_has_message_pool().
+ * The pool is guarded by a mutex, so its messages can be borrowed, published
+ * and returned from several threads.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] publisher the publisher owning the pool
+ * \param[in] message_size the size of one message in bytes
+ * \param[in] init_function the function initializing one message
+ * \param[in] fini_function the function finalizing one message
+ * \param[in] pool_size the number of messages, or `0` for the QoS depth
+ * \return `RCL_RET_OK` if the pool was created or the middleware loans messages, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_PUBLISHER_INVALID` if the publisher is invalid, or
+ * \return `RCL_RET_ALREADY_INIT` if the publisher already has a pool, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if a message failed to initialize.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publisher_init_message_pool(
+  const rcl_publisher_t * publisher,
+  size_t message_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  size_t pool_size);
+
 /// Borrow a loaned message.
 /**
  * The memory allocated for the ros message belongs to the middleware and must not be deallocated
  * other than by a call to \sa rcl_return_loaned_message_from_publisher.
+ * If the publisher has a message pool, see rcl_publisher_init_message_pool(), the message
+ * is taken from the pool instead and `type_support` is not used.
  *
  * <hr>
  * Attribute          | Adherence
@@ -208,9 +264,10 @@ rcl_publisher_get_default_options(void);
  * Allocates Memory   | No [0]
  * Thread-Safe        | No
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | Maybe [1]
  * [0] the underlying middleware might allocate new memory or returns an existing chunk form a pool.
  * The function in rcl however does not allocate any additional memory.
+ * <i>[1] no if the publisher has a message pool</i>
  *
  * \param[in] publisher Publisher to which the allocated message is associated.
  * \param[in] type_support Typesupport to which the internal ros message is allocated.
@@ -219,6 +276,7 @@ rcl_publisher_get_default_options(void);
  * \return `RCL_RET_INVALID_ARGUMENT` if an argument other than the ros message is null, or
  * \return `RCL_RET_BAD_ALLOC` if the ros message could not be correctly created, or
  * \return `RCL_RET_UNIMPLEMENTED` if the middleware does not support that feature, or
+ * \return `RCL_RET_PUBLISHER_MESSAGE_POOL_EXHAUSTED` if every message of the pool is loaned, or
  * \return `RCL_RET_ERROR` if an unexpected error occured.
  */
 RCL_PUBLIC
@@ -234,6 +292,7 @@ rcl_borrow_loaned_message(
  * The ownership of the passed in ros message will be transferred back to the middleware.
  * The middleware might deallocate and destroy the message so that the pointer is no longer
  * guaranteed to be valid after that call.
+ * A message of the publisher message pool is returned to the pool.
  *
  * <hr>
  * Attribute          | Adherence
@@ -241,7 +300,8 @@ rcl_borrow_loaned_message(
  * Allocates Memory   | No
  * Thread-Safe        | No
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | Maybe [1]
+ * <i>[1] no if the publisher has a message pool</i>
  *
  * \param[in] publisher Publisher to which the loaned message is associated.
  * \param[in] loaned_message Loaned message to be deallocated and destroyed.
@@ -323,6 +383,46 @@ rcl_publish(
   const void * ros_message,
   rmw_publisher_allocation_t * allocation);
 
+/// Publish several ROS messages on a topic using a publisher.
+/**
+ * Behaves like calling rcl_publish() on each message in turn, but checks the
+ * publisher and the messages once, before publishing any of them.
+ * The messages are published in order and publishing stops at the first
+ * message which fails to be published; `published_count` then tells how many
+ * were published before it.
+ *
+ * The middleware interface has no batched publish, so each message is still
+ * handed to the middleware separately.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] for unique pairs of publishers and messages, see rcl_publish()</i>
+ *
+ * \param[in] publisher handle to the publisher which will do the publishing
+ * \param[in] ros_messages array of `count` type-erased pointers to the ROS messages
+ * \param[in] count number of messages to publish
+ * \param[out] published_count number of messages published (may be NULL)
+ * \param[in] allocation structure pointer, used for memory preallocation (may be NULL)
+ * \return `RCL_RET_OK` if every message was published successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_PUBLISHER_INVALID` if the publisher is invalid, or
+ * \return `RCL_RET_ERROR` if a message failed to be published.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publish_batch(
+  const rcl_publisher_t * publisher,
+  const void * const * ros_messages,
+  size_t count,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation);
+
 /// Publish a serialized message on a topic using a publisher.
 /**
  * It is the job of the caller to ensure that the type of the serialized message
@@ -363,6 +463,41 @@ rcl_publish_serialized_message(
   const rcl_serialized_message_t * serialized_message,
   rmw_publisher_allocation_t * allocation);
 
+/// Publish several serialized messages on a topic using a publisher.
+/**
+ * The serialized counterpart of rcl_publish_batch(), which behaves like
+ * calling rcl_publish_serialized_message() on each message in turn.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] for unique pairs of publishers and messages, see rcl_publish()</i>
+ *
+ * \param[in] publisher handle to the publisher which will do the publishing
+ * \param[in] serialized_messages array of `count` pointers to serialized messages
+ * \param[in] count number of messages to publish
+ * \param[out] published_count number of messages published (may be NULL)
+ * \param[in] allocation structure pointer, used for memory preallocation (may be NULL)
+ * \return `RCL_RET_OK` if every message was published successfully, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_PUBLISHER_INVALID` if the publisher is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publish_serialized_message_batch(
+  const rcl_publisher_t * publisher,
+  const rcl_serialized_message_t * const * serialized_messages,
+  size_t count,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation);
+
 /// Publish a loaned message on a topic using a publisher.
 /**
  * A previously borrowed loaned message can be sent via this call to `rcl_publish_loaned_message`.
@@ -376,22 +511,28 @@ rcl_publish_serialized_message(
  * Apart from this, the `publish_loaned_message` function has the same behavior as `rcl_publish`
  * except that no serialization step is done.
  *
+ * A message of the publisher message pool is published with `rcl_publish` semantics instead
+ * and returned to the pool once published, or kept loaned if publishing failed.
+ * A message which is not loaned by the pool is then not published.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No [0]
  * Thread-Safe        | Yes [1]
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | Maybe [2]
  * <i>[0] the middleware might deallocate the loaned message.
  * The RCL function however does not allocate any memory.</i>
  * <i>[1] for unique pairs of publishers and messages, see above for more</i>
+ * <i>[2] no if the publisher has a message pool</i>
  *
  * \param[in] publisher handle to the publisher which will do the publishing
  * \param[in] ros_message  pointer to the previously borrow loaned message
  * \param[in] allocation structure pointer, used for memory preallocation (may be NULL)
  * \return `RCL_RET_OK` if the message was published successfully, or
- * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid or the publisher has a
+ *   message pool which did not loan the message, or
  * \return `RCL_RET_PUBLISHER_INVALID` if the publisher is invalid, or
  * \return `RCL_RET_UNIMPLEMENTED` if the middleware does not support that feature, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
@@ -640,6 +781,46 @@ RCL_PUBLIC
 bool
 rcl_publisher_can_loan_messages(const rcl_publisher_t * publisher);
 
+/// Check if the loans of a publisher are backed by its message pool.
+/**
+ * This returns true if rcl_publisher_init_message_pool() created a pool, i.e.
+ * if rcl_borrow_loaned_message() lends preallocated messages which are
+ * published by copy, while rcl_publisher_can_loan_messages() returns false.
+ */
+RCL_PUBLIC
+bool
+rcl_publisher_has_message_pool(const rcl_publisher_t * publisher);
+
+/// Get the counters of the messages published by a publisher.
+/**
+ * Messages published with rcl_publish(), rcl_publish_batch() and
+ * rcl_publish_loaned_message() are counted as messages, and those published
+ * with rcl_publish_serialized_message() and its batch variant as serialized
+ * messages along with their size.
+ * The counters start at zero when the publisher is initialized.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] publisher the publisher to be queried
+ * \param[out] statistics the counters of the publisher
+ * \return `RCL_RET_OK` if the counters were retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_PUBLISHER_INVALID` if the publisher is invalid, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publisher_get_statistics(
+  const rcl_publisher_t * publisher,
+  rcl_publisher_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@ extern "C"
 
 #include "rcl/macros.h"
 #include "rcl/node.h"
+#include "rcl/statistics.h"
 #include "rcl/visibility_control.h"
 
 /// Internal rcl implementation struct.
@@ -261,6 +262,51 @@ rcl_take_request(
   rmw_request_id_t * request_header,
   void * ros_request);
 
+/// Take up to `count` ROS requests using a service.
+/**
+ * Behaves like calling rcl_take_request_with_info() until `count` requests
+ * were taken or no request is left, but checks the service and the arrays
+ * once, before taking any request.
+ * The request at index `i` is taken into `ros_requests[i]`, and its header
+ * into `request_headers[i]`, for `i` below `taken_count`.
+ * Taking stops at the first take which fails; `taken_count` then tells how
+ * many requests were taken before it, which the caller still has to answer.
+ *
+ * The middleware interface has no batched take, so each request is still
+ * taken from the middleware separately.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * <i>[1] only if required when filling the requests, avoided for fixed sizes</i>
+ *
+ * \param[in] service the handle to the service from which to take
+ * \param[in] count the maximum number of requests to take
+ * \param[out] request_headers array of `count` request headers
+ * \param[inout] ros_requests array of `count` type-erased ptrs to allocated ROS requests
+ * \param[out] taken_count the number of requests taken
+ * \return `RCL_RET_OK` if at least one request was taken, or if `count` is 0, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SERVICE_INVALID` if the service is invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if memory allocation failed, or
+ * \return `RCL_RET_SERVICE_TAKE_FAILED` if no request was taken, but no error
+ *         occurred in the middleware, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_requests(
+  const rcl_service_t * service,
+  size_t count,
+  rmw_service_info_t * request_headers,
+  void * const * ros_requests,
+  size_t * taken_count);
+
 /// Send a ROS response to a client using a service.
 /**
  * It is the job of the caller to ensure that the type of the `ros_response`
@@ -314,6 +360,47 @@ rcl_send_response(
   rmw_request_id_t * response_header,
   void * ros_response);
 
+/// Send `count` ROS responses to clients using a service.
+/**
+ * Behaves like calling rcl_send_response() on each response in turn, but
+ * checks the service and the arrays once, before sending any response.
+ * The response at index `i` answers the request whose header, as filled by
+ * rcl_take_requests(), is at index `i` of `request_headers`.
+ * The responses are sent in order and sending stops at the first response
+ * which fails to be sent; `sent_count` then tells how many were sent before it.
+ *
+ * The middleware interface has no batched send, so each response is still
+ * handed to the middleware separately.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] for unique pairs of services and responses, see rcl_send_response()</i>
+ *
+ * \param[in] service handle to the service which will make the responses
+ * \param[in] count number of responses to send
+ * \param[inout] request_headers array of `count` headers of the requests answered
+ * \param[in] ros_responses array of `count` type-erased pointers to the ROS responses
+ * \param[out] sent_count number of responses sent (may be NULL)
+ * \return `RCL_RET_OK` if every response was sent successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SERVICE_INVALID` if the service is invalid, or
+ * \return `RCL_RET_ERROR` if a response failed to be sent.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_send_responses(
+  const rcl_service_t * service,
+  size_t count,
+  rmw_service_info_t * request_headers,
+  void * const * ros_responses,
+  size_t * sent_count);
+
 /// Get the topic name for the service.
 /**
  * This function returns the service's internal topic name string.
@@ -421,6 +508,28 @@ RCL_PUBLIC
 bool
 rcl_service_is_valid(const rcl_service_t * service);
 
+/// Get the counters of the requests taken and the responses sent by a service.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] service the service to be queried
+ * \param[out] statistics the counters of the service
+ * \return `RCL_RET_OK` if the counters were retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SERVICE_INVALID` if the service is invalid, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_service_get_statistics(const rcl_service_t * service, rcl_service_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
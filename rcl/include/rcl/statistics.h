@@ -0,0 +1,100 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__STATISTICS_H_
+#define RCL__STATISTICS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/// Counters of the data path of a publisher, see rcl_publisher_get_statistics().
+/**
+ * The counters of every entity are kept by rcl when it is built with the
+ * `RCL_ENABLE_STATISTICS` CMake option, which is on by default.
+ * They are updated with relaxed atomics, so each counter is exact but
+ * counters read together while the entity is in use may not match each other.
+ */
+typedef struct rcl_publisher_statistics_t
+{
+  /// Number of messages published, loaned or not.
+  uint64_t message_count;
+  /// Number of serialized messages published.
+  uint64_t serialized_message_count;
+  /// Number of bytes of the serialized messages published.
+  uint64_t serialized_byte_count;
+  /// Number of messages, serialized or not, which failed to publish.
+  uint64_t publish_failed_count;
+} rcl_publisher_statistics_t;
+
+/// Counters of the data path of a subscription, see rcl_subscription_get_statistics().
+typedef struct rcl_subscription_statistics_t
+{
+  /// Number of messages taken, loaned or not.
+  uint64_t message_count;
+  /// Number of serialized messages taken.
+  uint64_t serialized_message_count;
+  /// Number of bytes of the serialized messages taken.
+  uint64_t serialized_byte_count;
+  /// Number of takes which found no message.
+  uint64_t take_failed_count;
+} rcl_subscription_statistics_t;
+
+/// Counters of the data path of a client, see rcl_client_get_statistics().
+typedef struct rcl_client_statistics_t
+{
+  /// Number of requests sent.
+  uint64_t request_count;
+  /// Number of responses taken.
+  uint64_t response_count;
+  /// Number of takes which found no response.
+  uint64_t take_failed_count;
+} rcl_client_statistics_t;
+
+/// Counters of the data path of a service, see rcl_service_get_statistics().
+typedef struct rcl_service_statistics_t
+{
+  /// Number of requests taken.
+  uint64_t request_count;
+  /// Number of responses sent.
+  uint64_t response_count;
+  /// Number of takes which found no request.
+  uint64_t take_failed_count;
+} rcl_service_statistics_t;
+
+/// Counters of the calls to rcl_wait() on a wait set, see rcl_wait_set_get_statistics().
+typedef struct rcl_wait_set_statistics_t
+{
+  /// Number of calls to rcl_wait() or rcl_wait_ex() on a valid wait set.
+  uint64_t wait_count;
+  /// Number of waits which returned because an entity was ready.
+  uint64_t ready_wakeup_count;
+  /// Number of waits which returned because the timeout expired.
+  uint64_t timeout_wakeup_count;
+  /// Number of waits which failed.
+  uint64_t error_count;
+  /// Total time spent in the waits, in nanoseconds.
+  uint64_t wait_duration_ns;
+  /// Longest time spent in a single wait, in nanoseconds.
+  uint64_t max_wait_duration_ns;
+} rcl_wait_set_statistics_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__STATISTICS_H_
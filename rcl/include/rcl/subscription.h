@@ -24,6 +24,7 @@ extern "C"
 
 #include "rcl/macros.h"
 #include "rcl/node.h"
+#include "rcl/statistics.h"
 #include "rcl/visibility_control.h"
 
 #include "rmw/message_sequence.h"
@@ -31,6 +32,9 @@ extern "C"
 /// Internal rcl implementation struct.
 struct rcl_subscription_impl_t;
 
+/// Number of messages rcl_take_sequence_with_budget() takes between two checks of its budget.
+#define RCL_TAKE_SEQUENCE_BUDGET_BATCH_SIZE 8u
+
 /// Structure which encapsulates a ROS Subscription.
 typedef struct rcl_subscription_t
 {
@@ -270,6 +274,52 @@ rcl_take(
   rmw_subscription_allocation_t * allocation
 );
 
+/// Take one message from each of several subscriptions.
+/**
+ * Behaves like calling rcl_take() on every subscription in turn, but checks
+ * the arrays once and skips the subscriptions which are `NULL`, so that the
+ * subscriptions of a wait set can be passed as they are after rcl_wait().
+ * The message at index `i` is taken from the subscription at index `i`, into
+ * `ros_messages[i]` and, if `message_infos` is not `NULL`, `message_infos[i]`.
+ *
+ * The outcome of each take is stored in `results[i]`, with the return codes of
+ * rcl_take(): `RCL_RET_OK` if a message was taken,
+ * `RCL_RET_SUBSCRIPTION_TAKE_FAILED` if none was or the subscription is
+ * `NULL`, `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * another error code if the take failed.
+ * The first take which fails with an error stops the others and its code is
+ * returned; the results of the entries after it are left untouched.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * <i>[1] only if required when filling the messages, avoided for fixed sizes</i>
+ *
+ * \param[in] subscriptions array of `count` subscriptions, which may be `NULL`
+ * \param[inout] ros_messages array of `count` type-erased ptrs to allocated ROS messages
+ * \param[out] message_infos array of `count` message infos (may be NULL)
+ * \param[in] count number of entries in the arrays
+ * \param[out] results array of `count` return codes, one per take
+ * \param[out] taken_count number of messages taken (may be NULL)
+ * \return `RCL_RET_OK` if every entry was handled, see `results`, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return the code of the first take which failed with an error, see `results`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_many(
+  const rcl_subscription_t * const * subscriptions,
+  void * const * ros_messages,
+  rmw_message_info_t * message_infos,
+  size_t count,
+  rcl_ret_t * results,
+  size_t * taken_count);
+
 /// Take a sequence of messages from a topic using a rcl subscription.
 /**
  * In contrast to `rcl_take`, this function can take multiple messages at
@@ -322,6 +372,57 @@ rcl_take_sequence(
   rmw_subscription_allocation_t * allocation
 );
 
+/// Take a sequence of messages from a topic within a time budget.
+/**
+ * Behaves like rcl_take_sequence(), but takes the messages in batches until
+ * the subscription is drained, `count` messages are taken, or `budget`
+ * nanoseconds have elapsed, so that the backlog of a bursty subscription can
+ * be drained in one call without holding up the caller for too long.
+ * The budget is checked between batches of up to
+ * `RCL_TAKE_SEQUENCE_BUDGET_BATCH_SIZE` messages and the first batch is
+ * always taken, so a budget of `0` takes a single batch.
+ *
+ * The middleware does not tell how many messages are left, so `drained`
+ * reports whether the subscription was found to have nothing more to take.
+ * When it is `false`, the subscription may still hold messages and should be
+ * taken from again.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * <i>[1] only if required when filling the messages, avoided for fixed sizes</i>
+ *
+ * \param[in] subscription the handle to the subscription from which to take.
+ * \param[in] count maximum number of messages to take.
+ * \param[in] budget time in nanoseconds after which no new batch is taken.
+ * \param[inout] message_sequence pointer to a (pre-allocated) message sequence.
+ * \param[inout] message_info_sequence pointer to a (pre-allocated) message info sequence.
+ * \param[out] drained `true` if the subscription had nothing more to take (may be NULL)
+ * \param[in] allocation structure pointer used for memory preallocation (may be NULL)
+ * \return `RCL_RET_OK` if one or more messages was taken, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_SUBSCRIPTION_TAKE_FAILED` if take failed but no error
+ *         occurred in the middleware, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_sequence_with_budget(
+  const rcl_subscription_t * subscription,
+  size_t count,
+  int64_t budget,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  bool * drained,
+  rmw_subscription_allocation_t * allocation);
+
 /// Take a serialized raw message from a topic using a rcl subscription.
 /**
  * In contrast to `rcl_take`, this function stores the taken message in
@@ -435,6 +536,124 @@ rcl_return_loaned_message_from_subscription(
   const rcl_subscription_t * subscription,
   void * loaned_message);
 
+/// Preallocate a pool of messages to take into with rcl_take_into_pool().
+/**
+ * The pool holds `pool_size` messages of `message_size` bytes, each initialized
+ * once with `init_function` and finalized with `fini_function` when the pool
+ * is finalized along with the subscription.
+ * These are the `__init` and `__fini` functions generated for the message
+ * type in C, and `message_size` is `sizeof` the message structure.
+ *
+ * A `pool_size` of `0` sizes the pool by the depth of the actual QoS of the
+ * subscription, i.e. by the number of messages the middleware may keep queued,
+ * which is then required to be non-zero.
+ *
+ * Since the messages are reused rather than finalized after each take, their
+ * sequences and strings keep the capacity they grew to, so a subscription
+ * taking messages of a stable size does not allocate in steady state.
+ *
+ * A subscription has at most one pool.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] subscription the subscription owning the pool
+ * \param[in] message_size the size of one message in bytes
+ * \param[in] init_function the function initializing one message
+ * \param[in] fini_function the function finalizing one message
+ * \param[in] pool_size the number of messages, or `0` for the QoS depth
+ * \return `RCL_RET_OK` if the pool was created successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * \return `RCL_RET_ALREADY_INIT` if the subscription already has a pool, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if a message failed to initialize.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_subscription_init_message_pool(
+  const rcl_subscription_t * subscription,
+  size_t message_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  size_t pool_size);
+
+/// Take a message from a topic into a message borrowed from the subscription pool.
+/**
+ * Behaves like rcl_take(), except that the message is taken into a free
+ * message of the pool created with rcl_subscription_init_message_pool(),
+ * which is then lent to the caller through `ros_message`.
+ * The message must be handed back with rcl_return_message_to_pool() once it is
+ * no longer used, and must not be finalized by the caller.
+ * Messages are lent in the order they are returned.
+ *
+ * If no message is taken, no message of the pool is lent.
+ * The pool is guarded by a mutex, so messages can be taken into it and
+ * returned to it from several threads.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ * <i>[1] only if a message has to grow to fit the taken one</i>
+ *
+ * \param[in] subscription the handle to the subscription from which to take
+ * \param[out] ros_message the borrowed message the message was taken into
+ * \param[out] message_info rmw struct which contains meta-data for the message (may be NULL)
+ * \param[in] allocation structure pointer used for memory preallocation (may be NULL)
+ * \return `RCL_RET_OK` if the message was taken, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the subscription has no message pool, or
+ * \return `RCL_RET_SUBSCRIPTION_MESSAGE_POOL_EXHAUSTED` if every message of the pool
+ *         is borrowed, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_SUBSCRIPTION_TAKE_FAILED` if take failed but no error
+ *         occurred in the middleware, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_into_pool(
+  const rcl_subscription_t * subscription,
+  void ** ros_message,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation);
+
+/// Return a message borrowed with rcl_take_into_pool() to the subscription pool.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] subscription the subscription the message was borrowed from
+ * \param[in] ros_message the borrowed message
+ * \return `RCL_RET_OK` if the message was returned, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if the message is not a borrowed message of the pool, or
+ * \return `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * \return `RCL_RET_NOT_INIT` if the subscription has no message pool.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_return_message_to_pool(
+  const rcl_subscription_t * subscription,
+  void * ros_message);
+
 /// Get the topic name for the subscription.
 /**
  * This function returns the subscription's internal topic name string.
@@ -604,6 +823,36 @@ RCL_PUBLIC
 bool
 rcl_subscription_can_loan_messages(const rcl_subscription_t * subscription);
 
+/// Get the counters of the messages taken by a subscription.
+/**
+ * Every message taken counts once, whether it was taken alone, in a sequence,
+ * into the message pool or as a loan.
+ * Serialized messages are counted apart, along with their size.
+ * Takes which found the subscription empty, including budgeted takes which
+ * drained it, are counted as failed takes.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] subscription the subscription to be queried
+ * \param[out] statistics the counters of the subscription
+ * \return `RCL_RET_OK` if the counters were retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_subscription_get_statistics(
+  const rcl_subscription_t * subscription,
+  rcl_subscription_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -132,7 +132,7 @@ typedef struct rcl_clock_t
 {
   /// Clock type
   enum rcl_clock_type_t type;
-  /// An array of added jump callbacks.
+  /// An array of added jump callbacks, in no particular order.
   rcl_jump_callback_info_t * jump_callbacks;
   /// Number of callbacks in jump_callbacks.
   size_t num_jump_callbacks;
@@ -143,6 +143,10 @@ typedef struct rcl_clock_t
   void * data;
   /// Custom allocator used for internal allocations.
   rcl_allocator_t allocator;
+  /// Private lookup structures for jump_callbacks.
+  struct rcl_jump_callback_index_t * jump_callback_index;
+  /// Private guard condition shared by the timers of this clock, if enabled.
+  struct rcl_guard_condition_t * timer_guard_condition;
 } rcl_clock_t;
 
 /// A single point in time, measured in nanoseconds, the reference point is based on the source.
@@ -279,14 +283,66 @@ rcl_ros_clock_init(
   rcl_clock_t * clock,
   rcl_allocator_t * allocator);
 
+/// Initialize a clock as a `RCL_ROS_TIME` time source attached to another one.
+/**
+ * The clock shares the time source of the `source` clock instead of having its own: enabling,
+ * disabling or setting the ROS time override on any of the attached clocks changes the time of
+ * all of them at once, and calls the jump callbacks added to each of them once.
+ * Each attached clock keeps its own jump callbacks.
+ *
+ * This lets many clocks, e.g. one per node in a context, follow a single source of ROS time
+ * which is updated once per tick.
+ * See `rcl_context_get_ros_clock()` for the source clock of a context.
+ *
+ * The time source stays alive until the last clock attached to it is finalized, so `source`
+ * may be finalized before `clock`.
+ * The addresses of the attached clocks must not change while they are initialized.
+ *
+ * The clocks attached to a time source are kept in a list guarded by a mutex, so clocks can be
+ * attached and finalized while the ROS time override is enabled, disabled or set from another
+ * thread.
+ * The jump callbacks are called with that mutex held, so they must not initialize or finalize
+ * clocks attached to the same time source.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * <i>[1] Concurrent calls on the same `clock` object, or while `source` is being finalized,
+ *        are not safe. Thread-safety is also affected by that of the `allocator` object.</i>
+ *
+ * \param[in] clock the handle to the clock which is being initialized
+ * \param[in] source an initialized `RCL_ROS_TIME` clock whose time source is shared
+ * \param[in] allocator The allocator to use for allocations
+ * \return `RCL_RET_OK` if the time source was successfully initialized, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_ros_clock_init_attached(
+  rcl_clock_t * clock,
+  rcl_clock_t * source,
+  rcl_allocator_t * allocator);
+
 /// Finalize a clock as a `RCL_ROS_TIME` time source.
 /**
  * This will deallocate all necessary internal structures, and clean up any variables.
  * It is specifically setting up a `RCL_ROS_TIME` time source. It is expected
  * to be paired with the init fuction.
+ * The time source is detached from, and deallocated along with the last clock attached to it.
  *
  * This function is not thread-safe with any other function operating on the same
  * clock object.
+ * Detaching from the time source holds its mutex, so other clocks attached to it can be
+ * initialized, finalized or have their ROS time override set concurrently, see
+ * `rcl_ros_clock_init_attached()`.
  *
  * <hr>
  * Attribute          | Adherence
@@ -294,7 +350,7 @@ rcl_ros_clock_init(
  * Allocates Memory   | No
  * Thread-Safe        | No [1]
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | No
  *
  * <i>[1] Function is reentrant, but concurrent calls on the same `clock` object are not safe.
  *        Thread-safety is also affected by that of the `allocator` object associated with the
@@ -495,6 +551,62 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_clock_get_now(rcl_clock_t * clock, rcl_time_point_value_t * time_point_value);
 
+/// Make a clock read a coarse, cheaper version of its time source.
+/**
+ * After this call `rcl_clock_get_now()` on a `RCL_STEADY_TIME` (`RCL_SYSTEM_TIME`) clock
+ * reads `CLOCK_MONOTONIC_COARSE` (`CLOCK_REALTIME_COARSE`), which costs a few nanoseconds
+ * as it only loads the time of the last scheduler tick.
+ * The price is resolution: the time only advances once per tick, typically every 1 to 10
+ * milliseconds, so the clock suits high-rate timestamping, e.g. of log messages, but timers
+ * using it may be called up to a tick late.
+ * The clock keeps its type, and is otherwise used as before.
+ *
+ * This should be called before the clock is used, e.g. by timers, as the time it reports
+ * may go back by up to a tick when switching.
+ * Timers using a coarse clock cannot use kernel wake ups, see
+ * `rcl_timer_enable_kernel_wakeup()`.
+ *
+ * This function is not thread-safe with any other function operating on the same
+ * clock object.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] clock The steady or system clock to make coarse.
+ * \return `RCL_RET_OK` if the clock now reads coarse time, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_UNSUPPORTED` if the clock is of another type, or coarse time is not
+ *   available on this platform.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_clock_enable_coarse_time(rcl_clock_t * clock);
+
+/// Return `true` if the clock reads coarse time, see `rcl_clock_enable_coarse_time()`.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] clock The clock to query.
+ * \return `true` if the clock reads coarse time, or
+ * \return `false` otherwise, or if `clock` is `NULL`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+bool
+rcl_clock_uses_coarse_time(const rcl_clock_t * clock);
+
 
 /// Enable the ROS time abstraction override.
 /**
@@ -503,8 +615,10 @@ rcl_clock_get_now(rcl_clock_t * clock, rcl_time_point_value_t * time_point_value
  * back to system time.
  *
  * This function is not thread-safe with `rcl_clock_add_jump_callback`,
- * nor `rcl_clock_remove_jump_callback` functions when used on the same
- * clock object.
+ * nor `rcl_clock_remove_jump_callback` functions when used on any clock
+ * attached to the same time source.
+ * Clocks can be attached to and finalized from the time source concurrently,
+ * see `rcl_ros_clock_init_attached()`.
  *
  * <hr>
  * Attribute          | Adherence [1]
@@ -512,7 +626,7 @@ rcl_clock_get_now(rcl_clock_t * clock, rcl_time_point_value_t * time_point_value
  * Allocates Memory   | No
  * Thread-Safe        | No [2]
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | No
  *
  * <i>[1] Only applies to the function itself, as jump callbacks may not abide to it.</i>
  * <i>[2] Function is reentrant, but concurrent calls on the same `clock` object are not safe.</i>
@@ -534,8 +648,10 @@ rcl_enable_ros_time_override(rcl_clock_t * clock);
  * value has been set.
  *
  * This function is not thread-safe with `rcl_clock_add_jump_callback`,
- * nor `rcl_clock_remove_jump_callback` functions when used on the same
- * clock object.
+ * nor `rcl_clock_remove_jump_callback` functions when used on any clock
+ * attached to the same time source.
+ * Clocks can be attached to and finalized from the time source concurrently,
+ * see `rcl_ros_clock_init_attached()`.
  *
  * <hr>
  * Attribute          | Adherence [1]
@@ -543,7 +659,7 @@ rcl_enable_ros_time_override(rcl_clock_t * clock);
  * Allocates Memory   | No
  * Thread-Safe        | No [2]
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | No
  *
  * <i>[1] Only applies to the function itself, as jump callbacks may not abide to it.</i>
  * <i>[2] Function is reentrant, but concurrent calls on the same `clock` object are not safe.</i>
@@ -596,10 +712,14 @@ rcl_is_enabled_ros_time_override(
  * time source.
  * If queried and override enabled the time source will return this value,
  * otherwise it will return the system time.
+ * Every clock attached to the same time source sees the new time, and the jump callbacks of
+ * each of them are called.
  *
  * This function is not thread-safe with `rcl_clock_add_jump_callback`,
- * nor `rcl_clock_remove_jump_callback` functions when used on the same
- * clock object.
+ * nor `rcl_clock_remove_jump_callback` functions when used on any clock
+ * attached to the same time source.
+ * Clocks can be attached to and finalized from the time source concurrently,
+ * see `rcl_ros_clock_init_attached()`.
  *
  * <hr>
  * Attribute          | Adherence [1]
@@ -607,7 +727,7 @@ rcl_is_enabled_ros_time_override(
  * Allocates Memory   | No
  * Thread-Safe        | No [2]
  * Uses Atomics       | Yes
- * Lock-Free          | Yes
+ * Lock-Free          | No
  *
  * <i>[1] Only applies to the function itself, as jump callbacks may not abide to it.</i>
  * <i>[2] Function is reentrant, but concurrent calls on the same `clock` object are not safe.</i>
@@ -624,12 +744,116 @@ rcl_ret_t
 rcl_set_ros_time_override(
   rcl_clock_t * clock, rcl_time_point_value_t time_value);
 
+/// Smallest rate accepted by `rcl_ros_clock_set_rate()`.
+#define RCL_ROS_CLOCK_MIN_RATE 1e-3
+/// Largest rate accepted by `rcl_ros_clock_set_rate()`.
+#define RCL_ROS_CLOCK_MAX_RATE 1e3
+
+/// Set the rate at which the overridden time of a `RCL_ROS_TIME` time source is expected to run.
+/**
+ * While the ROS time override is enabled, the time of the clock only changes when it is set
+ * with `rcl_set_ros_time_override()`, e.g. by a `/clock` publisher replaying a log faster
+ * than real time.
+ * The rate tells how many nanoseconds of ROS time are expected to pass per nanosecond of wall
+ * time, so that waiting for a ROS time deadline, e.g. in `rcl_wait()` for a timer, lasts
+ * accordingly less (more) wall time instead of the ROS duration itself.
+ * See `rcl_clock_get_wall_duration()`.
+ *
+ * The rate does not change the time reported by the clock, and is not used while the
+ * override is disabled.
+ * It is shared by every clock attached to the same time source, and is `1.0` by default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Function is reentrant, but concurrent calls on clocks sharing a time source are not
+ *        safe.</i>
+ *
+ * \param[in] clock The clock to update.
+ * \param[in] rate The expected rate, between `RCL_ROS_CLOCK_MIN_RATE` and
+ *   `RCL_ROS_CLOCK_MAX_RATE`.
+ * \return `RCL_RET_OK` if the rate was set successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_ros_clock_set_rate(
+  rcl_clock_t * clock, double rate);
+
+/// Get the rate of a `RCL_ROS_TIME` time source, see `rcl_ros_clock_set_rate()`.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Function is reentrant, but concurrent calls on clocks sharing a time source are not
+ *        safe.</i>
+ *
+ * \param[in] clock The clock to query.
+ * \param[out] rate The rate of the time source.
+ * \return `RCL_RET_OK` if the rate was retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_ros_clock_get_rate(
+  rcl_clock_t * clock, double * rate);
+
+/// Convert a duration measured by a clock into the wall time it is expected to take.
+/**
+ * For a `RCL_ROS_TIME` clock with the override enabled this is the duration divided by the
+ * rate of the clock, saturated to the range of `rcl_duration_value_t`; a duration of
+ * `INT64_MAX`, meaning forever, is kept as is.
+ * For any other clock the duration is returned unchanged.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * <i>[1] Not safe with concurrent calls to `rcl_ros_clock_set_rate()` or the functions
+ *        enabling and disabling the override on clocks sharing the time source.</i>
+ *
+ * \param[in] clock The clock measuring the duration.
+ * \param[in] duration The duration, in the time of the clock.
+ * \param[out] wall_duration The duration in wall time.
+ * \return `RCL_RET_OK` if the duration was converted successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_clock_get_wall_duration(
+  rcl_clock_t * clock, rcl_duration_value_t duration, rcl_duration_value_t * wall_duration);
+
 /// Add a callback to be called when a time jump exceeds a threshold.
 /**
  * The callback is called twice when the threshold is exceeded: once before the clock is
  * updated, and once after.
  * The user_data pointer is passed to the callback as the last argument.
  * A callback and user_data pair must be unique among the callbacks added to a clock.
+ * The order in which callbacks are called is unspecified.
+ *
+ * Callbacks are indexed by their callback and user_data pair and by the magnitude of their
+ * thresholds, so adding a callback takes amortized constant time and a time jump only visits
+ * the callbacks whose thresholds may have been exceeded.
  *
  * This function is not thread-safe with `rcl_clock_remove_jump_callback`,
  * `rcl_enable_ros_time_override`, `rcl_disable_ros_time_override` nor
@@ -665,6 +889,10 @@ rcl_clock_add_jump_callback(
 
 /// Remove a previously added time jump callback.
 /**
+ * The callback is found by its callback and user_data pair in constant time.
+ * This function does not allocate nor free memory, the storage is kept for
+ * callbacks added later and released when the clock is finalized.
+ *
  * This function is not thread-safe with `rcl_clock_add_jump_callback`
  * `rcl_enable_ros_time_override`, `rcl_disable_ros_time_override` nor
  * `rcl_set_ros_time_override` functions when used on the same clock object.
@@ -672,7 +900,7 @@ rcl_clock_add_jump_callback(
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | Yes
+ * Allocates Memory   | No
  * Thread-Safe        | No [1]
  * Uses Atomics       | No
  * Lock-Free          | Yes
@@ -684,8 +912,7 @@ rcl_clock_add_jump_callback(
  * \param[in] clock The clock to remove a jump callback from.
  * \param[in] callback The callback to call.
  * \param[in] user_data A pointer to be passed to the callback.
- * \return `RCL_RET_OK` if the callback was added successfully, or
- * \return `RCL_RET_BAD_ALLOC` if a memory allocation failed, or
+ * \return `RCL_RET_OK` if the callback was removed successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
  * \return `RCL_RET_ERROR` the callback was not found or an unspecified error occurs.
  */
@@ -55,6 +55,17 @@ typedef struct rcl_timer_t
  */
 typedef void (* rcl_timer_callback_t)(rcl_timer_t *, int64_t);
 
+/// A timer called by rcl_timer_call_ready_batch(), with what is needed to invoke its callback.
+typedef struct rcl_timer_batch_call_t
+{
+  /// The timer which was called.
+  rcl_timer_t * timer;
+  /// The callback of the timer at the time it was called, may be `NULL`.
+  rcl_timer_callback_t callback;
+  /// The time since the previous call of the timer, in nanoseconds.
+  int64_t time_since_last_call;
+} rcl_timer_batch_call_t;
+
 /// Return a zero initialized timer.
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -233,6 +244,55 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_call(rcl_timer_t * timer);
 
+/// Call all the ready timers of an array, without invoking their callbacks.
+/**
+ * This function is meant for dispatching many timers which became ready in
+ * the same spin, e.g. the non-`NULL` entries of `rcl_wait_set_t::timers`
+ * after rcl_wait().
+ * `NULL` entries in the array are skipped.
+ *
+ * The clock of each distinct clock among the timers is read once, and every
+ * timer which is ready at that time and not canceled is called like
+ * rcl_timer_call() would: its last call time is set to that time and its next
+ * call time is advanced by its period.
+ * Timers which are not ready are left untouched.
+ *
+ * Unlike rcl_timer_call(), the callbacks are not invoked.
+ * Instead, for each timer called, an entry is appended to `calls`, in the
+ * order of the timers in the array, and the number of entries is stored in
+ * `call_count`.
+ * It is up to the caller to invoke the non-`NULL` callbacks with the timer and
+ * the time since its last call given in each entry.
+ *
+ * The `calls` array must have room for at least `timer_count` entries.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timers the timers to call if ready, may contain `NULL` entries
+ * \param[in] timer_count the number of entries in `timers`
+ * \param[out] calls the timers which were called, with their callbacks
+ * \param[out] call_count the number of entries stored in `calls`
+ * \return `RCL_RET_OK` if the ready timers were called successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_TIMER_INVALID` if any timer is invalid, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_call_ready_batch(
+  const rcl_timer_t * const * timers,
+  size_t timer_count,
+  rcl_timer_batch_call_t * calls,
+  size_t * call_count);
+
 /// Retrieve the clock of the timer.
 /**
  * This function retrieves the clock pointer and copies it into the given variable.
@@ -289,6 +349,41 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_is_ready(const rcl_timer_t * timer, bool * is_ready);
 
+/// Calculates whether or not the timer should be called at the given time.
+/**
+ * Same as rcl_timer_is_ready(), except that the given time is used instead of
+ * reading the timer's clock.
+ * This lets the caller read a clock once and check all the timers using that
+ * clock against the same instant.
+ *
+ * The `now` argument must be a time point of the clock the timer was
+ * initialized with, see rcl_timer_clock().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer which is being checked
+ * \param[in] now the current time of the timer's clock
+ * \param[out] is_ready the bool used to store the result of the calculation
+ * \return `RCL_RET_OK` if the readiness was calculated successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_TIMER_INVALID` if the timer is invalid, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_is_ready_at(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  bool * is_ready);
+
 /// Calculate and retrieve the time until the next call in nanoseconds.
 /**
  * This function calculates the time until the next call by adding the timer's
@@ -324,6 +419,70 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_timer_get_time_until_next_call(const rcl_timer_t * timer, int64_t * time_until_next_call);
 
+/// Calculate the time until the next call from the given time, in nanoseconds.
+/**
+ * Same as rcl_timer_get_time_until_next_call(), except that the given time is
+ * used instead of reading the timer's clock.
+ *
+ * The `now` argument must be a time point of the clock the timer was
+ * initialized with, see rcl_timer_clock().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer that is being queried
+ * \param[in] now the current time of the timer's clock
+ * \param[out] time_until_next_call the output variable for the result
+ * \return `RCL_RET_OK` if the timer until next call was successfully calculated, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_TIMER_INVALID` if the timer is invalid, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_time_until_next_call_at(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  int64_t * time_until_next_call);
+
+/// Retrieve the time point at which the timer is next due, in nanoseconds.
+/**
+ * The time point is expressed in the time of the clock the timer was
+ * initialized with, so it can only be compared with other time points from
+ * the same clock.
+ * Unlike rcl_timer_get_time_until_next_call(), this function does not read
+ * the clock.
+ *
+ * The `next_call_time` argument must point to an allocated int64_t, as the
+ * time point is copied into that instance.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_int_least64_t`</i>
+ *
+ * \param[in] timer the handle to the timer that is being queried
+ * \param[out] next_call_time the output variable for the result
+ * \return `RCL_RET_OK` if the next call time was successfully retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_TIMER_INVALID` if the timer is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_get_next_call_time(const rcl_timer_t * timer, int64_t * next_call_time);
+
 /// Retrieve the time since the previous call to rcl_timer_call() occurred.
 /**
  * This function calculates the time since the last call and copies it into
@@ -587,6 +746,126 @@ RCL_WARN_UNUSED
 rcl_guard_condition_t *
 rcl_timer_get_guard_condition(const rcl_timer_t * timer);
 
+/// Make the timer wake wait sets at its deadlines with a kernel timer.
+/**
+ * By default, rcl_wait() derives its timeout from the deadlines of the timers
+ * in the wait set, so how precisely a timer wakes the wait set depends on the
+ * wait primitive of the rmw implementation.
+ * Once this is enabled, the timer instead arms a kernel timer (a `timerfd` on
+ * Linux) at each of its deadlines and triggers its guard condition when the
+ * kernel timer expires.
+ * rcl_wait() then no longer computes a timeout for this timer and is woken up
+ * by the guard condition instead.
+ *
+ * This is only supported for timers using a `RCL_STEADY_TIME` clock which does
+ * not read coarse time, see rcl_clock_enable_coarse_time(), and only on Linux.
+ * One thread, blocking on the kernel timer, is started per timer and stopped
+ * when the timer is finalized.
+ * Enabling it on a timer which already has it enabled does nothing.
+ *
+ * This should be called before the timer is added to a wait set.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[inout] timer the timer to use a kernel timer for
+ * \return `RCL_RET_OK` if the timer now uses a kernel timer, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_TIMER_INVALID` if the timer is invalid, or
+ * \return `RCL_RET_UNSUPPORTED` if the clock or the platform is not supported, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_timer_enable_kernel_wakeup(rcl_timer_t * timer);
+
+/// Check whether the timer wakes wait sets with a kernel timer.
+/**
+ * See rcl_timer_enable_kernel_wakeup().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] timer the timer to be queried
+ * \return `true` if the timer is valid and uses a kernel timer, otherwise `false`
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+bool
+rcl_timer_uses_kernel_wakeup(const rcl_timer_t * timer);
+
+/// Make the timers created on the clock from now on share one guard condition.
+/**
+ * By default every timer owns a guard condition, which is triggered when the
+ * timer is reset or, for `RCL_ROS_TIME` clocks, when time jumps, and which
+ * rcl_wait() passes to the rmw implementation along with the other guard
+ * conditions of the wait set.
+ * Once this is enabled, the timers initialized on this clock afterwards
+ * trigger a single guard condition owned by the clock instead, and rcl_wait()
+ * passes it to the rmw implementation only once however many of these timers
+ * are in the wait set.
+ * Being woken up by it, rcl_wait() re-evaluates every timer of the wait set.
+ * Timers initialized before this call keep their own guard condition.
+ *
+ * As for any guard condition, see rcl_wait(), the timers sharing it should
+ * not be waited on in more than one wait set at a time.
+ * Every timer of the clock must be initialized with the context given here.
+ * The guard condition is finalized along with the clock, so the clock must
+ * outlive its timers, as it already has to.
+ * Enabling it on a clock which already has it enabled does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] clock the clock whose timers should share a guard condition
+ * \param[in] context the context of the clock's timers
+ * \return `RCL_RET_OK` if the clock's timers now share a guard condition, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_clock_enable_shared_timer_guard_condition(rcl_clock_t * clock, rcl_context_t * context);
+
+/// Check whether the timer uses the guard condition shared by the timers of its clock.
+/**
+ * See rcl_clock_enable_shared_timer_guard_condition().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] timer the timer to be queried
+ * \return `true` if the timer is valid and uses a shared guard condition, otherwise `false`
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+bool
+rcl_timer_uses_shared_guard_condition(const rcl_timer_t * timer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,8 @@
 #ifndef RCL__TYPES_H_
 #define RCL__TYPES_H_
 
+#include <stdbool.h>
+
 #include <rmw/types.h>
 
 typedef rmw_ret_t rcl_ret_t;
@@ -58,18 +60,26 @@ typedef rmw_ret_t rcl_ret_t;
 // rcl publisher specific ret codes in 3XX
 /// Invalid rcl_publisher_t given return code.
 #define RCL_RET_PUBLISHER_INVALID 300
+/// Every message of the publisher message pool is loaned return code.
+#define RCL_RET_PUBLISHER_MESSAGE_POOL_EXHAUSTED 301
 
 // rcl subscription specific ret codes in 4XX
 /// Invalid rcl_subscription_t given return code.
 #define RCL_RET_SUBSCRIPTION_INVALID 400
 /// Failed to take a message from the subscription return code.
 #define RCL_RET_SUBSCRIPTION_TAKE_FAILED 401
+/// Every message of the subscription message pool is borrowed return code.
+#define RCL_RET_SUBSCRIPTION_MESSAGE_POOL_EXHAUSTED 402
 
 // rcl service client specific ret codes in 5XX
 /// Invalid rcl_client_t given return code.
 #define RCL_RET_CLIENT_INVALID 500
 /// Failed to take a response from the client return code.
 #define RCL_RET_CLIENT_TAKE_FAILED 501
+/// Too many requests of the client are in flight return code.
+#define RCL_RET_CLIENT_REQUEST_WINDOW_FULL 502
+/// Request was sent but could not be tracked by the request window return code.
+#define RCL_RET_CLIENT_REQUEST_NOT_TRACKED 503
 
 // rcl service server specific ret codes in 6XX
 /// Invalid rcl_service_t given return code.
@@ -120,4 +130,10 @@ typedef rmw_ret_t rcl_ret_t;
 /// typedef for rmw_serialized_message_t;
 typedef rmw_serialized_message_t rcl_serialized_message_t;
 
+/// Signature of a function initializing a ROS message in place, e.g. `pkg__msg__Type__init`.
+typedef bool (* rcl_message_init_function_t)(void * ros_message);
+
+/// Signature of a function finalizing a ROS message in place, e.g. `pkg__msg__Type__fini`.
+typedef void (* rcl_message_fini_function_t)(void * ros_message);
+
 #endif  // RCL__TYPES_H_
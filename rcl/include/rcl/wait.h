@@ -27,6 +27,7 @@ extern "C"
 #include "rcl/guard_condition.h"
 #include "rcl/macros.h"
 #include "rcl/service.h"
+#include "rcl/statistics.h"
 #include "rcl/subscription.h"
 #include "rcl/timer.h"
 #include "rcl/event.h"
@@ -66,6 +67,102 @@ typedef struct rcl_wait_set_t
   struct rcl_wait_set_impl_t * impl;
 } rcl_wait_set_t;
 
+/// Kinds of entities which can be stored in a wait set.
+typedef enum rcl_wait_set_entity_type_t
+{
+  /// Subscription, stored in rcl_wait_set_t::subscriptions.
+  RCL_WAIT_SET_SUBSCRIPTION,
+  /// Guard condition, stored in rcl_wait_set_t::guard_conditions.
+  RCL_WAIT_SET_GUARD_CONDITION,
+  /// Timer, stored in rcl_wait_set_t::timers.
+  RCL_WAIT_SET_TIMER,
+  /// Client, stored in rcl_wait_set_t::clients.
+  RCL_WAIT_SET_CLIENT,
+  /// Service, stored in rcl_wait_set_t::services.
+  RCL_WAIT_SET_SERVICE,
+  /// Event, stored in rcl_wait_set_t::events.
+  RCL_WAIT_SET_EVENT
+} rcl_wait_set_entity_type_t;
+
+/// Number of kinds of entities in rcl_wait_set_entity_type_t.
+#define RCL_WAIT_SET_ENTITY_TYPE_COUNT 6
+
+/// An entity in a wait set which was found ready by rcl_wait_ex().
+typedef struct rcl_wait_set_ready_entity_t
+{
+  /// Kind of the ready entity.
+  rcl_wait_set_entity_type_t type;
+  /// Index of the ready entity in the wait set array of its kind.
+  size_t index;
+  /// Whether the entity is a client with a request in flight which timed out.
+  /**
+   * Such a client is ready even if no response arrived, and its expired
+   * requests are swept with rcl_client_sweep_expired_requests().
+   */
+  bool client_timed_out;
+} rcl_wait_set_ready_entity_t;
+
+/// Number of bits of a value below its leading bit which select a histogram sub-bucket.
+#define RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS 3
+/// Exponent of the smallest power of two counted only in the last bucket of a histogram.
+/**
+ * Values from 2^`RCL_WAIT_SET_HISTOGRAM_MAX_EXPONENT` on are all counted in the last bucket,
+ * which also holds the top sub-bucket of the exponent below it.
+ */
+#define RCL_WAIT_SET_HISTOGRAM_MAX_EXPONENT 42
+/// Number of buckets of a histogram, see rcl_wait_set_histogram_t.
+#define RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT \
+  ((RCL_WAIT_SET_HISTOGRAM_MAX_EXPONENT - RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS + 1) * \
+  (1 << RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS))
+
+/// Histogram of durations in nanoseconds with a bounded relative error.
+/**
+ * Values below 8 have a bucket each.
+ * Larger values are bucketed by their leading bit and the 3 bits after it,
+ * so every bucket spans at most 1/8 of its lower bound, up to 2^42 ns (about
+ * 73 minutes); longer durations are all counted in the last bucket.
+ * Use rcl_wait_set_histogram_bucket_lower_bound() to get the range of a
+ * bucket, and rcl_wait_set_histogram_percentile() to summarize a histogram.
+ */
+typedef struct rcl_wait_set_histogram_t
+{
+  /// Number of values counted in each bucket.
+  uint64_t counts[RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT];
+} rcl_wait_set_histogram_t;
+
+/// Why and how long rcl_wait() waited on a wait set, see rcl_wait_set_set_profiling().
+typedef struct rcl_wait_set_profile_t
+{
+  /// Number of waits which found entities of each kind ready, by rcl_wait_set_entity_type_t.
+  /**
+   * A wait which finds entities of several kinds ready counts for each of them.
+   */
+  uint64_t ready_counts[RCL_WAIT_SET_ENTITY_TYPE_COUNT];
+  /// Number of waits which returned `RCL_RET_TIMEOUT`.
+  uint64_t timeout_count;
+  /// Number of waits which returned before the timeout with no entity ready.
+  /**
+   * This happens, for instance, when rmw_wait() is woken up for a timer
+   * which turns out not to be due yet.
+   */
+  uint64_t spurious_count;
+  /// Time spent blocked in rmw_wait(), excluding the time spent polling within the spin budget.
+  rcl_wait_set_histogram_t blocked;
+  /// Time by which rmw_wait() overran the requested timeout, for the waits which timed out.
+  rcl_wait_set_histogram_t overshoot;
+} rcl_wait_set_profile_t;
+
+/// What rcl_wait() does between two polls while spinning, see rcl_wait_set_set_spin_budget().
+typedef enum rcl_wait_set_spin_relax_t
+{
+  /// Poll again right away.
+  RCL_WAIT_SET_SPIN_RELAX_NONE,
+  /// Issue a spin loop hint to the CPU, e.g. `pause` on x86, where it is available.
+  RCL_WAIT_SET_SPIN_RELAX_PAUSE,
+  /// Yield the processor to another thread.
+  RCL_WAIT_SET_SPIN_RELAX_YIELD
+} rcl_wait_set_spin_relax_t;
+
 /// Return a rcl_wait_set_t struct with members set to `NULL`.
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -260,20 +357,22 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set);
 
 /// Reallocate space for entities in the wait set.
 /**
- * This function will deallocate and reallocate the memory for all entity sets.
- *
- * A size of 0 will just deallocate the memory and assign `NULL` to the array.
+ * The wait set keeps a capacity for every entity set, separate from its size.
+ * Only a size which exceeds the capacity reallocates the set, and then the
+ * capacity grows to at least double its previous value.
+ * Any other size, including 0, reuses the memory already allocated, so
+ * resizing back and forth as entities come and go does not allocate once the
+ * wait set has seen its largest size.
+ * Use rcl_wait_set_shrink_to_fit() to give back the unused capacity.
  *
  * Allocation and deallocation is done with the allocator given during the
  * wait set's initialization.
  *
  * After calling this function all values in the set will be set to `NULL`,
  * effectively the same as calling rcl_wait_set_clear().
- * Similarly, the underlying rmw representation is reallocated and reset:
+ * Similarly, the underlying rmw representation is resized and reset:
  * all entries are set to `NULL` and the count is set to zero.
  *
- * If the requested size matches the current size, no allocation will be done.
- *
  * This can be called on an uninitialized (zero initialized) wait set.
  *
  * <hr>
@@ -308,6 +407,34 @@ rcl_wait_set_resize(
   size_t services_size,
   size_t events_size);
 
+/// Give back the memory which the wait set holds beyond its current size.
+/**
+ * Every entity set, and the storage which comes with it, is reallocated to
+ * fit its current size exactly, or deallocated if that is 0.
+ * The storage of a persistent wait set is shrunk the same way, and the
+ * storage kept for persistence by a non persistent wait set is deallocated.
+ * The entities in the wait set are left untouched.
+ *
+ * Growing the wait set again afterwards allocates, see rcl_wait_set_resize().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to be shrunk
+ * \return `RCL_RET_OK` if the wait set was shrunk successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_shrink_to_fit(rcl_wait_set_t * wait_set);
+
 /// Store a pointer to the guard condition in the next empty spot in the set.
 /**
  * This function behaves exactly the same as for subscriptions.
@@ -386,6 +513,18 @@ rcl_wait_set_add_event(
  * perhaps that the state of the subscriptions has changed, in which case
  * rcl_take may succeed but return with taken == false.
  * For guard conditions this means the guard condition was triggered.
+ * For clients this means there may be responses that can be taken, including
+ * ones kept in the request window by rcl_client_take_response_for(), or that
+ * requests in flight expired and can be swept with
+ * rcl_client_sweep_expired_requests().
+ *
+ * The timeout is shortened so that this function returns when the next timer
+ * is due or the next request of a client expires, see
+ * rcl_client_set_default_request_timeout().
+ *
+ * If the wait set was made persistent with rcl_wait_set_persist(), the items
+ * are always left untouched and their readiness must be checked with
+ * rcl_wait_set_is_ready() instead.
  *
  * Expected usage:
  *
@@ -470,6 +609,445 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout);
 
+/// Block until the wait set is ready, also listing the ready entities compactly.
+/**
+ * This function behaves exactly the same as rcl_wait(), but in addition it
+ * fills `ready_entities` with the kind and index of every entity which was
+ * found ready, so that callers can dispatch them without scanning all the
+ * arrays in the wait set.
+ * Entities are grouped by kind, timers first, and sorted by index within
+ * each kind.
+ * A client is flagged with rcl_wait_set_ready_entity_t::client_timed_out
+ * when one of its requests expired, see rcl_client_set_request_timeout(), so
+ * that callers know to sweep it without trying to take a response first.
+ *
+ * The `ready_entities` array must have room for every entity that fits in the
+ * wait set, i.e. `capacity` must be at least the sum of all its sizes.
+ * On return `ready_count` holds the number of valid entries in the array,
+ * which is zero if nothing was ready.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the set of things to be waited on and to be pruned if not ready
+ * \param[in] timeout the duration to wait for the wait set to be ready, in nanoseconds
+ * \param[out] ready_entities storage for the list of ready entities
+ * \param[in] capacity the number of elements which fit in `ready_entities`
+ * \param[out] ready_count the number of ready entities stored in `ready_entities`
+ * \return `RCL_RET_OK` something in the wait set became ready, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized, or
+ * \return `RCL_RET_WAIT_SET_EMPTY` if the wait set contains no items, or
+ * \return `RCL_RET_TIMEOUT` if the timeout expired before something was ready, or
+ * \return `RCL_RET_ERROR` an unspecified error occur.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_ex(
+  rcl_wait_set_t * wait_set,
+  int64_t timeout,
+  rcl_wait_set_ready_entity_t * ready_entities,
+  size_t capacity,
+  size_t * ready_count);
+
+/// Make the entities currently stored in the wait set persist across rcl_wait() calls.
+/**
+ * By default the contents of a wait set are consumed by rcl_wait(), which sets
+ * the entities that are not ready to `NULL`, so the wait set has to be cleared
+ * and filled again before every call.
+ * After calling this function the wait set takes a snapshot of the entities
+ * added so far and of their rmw representation, and every following call to
+ * rcl_wait() restores that snapshot instead of requiring a rebuild.
+ *
+ * While the wait set is persistent, rcl_wait() leaves the entity arrays in the
+ * wait set untouched and readiness is reported through rcl_wait_set_is_ready().
+ *
+ * Calling rcl_wait_set_clear() or rcl_wait_set_resize() on a persistent wait
+ * set discards the snapshot and returns it to the default mode, as does adding
+ * a new entity to it; this function can then be called again once all the
+ * entities are in place.
+ * Calling this function on a wait set which is already persistent does nothing.
+ * A wait set which rcl_wait() already pruned in the default mode has lost the
+ * entities which were not ready, so it has to be cleared and filled again
+ * before it can be made persistent.
+ *
+ * The entities in a persistent wait set must stay valid until the wait set is
+ * cleared, resized or finalized.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to be made persistent
+ * \return `RCL_RET_OK` if the wait set is now persistent, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized or was
+ *   pruned by rcl_wait(), or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_persist(rcl_wait_set_t * wait_set);
+
+/// Return `true` if the wait set is valid and persistent, else `false`.
+/**
+ * \see rcl_wait_set_persist
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be checked
+ * \return `true` if the wait set is persistent, otherwise `false`.
+ */
+RCL_PUBLIC
+bool
+rcl_wait_set_is_persistent(const rcl_wait_set_t * wait_set);
+
+/// Enable or disable edge triggered readiness on the wait set.
+/**
+ * By default rcl_wait() is level triggered: an entity with something to take
+ * is reported ready on every call until it has been drained.
+ * While edge triggered, a subscription, client, service or event which was
+ * reported ready is left out of later calls to rcl_wait(), and so is never
+ * reported again, until a take on it fails, i.e. until rcl_take() or one of
+ * its variants returns `RCL_RET_SUBSCRIPTION_TAKE_FAILED`, or
+ * rcl_take_response(), rcl_take_request() or rcl_take_event() return their
+ * equivalent.
+ * The caller is then expected to take from every ready entity until it is
+ * drained, as with `EPOLLET`; an entity which is not drained is never
+ * reported again.
+ * Guard conditions and timers are not affected, they are level triggered as
+ * usual.
+ *
+ * While every entity is left out, rcl_wait() only wakes up for the guard
+ * conditions, the timers or the timeout, so the wait set should hold a guard
+ * condition if it is waited on without a timeout.
+ *
+ * Edge triggering requires a persistent wait set, so the wait set is made
+ * persistent, see rcl_wait_set_persist(), if it is not already.
+ * Anything which returns the wait set to the default mode, such as clearing,
+ * resizing or adding to it, also disables edge triggering and re-arms every
+ * entity.
+ * Disabling edge triggering keeps the wait set persistent.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to be configured
+ * \param[in] edge_triggered `true` to enable edge triggering, `false` to disable it
+ * \return `RCL_RET_OK` if the mode was set successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_edge_triggered(rcl_wait_set_t * wait_set, bool edge_triggered);
+
+/// Return `true` if the wait set is valid and edge triggered, else `false`.
+/**
+ * \see rcl_wait_set_set_edge_triggered
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be checked
+ * \return `true` if the wait set is edge triggered, otherwise `false`.
+ */
+RCL_PUBLIC
+bool
+rcl_wait_set_is_edge_triggered(const rcl_wait_set_t * wait_set);
+
+/// Make rcl_wait() poll for a while before blocking.
+/**
+ * Waking up a thread blocked in rmw_wait() goes through the operating system
+ * and can take tens of microseconds.
+ * With a spin budget, rcl_wait() first polls the wait set, i.e. waits with a
+ * timeout of zero, until something is ready or the budget is spent, and only
+ * then blocks for what is left of the timeout.
+ * This trades CPU time for latency when data is expected shortly; a thread
+ * spinning on a wait set keeps its core busy for up to the budget on every
+ * call to rcl_wait().
+ *
+ * Between two polls, rcl_wait() relaxes as given by `relax`.
+ * The budget never extends the timeout passed to rcl_wait(), nor the time
+ * until the next timer is due, and is not used for non-blocking calls.
+ *
+ * Polling requires the rmw storage to be rebuilt before each poll, so it is
+ * only done while the wait set is persistent, see rcl_wait_set_persist();
+ * otherwise rcl_wait() blocks right away.
+ * Unlike persistence, the budget is kept when the wait set is cleared or
+ * resized.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to be configured
+ * \param[in] spin_budget the time to spend polling in nanoseconds, or 0 to always block
+ * \param[in] relax what to do between two polls
+ * \return `RCL_RET_OK` if the budget was set successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_spin_budget(
+  rcl_wait_set_t * wait_set,
+  int64_t spin_budget,
+  rcl_wait_set_spin_relax_t relax);
+
+/// Get the spin budget of the wait set in nanoseconds, 0 if it always blocks.
+/**
+ * \see rcl_wait_set_set_spin_budget
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[out] spin_budget the spin budget in nanoseconds
+ * \return `RCL_RET_OK` if the budget was retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_spin_budget(const rcl_wait_set_t * wait_set, int64_t * spin_budget);
+
+/// Get the counters of the calls to rcl_wait() on the wait set.
+/**
+ * Each call to rcl_wait() or rcl_wait_ex() on the valid wait set is counted
+ * by the reason it returned for, and its duration is measured with the steady
+ * clock, including the time spent polling within the spin budget.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[out] statistics the counters of the wait set
+ * \return `RCL_RET_OK` if the counters were retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_statistics(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_statistics_t * statistics);
+
+/// Enable or disable profiling the calls to rcl_wait() on the wait set.
+/**
+ * While profiling is enabled, each call to rcl_wait() or rcl_wait_ex() which
+ * does not fail records what woke it up, by kind of ready entity, and the time
+ * spent blocked in rmw_wait() and by how much it overran the timeout, in
+ * histograms, see rcl_wait_set_profile_t.
+ * This costs two reads of the steady clock per blocking wait, which is why it
+ * is opt-in.
+ *
+ * Enabling allocates the profile with the allocator of the wait set, and
+ * zeroes it; disabling frees it.
+ * Enabling a profiled wait set or disabling one which is not profiled does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set to be profiled
+ * \param[in] enabled `true` to enable profiling, `false` to disable it
+ * \return `RCL_RET_OK` if profiling was enabled or disabled successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_set_profiling(rcl_wait_set_t * wait_set, bool enabled);
+
+/// Get a snapshot of the profile of the wait set.
+/**
+ * The profile may be read while another thread waits on the wait set; each
+ * count is then exact, but counts read together may not match each other.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[out] profile the profile of the wait set
+ * \return `RCL_RET_OK` if the profile was retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized, or
+ * \return `RCL_RET_NOT_INIT` if profiling is not enabled, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_get_profile(const rcl_wait_set_t * wait_set, rcl_wait_set_profile_t * profile);
+
+/// Zero the profile of the wait set.
+/**
+ * A wait which completes while the profile is being reset may be partly counted.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wait_set the wait set whose profile is to be reset
+ * \return `RCL_RET_OK` if the profile was reset successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized, or
+ * \return `RCL_RET_NOT_INIT` if profiling is not enabled, or
+ * \return `RCL_RET_UNSUPPORTED` if rcl was built without `RCL_ENABLE_STATISTICS`.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_reset_profile(rcl_wait_set_t * wait_set);
+
+/// Get the smallest value counted in a bucket of a histogram, in nanoseconds.
+/**
+ * The values counted in a bucket range from its lower bound to the lower
+ * bound of the next bucket, excluded.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] bucket index of the bucket, below `RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT`
+ * \return the lower bound of the bucket, or `UINT64_MAX` if `bucket` is out of range.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+uint64_t
+rcl_wait_set_histogram_bucket_lower_bound(size_t bucket);
+
+/// Estimate a percentile of the values counted in a histogram, in nanoseconds.
+/**
+ * The estimate is the upper bound of the bucket which holds the percentile,
+ * so it is at most 1/8 above the exact value, unless the percentile falls in
+ * the last bucket, whose lower bound is returned.
+ * The percentile of an empty histogram is 0.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] histogram the histogram to be summarized
+ * \param[in] percentile the percentile, between 0 and 100
+ * \param[out] value the estimated percentile
+ * \return `RCL_RET_OK` if the percentile was estimated successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_histogram_percentile(
+  const rcl_wait_set_histogram_t * histogram,
+  double percentile,
+  uint64_t * value);
+
+/// Check if an entity in the wait set was ready after the last call to rcl_wait().
+/**
+ * For a persistent wait set this reports the readiness recorded by the last
+ * call to rcl_wait(), see rcl_wait_set_persist().
+ * For any other wait set this is equivalent to checking whether the entry at
+ * `index` in the corresponding array of the wait set is not `NULL`.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] wait_set the wait set to be queried
+ * \param[in] type the kind of entity to be queried
+ * \param[in] index the index of the entity, as returned by rcl_wait_set_add_*()
+ * \param[out] is_ready `true` if the entity was ready, `false` otherwise
+ * \return `RCL_RET_OK` if readiness was retrieved successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the wait set is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_is_ready(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t type,
+  size_t index,
+  bool * is_ready);
+
 /// Return `true` if the wait set is valid, else `false`.
 /**
  * A wait set is invalid if:
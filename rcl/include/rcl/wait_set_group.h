@@ -0,0 +1,318 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__WAIT_SET_GROUP_H_
+#define RCL__WAIT_SET_GROUP_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/context.h"
+#include "rcl/macros.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcl/wait.h"
+
+struct rcl_wait_set_group_impl_t;
+
+/// Entities spread over one wait set per worker thread, sharing their ready entities.
+/**
+ * A wait set can only be waited on by one thread at a time, so a multi-threaded executor
+ * using a single wait set serializes all of its threads on rcl_wait().
+ * A wait set group instead spreads its entities over several shards, each with its own
+ * wait set, so that each worker thread can wait on its own shard.
+ * The entities found ready by a shard are put in a queue of that shard, from which its
+ * worker takes them, and from which idle workers steal them once their own queue is empty.
+ */
+typedef struct rcl_wait_set_group_t
+{
+  /// Number of shards, one per worker thread.
+  size_t shard_count;
+  /// Implementation specific storage.
+  struct rcl_wait_set_group_impl_t * impl;
+} rcl_wait_set_group_t;
+
+/// A ready entity of a wait set group, to be taken from or called by a worker.
+typedef struct rcl_wait_set_group_work_t
+{
+  /// Kind of the ready entity.
+  rcl_wait_set_entity_type_t type;
+  /// The ready entity, e.g. a `const rcl_subscription_t *` for `RCL_WAIT_SET_SUBSCRIPTION`.
+  const void * entity;
+  /// The shard which found the entity ready.
+  size_t shard;
+  /// Index of the entity in the group, for rcl_wait_set_group_work_done().
+  size_t entry;
+} rcl_wait_set_group_work_t;
+
+/// Return a rcl_wait_set_group_t struct with members set to `0` or `NULL`.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_wait_set_group_t
+rcl_get_zero_initialized_wait_set_group(void);
+
+/// Initialize a wait set group with the given number of shards.
+/**
+ * Each shard gets an empty wait set and a guard condition, used to interrupt the waits on
+ * it, see rcl_wait_set_group_interrupt().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] group the wait set group struct to be initialized
+ * \param[in] shard_count number of shards, usually the number of worker threads
+ * \param[in] context the context with which to associate the wait sets
+ * \param[in] allocator the allocator to use when allocating space in the group
+ * \return `RCL_RET_OK` if the group is initialized successfully, or
+ * \return `RCL_RET_ALREADY_INIT` if the group is not zero initialized, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_NOT_INIT` if the given context is invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_init(
+  rcl_wait_set_group_t * group,
+  size_t shard_count,
+  rcl_context_t * context,
+  rcl_allocator_t allocator);
+
+/// Finalize a wait set group.
+/**
+ * Calling this function on a zero initialized group does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] group the wait set group struct to be finalized
+ * \return `RCL_RET_OK` if the group was finalized successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_fini(rcl_wait_set_group_t * group);
+
+/// Add an entity to the shard of the group which has the fewest entities.
+/**
+ * The entity must stay valid until it is removed or the group is finalized.
+ * An entity can only be added once to a group, and must not be in any other wait set.
+ *
+ * Adding and removing entities must not happen concurrently with any other function
+ * operating on the group: the caller is expected to use rcl_wait_set_group_interrupt() to
+ * get the workers to a point where it can synchronize with them, and to do so only once all
+ * the work taken from the group is done.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] group the group to add the entity to
+ * \param[in] type the kind of the entity
+ * \param[in] entity the entity, e.g. a `const rcl_subscription_t *`
+ * \param[out] shard optional, the shard the entity was added to
+ * \return `RCL_RET_OK` if the entity was added successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the group is zero initialized, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_add(
+  rcl_wait_set_group_t * group,
+  rcl_wait_set_entity_type_t type,
+  const void * entity,
+  size_t * shard);
+
+/// Remove an entity from the group.
+/**
+ * The same restrictions as for rcl_wait_set_group_add() apply.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] group the group to remove the entity from
+ * \param[in] type the kind of the entity
+ * \param[in] entity the entity previously added to the group
+ * \return `RCL_RET_OK` if the entity was removed successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the group is zero initialized, or
+ * \return `RCL_RET_ERROR` if the entity is not in the group.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_remove(
+  rcl_wait_set_group_t * group,
+  rcl_wait_set_entity_type_t type,
+  const void * entity);
+
+/// Wake up every shard of the group.
+/**
+ * This triggers the guard condition of every shard, so every rcl_wait_set_group_wait() in
+ * progress returns, e.g. to rebalance the entities over the shards or to stop the workers.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] group the group whose shards are woken up
+ * \return `RCL_RET_OK` if the shards were woken up successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the group is zero initialized, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_interrupt(rcl_wait_set_group_t * group);
+
+/// Wait for entities of a shard to become ready, and queue them.
+/**
+ * This waits with rcl_wait() on the entities of the shard, except those which were queued
+ * and whose work is not done yet, see rcl_wait_set_group_work_done().
+ * The entities found ready are put in the queue of the shard, where they can be taken with
+ * rcl_wait_set_group_take_work() by any worker.
+ *
+ * Each shard must only be waited on by one thread at a time, but different shards can be
+ * waited on concurrently.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * <i>[1] for different shards of the same group</i>
+ *
+ * \param[inout] group the group to wait on
+ * \param[in] shard the shard to wait on
+ * \param[in] timeout the duration to wait, in nanoseconds, see rcl_wait()
+ * \return `RCL_RET_OK` if something was queued or the shard was interrupted, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the group is zero initialized, or
+ * \return `RCL_RET_TIMEOUT` if the timeout expired before something was ready, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_wait(
+  rcl_wait_set_group_t * group,
+  size_t shard,
+  int64_t timeout);
+
+/// Take a ready entity from the queue of a shard, or steal it from another shard.
+/**
+ * The queue of `shard` is looked at first, then the queues of the other shards in turn.
+ * Each ready entity is handed to a single worker, which must call
+ * rcl_wait_set_group_work_done() once it is done taking from or calling it.
+ *
+ * Until then the entity is left out of the waits of its shard, whether it was stolen or not,
+ * so only one worker at a time handles it.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] group the group to take work from
+ * \param[in] shard the shard of the calling worker
+ * \param[out] work the ready entity, if any
+ * \param[out] taken `true` if a ready entity was taken, `false` if all queues were empty
+ * \return `RCL_RET_OK` if the queues were looked at successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the group is zero initialized.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_take_work(
+  rcl_wait_set_group_t * group,
+  size_t shard,
+  rcl_wait_set_group_work_t * work,
+  bool * taken);
+
+/// Let the shard of a ready entity wait on it again.
+/**
+ * If the work was stolen from another shard, that shard is woken up so that it waits on
+ * the entity again without delay.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] group the group the work was taken from
+ * \param[in] shard the shard of the calling worker
+ * \param[in] work the work taken with rcl_wait_set_group_take_work()
+ * \return `RCL_RET_OK` if the work was marked done successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_WAIT_SET_INVALID` if the group is zero initialized, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_group_work_done(
+  rcl_wait_set_group_t * group,
+  size_t shard,
+  const rcl_wait_set_group_work_t * work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__WAIT_SET_GROUP_H_
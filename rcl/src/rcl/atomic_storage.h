@@ -0,0 +1,59 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ATOMIC_STORAGE_H_
+#define RCL__ATOMIC_STORAGE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#include "rcl/context.h"
+
+/// \internal
+/// Storage for a 64 bit atomic in the private structs of the entities.
+/**
+ * C11 atomics cannot be declared in headers which are included into C++,
+ * like the tests do with these structs, see rcl_context_t::instance_id_storage.
+ * The structs only hold storage, which the C sources of rcl access through
+ * RCL_ATOMIC_UINT64() and RCL_ATOMIC_INT64().
+ */
+typedef struct rcl_atomic_storage_t
+{
+  RCL_ALIGNAS(8) uint8_t storage[sizeof(uint_least64_t)];
+} rcl_atomic_storage_t;
+
+#ifndef __cplusplus
+
+#include <assert.h>
+
+#include "rcutils/stdatomic_helper.h"
+
+static_assert(
+  sizeof(rcl_atomic_storage_t) >= sizeof(atomic_uint_least64_t),
+  "expected rcl_atomic_storage_t to be >= size of atomic_uint_least64_t");
+
+# define RCL_ATOMIC_UINT64(atomic_storage) ((atomic_uint_least64_t *)&(atomic_storage))
+# define RCL_ATOMIC_INT64(atomic_storage) ((atomic_int_least64_t *)&(atomic_storage))
+
+#endif  // __cplusplus
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ATOMIC_STORAGE_H_
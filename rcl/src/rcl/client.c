@@ -19,6 +19,7 @@ extern "C"
 
 #include "rcl/client.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -27,19 +28,14 @@ extern "C"
 #include "rcutils/logging_macros.h"
 #include "rcutils/macros.h"
 #include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
 #include "tracetools/tracetools.h"
 
+#include "./client_impl.h"
 #include "./common.h"
 
-typedef struct rcl_client_impl_t
-{
-  rcl_client_options_t options;
-  rmw_client_t * rmw_handle;
-  atomic_int_least64_t sequence_number;
-} rcl_client_impl_t;
-
 rcl_client_t
 rcl_get_zero_initialized_client()
 {
@@ -113,7 +109,11 @@ rcl_client_init(
   }
   // options
   client->impl->options = *options;
-  atomic_init(&client->impl->sequence_number, 0);
+  atomic_init(RCL_ATOMIC_INT64(client->impl->sequence_number), 0);
+  atomic_init(RCL_ATOMIC_UINT64(client->impl->take_failed_count), 0);
+  client->impl->request_window = NULL;
+  RCL_COUNTER_INIT(client->impl->counters.request_count);
+  RCL_COUNTER_INIT(client->impl->counters.response_count);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client initialized");
   ret = RCL_RET_OK;
   TRACEPOINT(
@@ -159,6 +159,7 @@ rcl_client_fini(rcl_client_t * client, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
+    rcl_request_window_fini(client->impl->request_window);
     allocator.deallocate(client->impl, allocator.state);
     client->impl = NULL;
   }
@@ -206,40 +207,98 @@ rcl_client_get_rmw_handle(const rcl_client_t * client)
   return client->impl->rmw_handle;
 }
 
-rcl_ret_t
-rcl_send_request(const rcl_client_t * client, const void * ros_request, int64_t * sequence_number)
+// Get the steady time at which a request times out, INT64_MAX if the timeout is negative.
+static rcl_ret_t
+_rcl_client_get_deadline(int64_t timeout, int64_t * deadline)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client sending service request");
-  if (!rcl_client_is_valid(client)) {
-    return RCL_RET_CLIENT_INVALID;  // error already set
+  *deadline = INT64_MAX;
+  if (timeout < 0) {
+    return RCL_RET_OK;
+  }
+  rcutils_time_point_value_t now;
+  if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  *deadline = now > INT64_MAX - timeout ? INT64_MAX : now + timeout;
+  return RCL_RET_OK;
+}
+
+// Send a request of a valid client, tracking it in the window if not NULL, whose mutex is held.
+static rcl_ret_t
+_rcl_send_request(
+  const rcl_client_t * client,
+  rcl_request_window_t * window,
+  const void * ros_request,
+  int64_t * sequence_number)
+{
+  *sequence_number = rcutils_atomic_load_int64_t(RCL_ATOMIC_INT64(client->impl->sequence_number));
+  // The middleware numbers the requests of a client consecutively, so the slot of the next
+  // sequence number is reserved before the request is sent.
+  const int64_t expected_sequence_number = *sequence_number + 1;
+  int64_t deadline = INT64_MAX;
+  if (window) {
+    if (!rcl_request_window_has_room(window, expected_sequence_number)) {
+      RCL_SET_ERROR_MSG("too many requests of the client are in flight");
+      return RCL_RET_CLIENT_REQUEST_WINDOW_FULL;
+    }
+    if (_rcl_client_get_deadline(window->request_timeout, &deadline) != RCL_RET_OK) {
+      return RCL_RET_ERROR;  // error already set
+    }
+    rcl_request_window_track(window, expected_sequence_number, deadline);
   }
-  RCL_CHECK_ARGUMENT_FOR_NULL(ros_request, RCL_RET_INVALID_ARGUMENT);
-  RCL_CHECK_ARGUMENT_FOR_NULL(sequence_number, RCL_RET_INVALID_ARGUMENT);
-  *sequence_number = rcutils_atomic_load_int64_t(&client->impl->sequence_number);
   if (rmw_send_request(
       client->impl->rmw_handle, ros_request, sequence_number) != RMW_RET_OK)
   {
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    if (window) {
+      rcl_request_window_release(
+        window, rcl_request_window_find(window, expected_sequence_number));
+    }
     return RCL_RET_ERROR;
   }
-  rcutils_atomic_exchange_int64_t(&client->impl->sequence_number, *sequence_number);
+  rcutils_atomic_exchange_int64_t(
+    RCL_ATOMIC_INT64(client->impl->sequence_number), *sequence_number);
+  RCL_COUNTER_ADD(client->impl->counters.request_count, 1u);
+  if (window && *sequence_number != expected_sequence_number) {
+    // The request is tracked by the number the middleware gave it, if its slot is free.
+    rcl_request_window_release(window, rcl_request_window_find(window, expected_sequence_number));
+    if (!rcl_request_window_has_room(window, *sequence_number)) {
+      RCL_SET_ERROR_MSG("request was sent but its sequence number collides with one in flight");
+      return RCL_RET_CLIENT_REQUEST_NOT_TRACKED;
+    }
+    rcl_request_window_track(window, *sequence_number, deadline);
+  }
   return RCL_RET_OK;
 }
 
 rcl_ret_t
-rcl_take_response_with_info(
-  const rcl_client_t * client,
-  rmw_service_info_t * request_header,
-  void * ros_response)
+rcl_send_request(const rcl_client_t * client, const void * ros_request, int64_t * sequence_number)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client taking service response");
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client sending service request");
   if (!rcl_client_is_valid(client)) {
     return RCL_RET_CLIENT_INVALID;  // error already set
   }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_request, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(sequence_number, RCL_RET_INVALID_ARGUMENT);
+  rcl_request_window_t * window = client->impl->request_window;
+  if (!window) {
+    return _rcl_send_request(client, NULL, ros_request, sequence_number);
+  }
+  // Sends are serialized, so that the slot reserved is the one of the number the middleware gives.
+  rcl_mutex_lock(window->mutex);
+  rcl_ret_t ret = _rcl_send_request(client, window, ros_request, sequence_number);
+  rcl_mutex_unlock(window->mutex);
+  return ret;
+}
 
-  RCL_CHECK_ARGUMENT_FOR_NULL(request_header, RCL_RET_INVALID_ARGUMENT);
-  RCL_CHECK_ARGUMENT_FOR_NULL(ros_response, RCL_RET_INVALID_ARGUMENT);
-
+// Take the next response of a valid client, whatever the request it answers.
+static rcl_ret_t
+_rcl_take_response(
+  const rcl_client_t * client,
+  rmw_service_info_t * request_header,
+  void * ros_response)
+{
   bool taken = false;
   request_header->source_timestamp = 0;
   request_header->received_timestamp = 0;
@@ -252,11 +311,44 @@ rcl_take_response_with_info(
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Client take response succeeded: %s", taken ? "true" : "false");
   if (!taken) {
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(client->impl->take_failed_count), 1);
     return RCL_RET_CLIENT_TAKE_FAILED;
   }
+  RCL_COUNTER_ADD(client->impl->counters.response_count, 1u);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_take_response_with_info(
+  const rcl_client_t * client,
+  rmw_service_info_t * request_header,
+  void * ros_response)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client taking service response");
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+
+  RCL_CHECK_ARGUMENT_FOR_NULL(request_header, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_response, RCL_RET_INVALID_ARGUMENT);
+
+  rcl_request_window_t * window = client->impl->request_window;
+  if (!window) {
+    return _rcl_take_response(client, request_header, ros_response);
+  }
+  rcl_mutex_lock(window->mutex);
+  rcl_ret_t ret = _rcl_take_response(client, request_header, ros_response);
+  if (RCL_RET_OK == ret) {
+    rcl_request_slot_t * slot =
+      rcl_request_window_find(window, request_header->request_id.sequence_number);
+    if (slot && !slot->has_response) {
+      rcl_request_window_release(window, slot);
+    }
+  }
+  rcl_mutex_unlock(window->mutex);
+  return ret;
+}
+
 rcl_ret_t
 rcl_take_response(
   const rcl_client_t * client,
@@ -270,6 +362,222 @@ rcl_take_response(
   return ret;
 }
 
+rcl_ret_t
+rcl_client_init_request_window(
+  const rcl_client_t * client,
+  size_t window_size,
+  size_t response_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  if (client->impl->request_window) {
+    RCL_SET_ERROR_MSG("client already has a request window");
+    return RCL_RET_ALREADY_INIT;
+  }
+  return rcl_request_window_init(
+    &client->impl->request_window, window_size, response_size, init_function, fini_function,
+    client->impl->options.allocator);
+}
+
+// Return the request window of a valid client, or set an error if it has none.
+static rcl_request_window_t *
+_rcl_client_get_request_window(const rcl_client_t * client)
+{
+  rcl_request_window_t * window = client->impl->request_window;
+  if (!window) {
+    RCL_SET_ERROR_MSG("client has no request window");
+  }
+  return window;
+}
+
+// Take the response of a request in the window of a valid client, whose mutex is held.
+static rcl_ret_t
+_rcl_client_take_response_for(
+  const rcl_client_t * client,
+  rcl_request_window_t * window,
+  int64_t sequence_number,
+  rmw_service_info_t * response_header,
+  void * ros_response)
+{
+  rcl_request_slot_t * slot = rcl_request_window_find(window, sequence_number);
+  if (!slot) {
+    RCL_SET_ERROR_MSG("request is not in flight");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  // Keep the responses taken on the way in the slots of their requests.
+  while (!slot->has_response) {
+    void * scratch = rcl_request_window_response(window, NULL);
+    rmw_service_info_t header;
+    rcl_ret_t ret = _rcl_take_response(client, &header, scratch);
+    if (ret != RCL_RET_OK) {
+      return ret;
+    }
+    rcl_request_slot_t * owner =
+      rcl_request_window_find(window, header.request_id.sequence_number);
+    if (!owner || owner->has_response) {
+      RCUTILS_LOG_DEBUG_NAMED(
+        ROS_PACKAGE_NAME, "Dropping response %" PRId64 " of a request not in flight",
+        header.request_id.sequence_number);
+      continue;
+    }
+    rcl_request_window_swap(window, scratch, rcl_request_window_response(window, owner));
+    rcl_request_window_keep_response(window, owner, &header);
+  }
+  rcl_request_window_swap(window, rcl_request_window_response(window, slot), ros_response);
+  *response_header = slot->response_header;
+  rcl_request_window_release(window, slot);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_client_take_response_for(
+  const rcl_client_t * client,
+  int64_t sequence_number,
+  rmw_service_info_t * response_header,
+  void * ros_response)
+{
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Client taking service response %" PRId64, sequence_number);
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(response_header, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_response, RCL_RET_INVALID_ARGUMENT);
+  rcl_request_window_t * window = _rcl_client_get_request_window(client);
+  if (!window) {
+    return RCL_RET_NOT_INIT;
+  }
+  rcl_mutex_lock(window->mutex);
+  rcl_ret_t ret = _rcl_client_take_response_for(
+    client, window, sequence_number, response_header, ros_response);
+  rcl_mutex_unlock(window->mutex);
+  return ret;
+}
+
+rcl_ret_t
+rcl_client_cancel_request(const rcl_client_t * client, int64_t sequence_number)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  rcl_request_window_t * window = _rcl_client_get_request_window(client);
+  if (!window) {
+    return RCL_RET_NOT_INIT;
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  rcl_mutex_lock(window->mutex);
+  rcl_request_slot_t * slot = rcl_request_window_find(window, sequence_number);
+  if (slot) {
+    rcl_request_window_release(window, slot);
+  } else {
+    RCL_SET_ERROR_MSG("request is not in flight");
+    ret = RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_mutex_unlock(window->mutex);
+  return ret;
+}
+
+rcl_ret_t
+rcl_client_set_default_request_timeout(const rcl_client_t * client, int64_t timeout)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  rcl_request_window_t * window = _rcl_client_get_request_window(client);
+  if (!window) {
+    return RCL_RET_NOT_INIT;
+  }
+  rcl_mutex_lock(window->mutex);
+  window->request_timeout = timeout;
+  rcl_mutex_unlock(window->mutex);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_client_set_request_timeout(
+  const rcl_client_t * client,
+  int64_t sequence_number,
+  int64_t timeout)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  rcl_request_window_t * window = _rcl_client_get_request_window(client);
+  if (!window) {
+    return RCL_RET_NOT_INIT;
+  }
+  int64_t deadline;
+  if (_rcl_client_get_deadline(timeout, &deadline) != RCL_RET_OK) {
+    return RCL_RET_ERROR;  // error already set
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  rcl_mutex_lock(window->mutex);
+  rcl_request_slot_t * slot = rcl_request_window_find(window, sequence_number);
+  if (slot) {
+    rcl_request_window_set_deadline(window, slot, deadline);
+  } else {
+    RCL_SET_ERROR_MSG("request is not in flight");
+    ret = RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_mutex_unlock(window->mutex);
+  return ret;
+}
+
+rcl_ret_t
+rcl_client_sweep_expired_requests(
+  const rcl_client_t * client,
+  int64_t * sequence_numbers,
+  size_t capacity,
+  size_t * count)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(count, RCL_RET_INVALID_ARGUMENT);
+  if (capacity > 0u) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(sequence_numbers, RCL_RET_INVALID_ARGUMENT);
+  }
+  rcl_request_window_t * window = _rcl_client_get_request_window(client);
+  if (!window) {
+    return RCL_RET_NOT_INIT;
+  }
+  *count = 0u;
+  rcutils_time_point_value_t now;
+  if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  size_t cursor = 0u;
+  rcl_request_slot_t * slot;
+  rcl_mutex_lock(window->mutex);
+  while (*count < capacity && (slot = rcl_request_window_find_expired(window, now, &cursor))) {
+    sequence_numbers[(*count)++] = slot->sequence_number;
+    rcl_request_window_release(window, slot);
+  }
+  rcl_mutex_unlock(window->mutex);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_client_get_in_flight_count(const rcl_client_t * client, size_t * in_flight_count)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(in_flight_count, RCL_RET_INVALID_ARGUMENT);
+  rcl_request_window_t * window = _rcl_client_get_request_window(client);
+  if (!window) {
+    return RCL_RET_NOT_INIT;
+  }
+  rcl_mutex_lock(window->mutex);
+  *in_flight_count = window->in_flight_count;
+  rcl_mutex_unlock(window->mutex);
+  return RCL_RET_OK;
+}
+
 bool
 rcl_client_is_valid(const rcl_client_t * client)
 {
@@ -280,6 +588,26 @@ rcl_client_is_valid(const rcl_client_t * client)
     client->impl->rmw_handle, "client's rmw handle is invalid", return false);
   return true;
 }
+
+rcl_ret_t
+rcl_client_get_statistics(const rcl_client_t * client, rcl_client_statistics_t * statistics)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_client_counters_t * counters = &client->impl->counters;
+  statistics->request_count = RCL_COUNTER_LOAD(counters->request_count);
+  statistics->response_count = RCL_COUNTER_LOAD(counters->response_count);
+  statistics->take_failed_count =
+    rcutils_atomic_load_uint64_t(RCL_ATOMIC_UINT64(client->impl->take_failed_count));
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
 #ifdef __cplusplus
 }
 #endif
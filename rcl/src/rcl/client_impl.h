@@ -0,0 +1,38 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__CLIENT_IMPL_H_
+#define RCL__CLIENT_IMPL_H_
+
+#include "rmw/rmw.h"
+
+#include "rcl/client.h"
+
+#include "./atomic_storage.h"
+#include "./counters.h"
+#include "./request_window.h"
+
+typedef struct rcl_client_impl_t
+{
+  rcl_client_options_t options;
+  rmw_client_t * rmw_handle;
+  rcl_atomic_storage_t sequence_number;
+  // number of takes which found no response, used by edge triggered wait sets
+  rcl_atomic_storage_t take_failed_count;
+  // NULL unless created with rcl_client_init_request_window()
+  rcl_request_window_t * request_window;
+  rcl_client_counters_t counters;
+} rcl_client_impl_t;
+
+#endif  // RCL__CLIENT_IMPL_H_
@@ -105,6 +105,14 @@ rcl_context_get_rmw_context(rcl_context_t * context)
   return &(context->impl->rmw_context);
 }
 
+rcl_clock_t *
+rcl_context_get_ros_clock(rcl_context_t * context)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, NULL);
+  RCL_CHECK_FOR_NULL_WITH_MSG(context->impl, "context is zero-initialized", return NULL);
+  return &(context->impl->ros_clock);
+}
+
 rcl_ret_t
 __cleanup_context(rcl_context_t * context)
 {
@@ -146,6 +154,22 @@ __cleanup_context(rcl_context_t * context)
       }
     }
 
+    // detach from the ROS time source, which lives on while other clocks are attached to it
+    if (RCL_ROS_TIME == context->impl->ros_clock.type) {
+      rcl_ret_t ros_clock_fini_ret = rcl_ros_clock_fini(&(context->impl->ros_clock));
+      if (RCL_RET_OK != ros_clock_fini_ret) {
+        if (RCL_RET_OK == ret) {
+          ret = ros_clock_fini_ret;
+        }
+        RCUTILS_SAFE_FWRITE_TO_STDERR(
+          "[rcl|context.c:" RCUTILS_STRINGIFY(__LINE__)
+          "] failed to finalize ROS clock while cleaning up context, memory may be leaked: ");
+        RCUTILS_SAFE_FWRITE_TO_STDERR(rcl_get_error_string().str);
+        RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
+        rcl_reset_error();
+      }
+    }
+
     // clean up rmw_context
     if (NULL != context->impl->rmw_context.implementation_identifier) {
       rmw_ret_t rmw_context_fini_ret = rmw_context_fini(&(context->impl->rmw_context));
@@ -17,6 +17,7 @@
 
 #include "rcl/context.h"
 #include "rcl/error_handling.h"
+#include "rcl/time.h"
 
 #include "./init_options_impl.h"
 
@@ -38,6 +39,8 @@ typedef struct rcl_context_impl_t
   char ** argv;
   /// rmw context.
   rmw_context_t rmw_context;
+  /// ROS time source shared by the clocks attached to it.
+  rcl_clock_t ros_clock;
 } rcl_context_impl_t;
 
 RCL_LOCAL
@@ -0,0 +1,106 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__COUNTERS_H_
+#define RCL__COUNTERS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#include "./atomic_storage.h"
+
+/// \internal
+/// Counters of the data path of the entities, updated when RCL_ENABLE_STATISTICS is defined.
+/**
+ * The counters are part of the entities either way, so that the layout of their
+ * private structs does not depend on how rcl was built.
+ * Without RCL_ENABLE_STATISTICS the macros below expand to nothing, so that their
+ * arguments are not evaluated.
+ * Counters are only ever incremented, so relaxed atomics are enough.
+ */
+typedef rcl_atomic_storage_t rcl_counter_t;
+
+#ifdef RCL_ENABLE_STATISTICS
+
+# define RCL_COUNTER_INIT(counter) atomic_init(RCL_ATOMIC_UINT64(counter), 0u)
+# define RCL_COUNTER_ADD(counter, value) \
+  ((void)atomic_fetch_add_explicit( \
+    RCL_ATOMIC_UINT64(counter), (uint64_t)(value), memory_order_relaxed))
+# define RCL_COUNTER_LOAD(counter) \
+  ((uint64_t)atomic_load_explicit(RCL_ATOMIC_UINT64(counter), memory_order_relaxed))
+# define RCL_COUNTER_RESET(counter) \
+  atomic_store_explicit(RCL_ATOMIC_UINT64(counter), (uint64_t)0u, memory_order_relaxed)
+// Only for counters which a single thread updates, like those of a wait set.
+# define RCL_COUNTER_STORE_MAX(counter, value) \
+  do { \
+    if ((uint64_t)(value) > RCL_COUNTER_LOAD(counter)) { \
+      atomic_store_explicit(RCL_ATOMIC_UINT64(counter), (uint64_t)(value), memory_order_relaxed); \
+    } \
+  } while (0)
+
+#else  // RCL_ENABLE_STATISTICS
+
+# define RCL_COUNTER_INIT(counter) ((void)0)
+# define RCL_COUNTER_ADD(counter, value) ((void)0)
+# define RCL_COUNTER_STORE_MAX(counter, value) ((void)0)
+
+#endif  // RCL_ENABLE_STATISTICS
+
+typedef struct rcl_publisher_counters_t
+{
+  rcl_counter_t message_count;
+  rcl_counter_t serialized_message_count;
+  rcl_counter_t serialized_byte_count;
+  rcl_counter_t publish_failed_count;
+} rcl_publisher_counters_t;
+
+// The take failed count is already kept by the subscription, client and service themselves.
+typedef struct rcl_subscription_counters_t
+{
+  rcl_counter_t message_count;
+  rcl_counter_t serialized_message_count;
+  rcl_counter_t serialized_byte_count;
+} rcl_subscription_counters_t;
+
+typedef struct rcl_client_counters_t
+{
+  rcl_counter_t request_count;
+  rcl_counter_t response_count;
+} rcl_client_counters_t;
+
+typedef struct rcl_service_counters_t
+{
+  rcl_counter_t request_count;
+  rcl_counter_t response_count;
+} rcl_service_counters_t;
+
+typedef struct rcl_wait_set_counters_t
+{
+  rcl_counter_t wait_count;
+  rcl_counter_t ready_wakeup_count;
+  rcl_counter_t timeout_wakeup_count;
+  rcl_counter_t error_count;
+  rcl_counter_t wait_duration_ns;
+  rcl_counter_t max_wait_duration_ns;
+} rcl_wait_set_counters_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__COUNTERS_H_
@@ -77,6 +77,7 @@ rcl_publisher_event_init(
 
   event->impl->rmw_handle = rmw_get_zero_initialized_event();
   event->impl->allocator = *allocator;
+  atomic_init(RCL_ATOMIC_UINT64(event->impl->take_failed_count), 0);
 
   rmw_ret_t ret = rmw_publisher_event_init(
     &event->impl->rmw_handle,
@@ -131,6 +132,7 @@ rcl_subscription_event_init(
 
   event->impl->rmw_handle = rmw_get_zero_initialized_event();
   event->impl->allocator = *allocator;
+  atomic_init(RCL_ATOMIC_UINT64(event->impl->take_failed_count), 0);
 
   rmw_ret_t ret = rmw_subscription_event_init(
     &event->impl->rmw_handle,
@@ -165,6 +167,7 @@ rcl_take_event(
   if (!taken) {
     RCUTILS_LOG_DEBUG_NAMED(
       ROS_PACKAGE_NAME, "take_event request complete, unable to take event");
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(event->impl->take_failed_count), 1);
     return RCL_RET_EVENT_TAKE_FAILED;
   }
   RCUTILS_LOG_DEBUG_NAMED(
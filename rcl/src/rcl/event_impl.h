@@ -19,10 +19,14 @@
 
 #include "rcl/event.h"
 
+#include "./atomic_storage.h"
+
 typedef struct rcl_event_impl_t
 {
   rmw_event_t rmw_handle;
   rcl_allocator_t allocator;
+  // number of takes which found no event, used by edge triggered wait sets
+  rcl_atomic_storage_t take_failed_count;
 } rcl_event_impl_t;
 
 #endif  // RCL__EVENT_IMPL_H_
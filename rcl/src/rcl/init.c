@@ -102,6 +102,13 @@ rcl_init(
     goto fail;
   }
 
+  // Create the ROS time source which the clocks of this context can attach to.
+  ret = rcl_ros_clock_init(&(context->impl->ros_clock), &allocator);
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error message already set
+    goto fail;
+  }
+
   // Copy the argc and argv into the context, if argc >= 0.
   context->impl->argc = argc;
   context->impl->argv = NULL;
@@ -0,0 +1,224 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./kernel_timer.h"
+
+#include "rcl/error_handling.h"
+#include "rcl/time.h"
+#include "rcutils/logging_macros.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+struct rcl_kernel_timer_t
+{
+  // The timerfd, on CLOCK_MONOTONIC.
+  int timer_fd;
+  // An eventfd written to stop the thread.
+  int stop_fd;
+  // The thread blocking on the timerfd.
+  pthread_t thread;
+  // The guard condition triggered when the timerfd expires.
+  rcl_guard_condition_t * guard_condition;
+  // The allocator used to allocate this struct.
+  rcl_allocator_t allocator;
+};
+
+static void *
+__kernel_timer_thread(void * arg)
+{
+  rcl_kernel_timer_t * kernel_timer = (rcl_kernel_timer_t *)arg;
+  struct pollfd fds[2];
+  fds[0].fd = kernel_timer->timer_fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = kernel_timer->stop_fd;
+  fds[1].events = POLLIN;
+  for (;;) {
+    if (poll(fds, 2, -1) < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to poll kernel timer: %d", errno);
+      return NULL;
+    }
+    if (fds[1].revents & POLLIN) {
+      return NULL;
+    }
+    if (fds[0].revents & POLLIN) {
+      uint64_t expirations = 0u;
+      // May fail with EAGAIN if the timer was rearmed in the meantime, then it didn't expire.
+      if (read(kernel_timer->timer_fd, &expirations, sizeof(expirations)) < 0) {
+        continue;
+      }
+      if (RCL_RET_OK != rcl_trigger_guard_condition(kernel_timer->guard_condition)) {
+        RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to trigger timer guard condition");
+      }
+    }
+  }
+}
+
+rcl_ret_t
+rcl_kernel_timer_init(
+  rcl_kernel_timer_t ** kernel_timer,
+  rcl_guard_condition_t * guard_condition,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(kernel_timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(guard_condition, RCL_RET_INVALID_ARGUMENT);
+  rcl_kernel_timer_t * impl = (rcl_kernel_timer_t *)allocator.allocate(
+    sizeof(rcl_kernel_timer_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  impl->guard_condition = guard_condition;
+  impl->allocator = allocator;
+  impl->stop_fd = -1;
+  impl->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (impl->timer_fd < 0) {
+    RCL_SET_ERROR_MSG("failed to create timerfd");
+    goto fail;
+  }
+  impl->stop_fd = eventfd(0, EFD_CLOEXEC);
+  if (impl->stop_fd < 0) {
+    RCL_SET_ERROR_MSG("failed to create eventfd");
+    goto fail;
+  }
+  if (0 != pthread_create(&impl->thread, NULL, __kernel_timer_thread, impl)) {
+    RCL_SET_ERROR_MSG("failed to start kernel timer thread");
+    goto fail;
+  }
+  *kernel_timer = impl;
+  return RCL_RET_OK;
+fail:
+  if (impl->stop_fd >= 0) {
+    close(impl->stop_fd);
+  }
+  if (impl->timer_fd >= 0) {
+    close(impl->timer_fd);
+  }
+  allocator.deallocate(impl, allocator.state);
+  return RCL_RET_ERROR;
+}
+
+rcl_ret_t
+rcl_kernel_timer_arm(rcl_kernel_timer_t * kernel_timer, int64_t deadline)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(kernel_timer, RCL_RET_INVALID_ARGUMENT);
+  struct itimerspec spec = {0};
+  // An all zero it_value would disarm the timer, so expire as early as possible instead.
+  if (deadline <= 0) {
+    deadline = 1;
+  }
+  spec.it_value.tv_sec = (time_t)RCL_NS_TO_S(deadline);
+  spec.it_value.tv_nsec = (long)(deadline % 1000000000);  // NOLINT
+  if (0 != timerfd_settime(kernel_timer->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL)) {
+    RCL_SET_ERROR_MSG("failed to arm timerfd");
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_kernel_timer_disarm(rcl_kernel_timer_t * kernel_timer)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(kernel_timer, RCL_RET_INVALID_ARGUMENT);
+  struct itimerspec spec = {0};
+  if (0 != timerfd_settime(kernel_timer->timer_fd, 0, &spec, NULL)) {
+    RCL_SET_ERROR_MSG("failed to disarm timerfd");
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_kernel_timer_fini(rcl_kernel_timer_t * kernel_timer)
+{
+  if (NULL == kernel_timer) {
+    return RCL_RET_OK;
+  }
+  const uint64_t stop = 1u;
+  if (write(kernel_timer->stop_fd, &stop, sizeof(stop)) < 0 ||
+    0 != pthread_join(kernel_timer->thread, NULL))
+  {
+    // Leak the rest rather than pulling resources from under a running thread.
+    RCL_SET_ERROR_MSG("failed to stop kernel timer thread");
+    return RCL_RET_ERROR;
+  }
+  close(kernel_timer->stop_fd);
+  close(kernel_timer->timer_fd);
+  rcl_allocator_t allocator = kernel_timer->allocator;
+  allocator.deallocate(kernel_timer, allocator.state);
+  return RCL_RET_OK;
+}
+
+#else  // __linux__
+
+struct rcl_kernel_timer_t
+{
+  int unused;
+};
+
+rcl_ret_t
+rcl_kernel_timer_init(
+  rcl_kernel_timer_t ** kernel_timer,
+  rcl_guard_condition_t * guard_condition,
+  rcl_allocator_t allocator)
+{
+  (void)kernel_timer;
+  (void)guard_condition;
+  (void)allocator;
+  RCL_SET_ERROR_MSG("kernel timers are only supported on Linux");
+  return RCL_RET_UNSUPPORTED;
+}
+
+rcl_ret_t
+rcl_kernel_timer_arm(rcl_kernel_timer_t * kernel_timer, int64_t deadline)
+{
+  (void)kernel_timer;
+  (void)deadline;
+  RCL_SET_ERROR_MSG("kernel timers are only supported on Linux");
+  return RCL_RET_UNSUPPORTED;
+}
+
+rcl_ret_t
+rcl_kernel_timer_disarm(rcl_kernel_timer_t * kernel_timer)
+{
+  (void)kernel_timer;
+  RCL_SET_ERROR_MSG("kernel timers are only supported on Linux");
+  return RCL_RET_UNSUPPORTED;
+}
+
+rcl_ret_t
+rcl_kernel_timer_fini(rcl_kernel_timer_t * kernel_timer)
+{
+  (void)kernel_timer;
+  return RCL_RET_OK;
+}
+
+#endif  // __linux__
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__KERNEL_TIMER_H_
+#define RCL__KERNEL_TIMER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/allocator.h"
+#include "rcl/guard_condition.h"
+#include "rcl/macros.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+/// \internal
+/// Kernel timer which triggers a guard condition when it expires.
+/**
+ * On Linux it is backed by a `timerfd` on `CLOCK_MONOTONIC`, the clock behind
+ * `RCL_STEADY_TIME`, and a thread blocking on it.
+ * It is not supported on other platforms.
+ */
+typedef struct rcl_kernel_timer_t rcl_kernel_timer_t;
+
+/// \internal
+/// Create a disarmed kernel timer which triggers the given guard condition.
+/**
+ * The guard condition must outlive the kernel timer.
+ *
+ * \return `RCL_RET_OK` if the kernel timer was created, or
+ * \return `RCL_RET_UNSUPPORTED` if kernel timers are not supported on this platform, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_kernel_timer_init(
+  rcl_kernel_timer_t ** kernel_timer,
+  rcl_guard_condition_t * guard_condition,
+  rcl_allocator_t allocator);
+
+/// \internal
+/// Arm the kernel timer to expire once at the given steady time, in nanoseconds.
+/**
+ * A deadline in the past makes it expire immediately.
+ * Arming an armed kernel timer replaces its deadline.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_kernel_timer_arm(rcl_kernel_timer_t * kernel_timer, int64_t deadline);
+
+/// \internal
+/// Disarm the kernel timer, if armed.
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_kernel_timer_disarm(rcl_kernel_timer_t * kernel_timer);
+
+/// \internal
+/// Stop and destroy the kernel timer.
+RCL_LOCAL
+rcl_ret_t
+rcl_kernel_timer_fini(rcl_kernel_timer_t * kernel_timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__KERNEL_TIMER_H_
@@ -0,0 +1,167 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./message_pool.h"
+
+#include <stdint.h>
+
+#include "rcl/error_handling.h"
+
+// Finalize the first initialized_count messages of a pool and deallocate it.
+static void
+_rcl_message_pool_destroy(rcl_message_pool_t * pool, size_t initialized_count)
+{
+  rcl_allocator_t allocator = pool->allocator;
+  size_t i;
+  for (i = 0u; i < initialized_count; ++i) {
+    pool->fini_function(pool->messages + i * pool->message_size);
+  }
+  allocator.deallocate(pool->messages, allocator.state);
+  allocator.deallocate(pool->free_ring, allocator.state);
+  allocator.deallocate(pool->lent, allocator.state);
+  rcl_mutex_fini(pool->mutex);
+  allocator.deallocate(pool, allocator.state);
+}
+
+rcl_ret_t
+rcl_message_pool_init(
+  rcl_message_pool_t ** pool,
+  size_t message_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  size_t pool_size,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(pool, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_function, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(fini_function, RCL_RET_INVALID_ARGUMENT);
+  if (0u == message_size || 0u == pool_size) {
+    RCL_SET_ERROR_MSG("message size and pool size must be non-zero");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (pool_size > SIZE_MAX / message_size || pool_size > SIZE_MAX / sizeof(size_t)) {
+    RCL_SET_ERROR_MSG("message pool size overflows");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_message_pool_t * new_pool = (rcl_message_pool_t *)allocator.zero_allocate(
+    1u, sizeof(rcl_message_pool_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(new_pool, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  new_pool->message_size = message_size;
+  new_pool->pool_size = pool_size;
+  new_pool->fini_function = fini_function;
+  new_pool->allocator = allocator;
+  new_pool->messages = (char *)allocator.zero_allocate(pool_size, message_size, allocator.state);
+  new_pool->free_ring = (size_t *)allocator.allocate(pool_size * sizeof(size_t), allocator.state);
+  new_pool->lent = (bool *)allocator.zero_allocate(pool_size, sizeof(bool), allocator.state);
+  if (!new_pool->messages || !new_pool->free_ring || !new_pool->lent) {
+    _rcl_message_pool_destroy(new_pool, 0u);
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  rcl_ret_t ret = rcl_mutex_init(&new_pool->mutex, allocator);
+  if (ret != RCL_RET_OK) {
+    _rcl_message_pool_destroy(new_pool, 0u);
+    return ret;  // error already set
+  }
+  size_t i;
+  for (i = 0u; i < pool_size; ++i) {
+    if (!init_function(new_pool->messages + i * message_size)) {
+      _rcl_message_pool_destroy(new_pool, i);
+      RCL_SET_ERROR_MSG("initializing a message of the pool failed");
+      return RCL_RET_ERROR;
+    }
+    new_pool->free_ring[i] = i;
+  }
+  new_pool->free_head = 0u;
+  new_pool->free_count = pool_size;
+  *pool = new_pool;
+  return RCL_RET_OK;
+}
+
+void
+rcl_message_pool_fini(rcl_message_pool_t * pool)
+{
+  if (pool) {
+    _rcl_message_pool_destroy(pool, pool->pool_size);
+  }
+}
+
+void *
+rcl_message_pool_next(const rcl_message_pool_t * pool)
+{
+  if (0u == pool->free_count) {
+    return NULL;
+  }
+  return pool->messages + pool->free_ring[pool->free_head] * pool->message_size;
+}
+
+void
+rcl_message_pool_lend(rcl_message_pool_t * pool)
+{
+  pool->lent[pool->free_ring[pool->free_head]] = true;
+  pool->free_head = (pool->free_head + 1u) % pool->pool_size;
+  --pool->free_count;
+}
+
+// Find the index of a lent message of the pool, setting the error message if there is none.
+static rcl_ret_t
+_rcl_message_pool_find_lent(const rcl_message_pool_t * pool, const void * message, size_t * index)
+{
+  const char * first = pool->messages;
+  const char * last = pool->messages + (pool->pool_size - 1u) * pool->message_size;
+  const char * address = (const char *)message;
+  if (
+    address < first || address > last ||
+    (size_t)(address - first) % pool->message_size != 0u)
+  {
+    RCL_SET_ERROR_MSG("message does not belong to the pool");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  *index = (size_t)(address - first) / pool->message_size;
+  if (!pool->lent[*index]) {
+    RCL_SET_ERROR_MSG("message is not lent");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_message_pool_check_lent(const rcl_message_pool_t * pool, const void * message)
+{
+  size_t index;
+  return _rcl_message_pool_find_lent(pool, message, &index);
+}
+
+rcl_ret_t
+rcl_message_pool_return(rcl_message_pool_t * pool, const void * message)
+{
+  size_t index;
+  rcl_ret_t ret = _rcl_message_pool_find_lent(pool, message, &index);
+  if (ret != RCL_RET_OK) {
+    return ret;  // The error message is already set.
+  }
+  pool->lent[index] = false;
+  pool->free_ring[(pool->free_head + pool->free_count) % pool->pool_size] = index;
+  ++pool->free_count;
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
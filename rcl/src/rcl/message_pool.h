@@ -0,0 +1,128 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__MESSAGE_POOL_H_
+#define RCL__MESSAGE_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/macros.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+#include "./mutex.h"
+
+/// \internal
+/// Fixed set of preallocated ROS messages which are lent and returned.
+/**
+ * The messages are initialized once and finalized with the pool, so that they
+ * keep the capacity of their sequences and strings across loans.
+ * Free messages are kept in a ring and lent in the order they were returned.
+ *
+ * The functions below do not lock, their callers hold the mutex of the pool
+ * around them, as messages are lent and returned from several threads.
+ */
+typedef struct rcl_message_pool_t
+{
+  // pool_size messages of message_size bytes each
+  char * messages;
+  size_t message_size;
+  size_t pool_size;
+  rcl_message_fini_function_t fini_function;
+  // ring of the indices of the free messages
+  size_t * free_ring;
+  size_t free_head;
+  size_t free_count;
+  // whether each message is lent, to catch messages returned twice
+  bool * lent;
+  // guards the free ring and the lent flags
+  rcl_mutex_t * mutex;
+  rcl_allocator_t allocator;
+} rcl_message_pool_t;
+
+/// \internal
+/// Create a pool of `pool_size` messages initialized with `init_function`.
+/**
+ * \return `RCL_RET_OK` if the pool was created, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if a message failed to initialize.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_message_pool_init(
+  rcl_message_pool_t ** pool,
+  size_t message_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  size_t pool_size,
+  rcl_allocator_t allocator);
+
+/// \internal
+/// Finalize every message of the pool, lent or not, and destroy it.
+RCL_LOCAL
+void
+rcl_message_pool_fini(rcl_message_pool_t * pool);
+
+/// \internal
+/// Return the message which is lent next, or `NULL` if every message is lent.
+/**
+ * The message is only lent by rcl_message_pool_lend(), so it can be filled
+ * first and left free if that fails.
+ */
+RCL_LOCAL
+void *
+rcl_message_pool_next(const rcl_message_pool_t * pool);
+
+/// \internal
+/// Lend the message returned by rcl_message_pool_next(), which must not be `NULL`.
+RCL_LOCAL
+void
+rcl_message_pool_lend(rcl_message_pool_t * pool);
+
+/// \internal
+/// Check that a message is a lent message of the pool, without returning it.
+/**
+ * \return `RCL_RET_OK` if the message is lent by the pool, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if the message is not a lent message of the pool.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_message_pool_check_lent(const rcl_message_pool_t * pool, const void * message);
+
+/// \internal
+/// Return a lent message to the pool.
+/**
+ * \return `RCL_RET_OK` if the message was returned, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if the message is not a lent message of the pool.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_message_pool_return(rcl_message_pool_t * pool, const void * message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__MESSAGE_POOL_H_
@@ -0,0 +1,103 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./mutex.h"
+
+#include "rcl/error_handling.h"
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+struct rcl_mutex_t
+{
+  SRWLOCK lock;
+  // The allocator used to allocate this struct.
+  rcl_allocator_t allocator;
+};
+
+#else  // _WIN32
+
+#include <pthread.h>
+
+struct rcl_mutex_t
+{
+  pthread_mutex_t mutex;
+  // The allocator used to allocate this struct.
+  rcl_allocator_t allocator;
+};
+
+#endif  // _WIN32
+
+rcl_ret_t
+rcl_mutex_init(rcl_mutex_t ** mutex, rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(mutex, RCL_RET_INVALID_ARGUMENT);
+  rcl_mutex_t * impl = (rcl_mutex_t *)allocator.allocate(sizeof(rcl_mutex_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  impl->allocator = allocator;
+#ifdef _WIN32
+  InitializeSRWLock(&impl->lock);
+#else
+  if (0 != pthread_mutex_init(&impl->mutex, NULL)) {
+    allocator.deallocate(impl, allocator.state);
+    RCL_SET_ERROR_MSG("failed to initialize mutex");
+    return RCL_RET_ERROR;
+  }
+#endif
+  *mutex = impl;
+  return RCL_RET_OK;
+}
+
+void
+rcl_mutex_fini(rcl_mutex_t * mutex)
+{
+  if (NULL == mutex) {
+    return;
+  }
+#ifndef _WIN32
+  pthread_mutex_destroy(&mutex->mutex);
+#endif
+  rcl_allocator_t allocator = mutex->allocator;
+  allocator.deallocate(mutex, allocator.state);
+}
+
+void
+rcl_mutex_lock(rcl_mutex_t * mutex)
+{
+#ifdef _WIN32
+  AcquireSRWLockExclusive(&mutex->lock);
+#else
+  pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+void
+rcl_mutex_unlock(rcl_mutex_t * mutex)
+{
+#ifdef _WIN32
+  ReleaseSRWLockExclusive(&mutex->lock);
+#else
+  pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
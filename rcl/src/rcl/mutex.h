@@ -0,0 +1,69 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__MUTEX_H_
+#define RCL__MUTEX_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/allocator.h"
+#include "rcl/macros.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+/// \internal
+/// Non-recursive mutex for the state which rcl shares between threads.
+/**
+ * It is backed by a `pthread_mutex_t`, or by an `SRWLOCK` on Windows.
+ */
+typedef struct rcl_mutex_t rcl_mutex_t;
+
+/// \internal
+/// Create an unlocked mutex.
+/**
+ * \return `RCL_RET_OK` if the mutex was created, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_mutex_init(rcl_mutex_t ** mutex, rcl_allocator_t allocator);
+
+/// \internal
+/// Destroy an unlocked mutex, `NULL` is ignored.
+RCL_LOCAL
+void
+rcl_mutex_fini(rcl_mutex_t * mutex);
+
+/// \internal
+/// Lock the mutex, blocking until it is available.
+RCL_LOCAL
+void
+rcl_mutex_lock(rcl_mutex_t * mutex);
+
+/// \internal
+/// Unlock the mutex, which the calling thread locked.
+RCL_LOCAL
+void
+rcl_mutex_unlock(rcl_mutex_t * mutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__MUTEX_H_
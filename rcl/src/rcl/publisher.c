@@ -103,6 +103,11 @@ rcl_publisher_init(
     publisher->impl, "allocating memory failed", ret = RCL_RET_BAD_ALLOC; goto cleanup);
 
   // Fill out implementation struct.
+  publisher->impl->message_pool = NULL;
+  RCL_COUNTER_INIT(publisher->impl->counters.message_count);
+  RCL_COUNTER_INIT(publisher->impl->counters.serialized_message_count);
+  RCL_COUNTER_INIT(publisher->impl->counters.serialized_byte_count);
+  RCL_COUNTER_INIT(publisher->impl->counters.publish_failed_count);
   // rmw handle (create rmw publisher)
   // TODO(wjwwood): pass along the allocator to rmw when it supports it
   publisher->impl->rmw_handle = rmw_create_publisher(
@@ -185,6 +190,7 @@ rcl_publisher_fini(rcl_publisher_t * publisher, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
+    rcl_message_pool_fini(publisher->impl->message_pool);
     allocator.deallocate(publisher->impl, allocator.state);
     publisher->impl = NULL;
   }
@@ -204,6 +210,37 @@ rcl_publisher_get_default_options()
   return default_options;
 }
 
+rcl_ret_t
+rcl_publisher_init_message_pool(
+  const rcl_publisher_t * publisher,
+  size_t message_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  size_t pool_size)
+{
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  if (publisher->impl->message_pool) {
+    RCL_SET_ERROR_MSG("publisher already has a message pool");
+    return RCL_RET_ALREADY_INIT;
+  }
+  if (publisher->impl->rmw_handle->can_loan_messages) {
+    // The middleware loans its own messages, which are used instead.
+    return RCL_RET_OK;
+  }
+  if (0u == pool_size) {
+    pool_size = publisher->impl->actual_qos.depth;
+    if (0u == pool_size) {
+      RCL_SET_ERROR_MSG("pool size must be given when the QoS depth is 0");
+      return RCL_RET_INVALID_ARGUMENT;
+    }
+  }
+  return rcl_message_pool_init(
+    &publisher->impl->message_pool, message_size, init_function, fini_function, pool_size,
+    publisher->impl->options.allocator);
+}
+
 rcl_ret_t
 rcl_borrow_loaned_message(
   const rcl_publisher_t * publisher,
@@ -213,10 +250,36 @@ rcl_borrow_loaned_message(
   if (!rcl_publisher_is_valid(publisher)) {
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
+  rcl_message_pool_t * pool = publisher->impl->message_pool;
+  if (pool) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+    rcl_mutex_lock(pool->mutex);
+    void * message = rcl_message_pool_next(pool);
+    if (message) {
+      rcl_message_pool_lend(pool);
+    }
+    rcl_mutex_unlock(pool->mutex);
+    if (!message) {
+      RCL_SET_ERROR_MSG("every message of the pool is loaned");
+      return RCL_RET_PUBLISHER_MESSAGE_POOL_EXHAUSTED;
+    }
+    *ros_message = message;
+    return RCL_RET_OK;
+  }
   return rcl_convert_rmw_ret_to_rcl_ret(
     rmw_borrow_loaned_message(publisher->impl->rmw_handle, type_support, ros_message));
 }
 
+// Return a message lent by the pool of a publisher, locking the pool.
+static rcl_ret_t
+_rcl_publisher_return_to_pool(rcl_message_pool_t * pool, const void * message)
+{
+  rcl_mutex_lock(pool->mutex);
+  rcl_ret_t ret = rcl_message_pool_return(pool, message);
+  rcl_mutex_unlock(pool->mutex);
+  return ret;
+}
+
 rcl_ret_t
 rcl_return_loaned_message_from_publisher(
   const rcl_publisher_t * publisher,
@@ -226,6 +289,9 @@ rcl_return_loaned_message_from_publisher(
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(loaned_message, RCL_RET_INVALID_ARGUMENT);
+  if (publisher->impl->message_pool) {
+    return _rcl_publisher_return_to_pool(publisher->impl->message_pool, loaned_message);
+  }
   return rcl_convert_rmw_ret_to_rcl_ret(
     rmw_return_loaned_message_from_publisher(publisher->impl->rmw_handle, loaned_message));
 }
@@ -244,34 +310,112 @@ rcl_publish(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
   if (rmw_publish(publisher->impl->rmw_handle, ros_message, allocation) != RMW_RET_OK) {
+    RCL_COUNTER_ADD(publisher->impl->counters.publish_failed_count, 1u);
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
+  RCL_COUNTER_ADD(publisher->impl->counters.message_count, 1u);
   return RCL_RET_OK;
 }
 
 rcl_ret_t
-rcl_publish_serialized_message(
+rcl_publish_batch(
   const rcl_publisher_t * publisher,
-  const rcl_serialized_message_t * serialized_message,
+  const void * const * ros_messages,
+  size_t count,
+  size_t * published_count,
   rmw_publisher_allocation_t * allocation)
 {
   if (!rcl_publisher_is_valid(publisher)) {
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
-  RCL_CHECK_ARGUMENT_FOR_NULL(serialized_message, RCL_RET_INVALID_ARGUMENT);
-  rmw_ret_t ret = rmw_publish_serialized_message(
-    publisher->impl->rmw_handle, serialized_message, allocation);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_messages, RCL_RET_INVALID_ARGUMENT);
+  size_t i;
+  for (i = 0u; i < count; ++i) {
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      ros_messages[i], "ros_messages argument contains a null message",
+      return RCL_RET_INVALID_ARGUMENT);
+  }
+  rmw_publisher_t * rmw_handle = publisher->impl->rmw_handle;
+  for (i = 0u; i < count; ++i) {
+    if (rmw_publish(rmw_handle, ros_messages[i], allocation) != RMW_RET_OK) {
+      RCL_COUNTER_ADD(publisher->impl->counters.publish_failed_count, 1u);
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      break;
+    }
+  }
+  RCL_COUNTER_ADD(publisher->impl->counters.message_count, i);
+  if (published_count) {
+    *published_count = i;
+  }
+  return i == count ? RCL_RET_OK : RCL_RET_ERROR;
+}
+
+// Publish a serialized message without checking the arguments.
+static rcl_ret_t
+_rcl_publish_serialized_message(
+  rcl_publisher_impl_t * impl,
+  const rcl_serialized_message_t * serialized_message,
+  rmw_publisher_allocation_t * allocation)
+{
+  rmw_ret_t ret = rmw_publish_serialized_message(impl->rmw_handle, serialized_message, allocation);
   if (ret != RMW_RET_OK) {
+    RCL_COUNTER_ADD(impl->counters.publish_failed_count, 1u);
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     if (ret == RMW_RET_BAD_ALLOC) {
       return RCL_RET_BAD_ALLOC;
     }
     return RCL_RET_ERROR;
   }
+  RCL_COUNTER_ADD(impl->counters.serialized_message_count, 1u);
+  RCL_COUNTER_ADD(impl->counters.serialized_byte_count, serialized_message->buffer_length);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_publish_serialized_message(
+  const rcl_publisher_t * publisher,
+  const rcl_serialized_message_t * serialized_message,
+  rmw_publisher_allocation_t * allocation)
+{
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(serialized_message, RCL_RET_INVALID_ARGUMENT);
+  return _rcl_publish_serialized_message(publisher->impl, serialized_message, allocation);
+}
+
+rcl_ret_t
+rcl_publish_serialized_message_batch(
+  const rcl_publisher_t * publisher,
+  const rcl_serialized_message_t * const * serialized_messages,
+  size_t count,
+  size_t * published_count,
+  rmw_publisher_allocation_t * allocation)
+{
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(serialized_messages, RCL_RET_INVALID_ARGUMENT);
+  size_t i;
+  for (i = 0u; i < count; ++i) {
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      serialized_messages[i], "serialized_messages argument contains a null message",
+      return RCL_RET_INVALID_ARGUMENT);
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  for (i = 0u; i < count; ++i) {
+    ret = _rcl_publish_serialized_message(publisher->impl, serialized_messages[i], allocation);
+    if (ret != RCL_RET_OK) {
+      break;
+    }
+  }
+  if (published_count) {
+    *published_count = i;
+  }
+  return ret;
+}
+
 rcl_ret_t
 rcl_publish_loaned_message(
   const rcl_publisher_t * publisher,
@@ -282,11 +426,30 @@ rcl_publish_loaned_message(
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
-  rmw_ret_t ret = rmw_publish_loaned_message(publisher->impl->rmw_handle, ros_message, allocation);
+  rcl_publisher_impl_t * impl = publisher->impl;
+  rmw_ret_t ret;
+  if (impl->message_pool) {
+    // Only a message loaned by the pool is published, which can be loaned again right away.
+    // It stays lent while it is published, so the pool is not locked meanwhile.
+    rcl_mutex_lock(impl->message_pool->mutex);
+    rcl_ret_t pool_ret = rcl_message_pool_check_lent(impl->message_pool, ros_message);
+    rcl_mutex_unlock(impl->message_pool->mutex);
+    if (pool_ret != RCL_RET_OK) {
+      return pool_ret;  // The error message is already set.
+    }
+    ret = rmw_publish(impl->rmw_handle, ros_message, allocation);
+  } else {
+    ret = rmw_publish_loaned_message(impl->rmw_handle, ros_message, allocation);
+  }
   if (ret != RMW_RET_OK) {
+    RCL_COUNTER_ADD(impl->counters.publish_failed_count, 1u);
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
+  RCL_COUNTER_ADD(impl->counters.message_count, 1u);
+  if (impl->message_pool) {
+    return _rcl_publisher_return_to_pool(impl->message_pool, ros_message);
+  }
   return RCL_RET_OK;
 }
 
@@ -405,6 +568,37 @@ rcl_publisher_can_loan_messages(const rcl_publisher_t * publisher)
   return publisher->impl->rmw_handle->can_loan_messages;
 }
 
+bool
+rcl_publisher_has_message_pool(const rcl_publisher_t * publisher)
+{
+  if (!rcl_publisher_is_valid(publisher)) {
+    return false;  // error message already set
+  }
+  return NULL != publisher->impl->message_pool;
+}
+
+rcl_ret_t
+rcl_publisher_get_statistics(
+  const rcl_publisher_t * publisher,
+  rcl_publisher_statistics_t * statistics)
+{
+  if (!rcl_publisher_is_valid(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_publisher_counters_t * counters = &publisher->impl->counters;
+  statistics->message_count = RCL_COUNTER_LOAD(counters->message_count);
+  statistics->serialized_message_count = RCL_COUNTER_LOAD(counters->serialized_message_count);
+  statistics->serialized_byte_count = RCL_COUNTER_LOAD(counters->serialized_byte_count);
+  statistics->publish_failed_count = RCL_COUNTER_LOAD(counters->publish_failed_count);
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
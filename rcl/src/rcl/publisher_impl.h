@@ -19,12 +19,18 @@
 
 #include "rcl/publisher.h"
 
+#include "./counters.h"
+#include "./message_pool.h"
+
 typedef struct rcl_publisher_impl_t
 {
   rcl_publisher_options_t options;
   rmw_qos_profile_t actual_qos;
   rcl_context_t * context;
   rmw_publisher_t * rmw_handle;
+  // backs loaned messages when the rmw publisher cannot loan, NULL if unused
+  rcl_message_pool_t * message_pool;
+  rcl_publisher_counters_t counters;
 } rcl_publisher_impl_t;
 
 #endif  // RCL__PUBLISHER_IMPL_H_
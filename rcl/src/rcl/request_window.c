@@ -0,0 +1,259 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./request_window.h"
+
+#include <string.h>
+
+#include "rcl/error_handling.h"
+
+// Finalize the first initialized_count responses of a window and deallocate it.
+static void
+_rcl_request_window_destroy(rcl_request_window_t * window, size_t initialized_count)
+{
+  rcl_allocator_t allocator = window->allocator;
+  size_t i;
+  for (i = 0u; i < initialized_count; ++i) {
+    window->fini_function(window->responses + i * window->response_size);
+  }
+  allocator.deallocate(window->responses, allocator.state);
+  allocator.deallocate(window->slots, allocator.state);
+  rcl_mutex_fini(window->mutex);
+  allocator.deallocate(window, allocator.state);
+}
+
+static size_t
+_rcl_request_window_index(const rcl_request_window_t * window, int64_t sequence_number)
+{
+  return (size_t)((uint64_t)sequence_number & (uint64_t)(window->capacity - 1u));
+}
+
+rcl_ret_t
+rcl_request_window_init(
+  rcl_request_window_t ** window,
+  size_t window_size,
+  size_t response_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(window, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_function, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(fini_function, RCL_RET_INVALID_ARGUMENT);
+  if (0u == window_size || 0u == response_size) {
+    RCL_SET_ERROR_MSG("window size and response size must be non-zero");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  size_t capacity = 1u;
+  while (capacity < window_size && capacity <= SIZE_MAX / 2u) {
+    capacity *= 2u;
+  }
+  if (capacity < window_size || capacity >= SIZE_MAX / response_size ||
+    capacity > SIZE_MAX / sizeof(rcl_request_slot_t))
+  {
+    RCL_SET_ERROR_MSG("request window size overflows");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_request_window_t * new_window = (rcl_request_window_t *)allocator.zero_allocate(
+    1u, sizeof(rcl_request_window_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(new_window, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  new_window->response_size = response_size;
+  new_window->capacity = capacity;
+  new_window->window_size = window_size;
+  new_window->request_timeout = -1;
+  new_window->earliest_deadline = INT64_MAX;
+  new_window->fini_function = fini_function;
+  new_window->allocator = allocator;
+  new_window->slots = (rcl_request_slot_t *)allocator.zero_allocate(
+    capacity, sizeof(rcl_request_slot_t), allocator.state);
+  new_window->responses = (char *)allocator.zero_allocate(
+    capacity + 1u, response_size, allocator.state);
+  if (!new_window->slots || !new_window->responses) {
+    _rcl_request_window_destroy(new_window, 0u);
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  rcl_ret_t ret = rcl_mutex_init(&new_window->mutex, allocator);
+  if (RCL_RET_OK != ret) {
+    _rcl_request_window_destroy(new_window, 0u);
+    return ret;  // error already set
+  }
+  size_t i;
+  for (i = 0u; i <= capacity; ++i) {
+    if (!init_function(new_window->responses + i * response_size)) {
+      _rcl_request_window_destroy(new_window, i);
+      RCL_SET_ERROR_MSG("initializing a response of the request window failed");
+      return RCL_RET_ERROR;
+    }
+  }
+  *window = new_window;
+  return RCL_RET_OK;
+}
+
+void
+rcl_request_window_fini(rcl_request_window_t * window)
+{
+  if (window) {
+    _rcl_request_window_destroy(window, window->capacity + 1u);
+  }
+}
+
+bool
+rcl_request_window_has_room(const rcl_request_window_t * window, int64_t sequence_number)
+{
+  return window->in_flight_count < window->window_size &&
+         !window->slots[_rcl_request_window_index(window, sequence_number)].in_flight;
+}
+
+void
+rcl_request_window_track(
+  rcl_request_window_t * window,
+  int64_t sequence_number,
+  int64_t deadline)
+{
+  rcl_request_slot_t * slot = &window->slots[_rcl_request_window_index(window, sequence_number)];
+  slot->sequence_number = sequence_number;
+  slot->in_flight = true;
+  slot->has_response = false;
+  slot->deadline = INT64_MAX;
+  ++window->in_flight_count;
+  rcl_request_window_set_deadline(window, slot, deadline);
+}
+
+rcl_request_slot_t *
+rcl_request_window_find(const rcl_request_window_t * window, int64_t sequence_number)
+{
+  rcl_request_slot_t * slot = &window->slots[_rcl_request_window_index(window, sequence_number)];
+  if (!slot->in_flight || slot->sequence_number != sequence_number) {
+    return NULL;
+  }
+  return slot;
+}
+
+void
+rcl_request_window_keep_response(
+  rcl_request_window_t * window,
+  rcl_request_slot_t * slot,
+  const rmw_service_info_t * response_header)
+{
+  slot->response_header = *response_header;
+  slot->has_response = true;
+  ++window->kept_response_count;
+}
+
+void
+rcl_request_window_release(rcl_request_window_t * window, rcl_request_slot_t * slot)
+{
+  if (slot->deadline == window->earliest_deadline && INT64_MAX != slot->deadline) {
+    window->earliest_deadline_stale = true;
+  }
+  if (slot->has_response) {
+    --window->kept_response_count;
+  }
+  slot->in_flight = false;
+  slot->has_response = false;
+  --window->in_flight_count;
+}
+
+void
+rcl_request_window_set_deadline(
+  rcl_request_window_t * window,
+  rcl_request_slot_t * slot,
+  int64_t deadline)
+{
+  if (slot->deadline == window->earliest_deadline && deadline > slot->deadline) {
+    window->earliest_deadline_stale = true;
+  }
+  slot->deadline = deadline;
+  if (deadline < window->earliest_deadline) {
+    window->earliest_deadline = deadline;
+  }
+}
+
+int64_t
+rcl_request_window_get_earliest_deadline(rcl_request_window_t * window)
+{
+  if (window->earliest_deadline_stale) {
+    int64_t earliest_deadline = INT64_MAX;
+    size_t i;
+    for (i = 0u; i < window->capacity; ++i) {
+      const rcl_request_slot_t * slot = &window->slots[i];
+      if (slot->in_flight && slot->deadline < earliest_deadline) {
+        earliest_deadline = slot->deadline;
+      }
+    }
+    window->earliest_deadline = earliest_deadline;
+    window->earliest_deadline_stale = false;
+  }
+  return window->earliest_deadline;
+}
+
+int64_t
+rcl_request_window_get_ready_time(rcl_request_window_t * window)
+{
+  if (window->kept_response_count > 0u) {
+    return INT64_MIN;
+  }
+  return rcl_request_window_get_earliest_deadline(window);
+}
+
+rcl_request_slot_t *
+rcl_request_window_find_expired(rcl_request_window_t * window, int64_t now, size_t * cursor)
+{
+  // Only the first search of a pass can rely on the earliest deadline.
+  if (0u == *cursor && rcl_request_window_get_earliest_deadline(window) > now) {
+    return NULL;
+  }
+  for (; *cursor < window->capacity; ++*cursor) {
+    rcl_request_slot_t * slot = &window->slots[*cursor];
+    if (slot->in_flight && slot->deadline <= now) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+void *
+rcl_request_window_response(const rcl_request_window_t * window, const rcl_request_slot_t * slot)
+{
+  const size_t index = slot ? (size_t)(slot - window->slots) : window->capacity;
+  return window->responses + index * window->response_size;
+}
+
+void
+rcl_request_window_swap(const rcl_request_window_t * window, void * a, void * b)
+{
+  char * first = (char *)a;
+  char * second = (char *)b;
+  char chunk[64];
+  size_t remaining = window->response_size;
+  while (remaining > 0u) {
+    const size_t size = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+    memcpy(chunk, first, size);
+    memcpy(first, second, size);
+    memcpy(second, chunk, size);
+    first += size;
+    second += size;
+    remaining -= size;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
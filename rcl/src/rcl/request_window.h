@@ -0,0 +1,205 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__REQUEST_WINDOW_H_
+#define RCL__REQUEST_WINDOW_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/macros.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rmw/types.h"
+
+#include "./mutex.h"
+
+/// \internal
+/// A request of a client which is in flight, see rcl_request_window_t.
+typedef struct rcl_request_slot_t
+{
+  int64_t sequence_number;
+  bool in_flight;
+  // whether the response arrived and is kept in the response of the slot
+  bool has_response;
+  rmw_service_info_t response_header;
+  // steady time after which the request expires, INT64_MAX if never
+  int64_t deadline;
+} rcl_request_slot_t;
+
+/// \internal
+/// Bounded set of the requests of a client which are in flight.
+/**
+ * The slot of a request is indexed by its sequence number modulo the power of
+ * two capacity, which is at least the window size.
+ * Middlewares number the requests of a client consecutively, so a request can
+ * be sent as long as fewer than `window_size` requests are in flight and the
+ * slot of the next sequence number is free.
+ *
+ * Each slot has a preallocated response, initialized once, where a response
+ * taken while looking for another one is kept until it is asked for.
+ * Responses are handed out by swapping their bytes with the message of the
+ * caller, which keeps the ownership of every message's memory where it is.
+ * One more response serves as scratch space for takes.
+ *
+ * The earliest deadline of the requests in flight is cached, so that waiting
+ * on the client only scans the slots after that request left the window or
+ * its deadline moved later.
+ *
+ * The functions below do not lock, their callers hold the mutex of the window
+ * around them, as a client is used from several threads.
+ */
+typedef struct rcl_request_window_t
+{
+  // capacity slots, indexed by sequence number & (capacity - 1)
+  rcl_request_slot_t * slots;
+  // capacity + 1 responses of response_size bytes each, the last one is the scratch
+  char * responses;
+  size_t response_size;
+  size_t capacity;
+  size_t window_size;
+  size_t in_flight_count;
+  // number of requests in flight whose response is kept
+  size_t kept_response_count;
+  // timeout of the requests sent from now on, negative if they never expire
+  int64_t request_timeout;
+  int64_t earliest_deadline;
+  bool earliest_deadline_stale;
+  rcl_message_fini_function_t fini_function;
+  rcl_allocator_t allocator;
+  // guards the rest of the window
+  rcl_mutex_t * mutex;
+} rcl_request_window_t;
+
+/// \internal
+/// Create a window of `window_size` requests whose responses are initialized with `init_function`.
+/**
+ * \return `RCL_RET_OK` if the window was created, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if a response failed to initialize.
+ */
+RCL_LOCAL
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_request_window_init(
+  rcl_request_window_t ** window,
+  size_t window_size,
+  size_t response_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  rcl_allocator_t allocator);
+
+/// \internal
+/// Finalize every response of the window and destroy it.
+RCL_LOCAL
+void
+rcl_request_window_fini(rcl_request_window_t * window);
+
+/// \internal
+/// Check whether a request with the given sequence number can be tracked.
+RCL_LOCAL
+bool
+rcl_request_window_has_room(const rcl_request_window_t * window, int64_t sequence_number);
+
+/// \internal
+/// Track a request, which must have room, as in flight until `deadline`.
+RCL_LOCAL
+void
+rcl_request_window_track(
+  rcl_request_window_t * window,
+  int64_t sequence_number,
+  int64_t deadline);
+
+/// \internal
+/// Return the slot of a request in flight, or `NULL` if it is not.
+RCL_LOCAL
+rcl_request_slot_t *
+rcl_request_window_find(const rcl_request_window_t * window, int64_t sequence_number);
+
+/// \internal
+/// Keep the response in the slot of a request in flight, whose bytes are already in place.
+RCL_LOCAL
+void
+rcl_request_window_keep_response(
+  rcl_request_window_t * window,
+  rcl_request_slot_t * slot,
+  const rmw_service_info_t * response_header);
+
+/// \internal
+/// Stop tracking the request of a slot.
+RCL_LOCAL
+void
+rcl_request_window_release(rcl_request_window_t * window, rcl_request_slot_t * slot);
+
+/// \internal
+/// Move the deadline of the request of a slot, `INT64_MAX` if it never expires.
+RCL_LOCAL
+void
+rcl_request_window_set_deadline(
+  rcl_request_window_t * window,
+  rcl_request_slot_t * slot,
+  int64_t deadline);
+
+/// \internal
+/// Return the earliest deadline of the requests in flight, `INT64_MAX` if none expires.
+RCL_LOCAL
+int64_t
+rcl_request_window_get_earliest_deadline(rcl_request_window_t * window);
+
+/// \internal
+/// Return the steady time from which the client is ready without a new response arriving.
+/**
+ * That is `INT64_MIN` while a response is kept, which can be taken right away,
+ * or else the earliest deadline of the requests in flight.
+ */
+RCL_LOCAL
+int64_t
+rcl_request_window_get_ready_time(rcl_request_window_t * window);
+
+/// \internal
+/// Return the slot of a request in flight which expired at `now`, or `NULL` if none.
+/**
+ * The slots are searched from `cursor`, which is left at the returned slot,
+ * so that starting from 0 and releasing each slot returned finds every
+ * expired request in one pass.
+ */
+RCL_LOCAL
+rcl_request_slot_t *
+rcl_request_window_find_expired(rcl_request_window_t * window, int64_t now, size_t * cursor);
+
+/// \internal
+/// Return the response kept by a slot, or the scratch response if `slot` is `NULL`.
+RCL_LOCAL
+void *
+rcl_request_window_response(const rcl_request_window_t * window, const rcl_request_slot_t * slot);
+
+/// \internal
+/// Swap the bytes of two responses of the window's type.
+RCL_LOCAL
+void
+rcl_request_window_swap(const rcl_request_window_t * window, void * a, void * b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__REQUEST_WINDOW_H_
@@ -30,11 +30,7 @@ extern "C"
 #include "rmw/rmw.h"
 #include "tracetools/tracetools.h"
 
-typedef struct rcl_service_impl_t
-{
-  rcl_service_options_t options;
-  rmw_service_t * rmw_handle;
-} rcl_service_impl_t;
+#include "./service_impl.h"
 
 rcl_service_t
 rcl_get_zero_initialized_service()
@@ -124,6 +120,9 @@ rcl_service_init(
   }
   // options
   service->impl->options = *options;
+  atomic_init(RCL_ATOMIC_UINT64(service->impl->take_failed_count), 0);
+  RCL_COUNTER_INIT(service->impl->counters.request_count);
+  RCL_COUNTER_INIT(service->impl->counters.response_count);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service initialized");
   ret = RCL_RET_OK;
   TRACEPOINT(
@@ -248,8 +247,10 @@ rcl_take_request_with_info(
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Service take request succeeded: %s", taken ? "true" : "false");
   if (!taken) {
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(service->impl->take_failed_count), 1);
     return RCL_RET_SERVICE_TAKE_FAILED;
   }
+  RCL_COUNTER_ADD(service->impl->counters.request_count, 1u);
   return RCL_RET_OK;
 }
 
@@ -287,9 +288,91 @@ rcl_send_response(
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
+  RCL_COUNTER_ADD(service->impl->counters.response_count, 1u);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_take_requests(
+  const rcl_service_t * service,
+  size_t count,
+  rmw_service_info_t * request_headers,
+  void * const * ros_requests,
+  size_t * taken_count)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service server taking service requests");
+  if (!rcl_service_is_valid(service)) {
+    return RCL_RET_SERVICE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(request_headers, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_requests, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(taken_count, RCL_RET_INVALID_ARGUMENT);
+  size_t i;
+  for (i = 0u; i < count; ++i) {
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      ros_requests[i], "ros_requests argument contains a null request",
+      return RCL_RET_INVALID_ARGUMENT);
+  }
+  rmw_service_t * rmw_handle = service->impl->rmw_handle;
+  rcl_ret_t ret = RCL_RET_OK;
+  for (i = 0u; i < count; ++i) {
+    bool taken = false;
+    rmw_ret_t rmw_ret = rmw_take_request(rmw_handle, &request_headers[i], ros_requests[i], &taken);
+    if (RMW_RET_OK != rmw_ret) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      ret = RMW_RET_BAD_ALLOC == rmw_ret ? RCL_RET_BAD_ALLOC : RCL_RET_ERROR;
+      break;
+    }
+    if (!taken) {
+      rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(service->impl->take_failed_count), 1);
+      break;
+    }
+  }
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service took %zu requests", i);
+  RCL_COUNTER_ADD(service->impl->counters.request_count, i);
+  *taken_count = i;
+  if (RCL_RET_OK == ret && 0u == i && count > 0u) {
+    return RCL_RET_SERVICE_TAKE_FAILED;
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_send_responses(
+  const rcl_service_t * service,
+  size_t count,
+  rmw_service_info_t * request_headers,
+  void * const * ros_responses,
+  size_t * sent_count)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Sending service responses");
+  if (!rcl_service_is_valid(service)) {
+    return RCL_RET_SERVICE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(request_headers, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_responses, RCL_RET_INVALID_ARGUMENT);
+  size_t i;
+  for (i = 0u; i < count; ++i) {
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      ros_responses[i], "ros_responses argument contains a null response",
+      return RCL_RET_INVALID_ARGUMENT);
+  }
+  rmw_service_t * rmw_handle = service->impl->rmw_handle;
+  for (i = 0u; i < count; ++i) {
+    if (rmw_send_response(
+        rmw_handle, &request_headers[i].request_id, ros_responses[i]) != RMW_RET_OK)
+    {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      break;
+    }
+  }
+  RCL_COUNTER_ADD(service->impl->counters.response_count, i);
+  if (sent_count) {
+    *sent_count = i;
+  }
+  return i == count ? RCL_RET_OK : RCL_RET_ERROR;
+}
+
 bool
 rcl_service_is_valid(const rcl_service_t * service)
 {
@@ -301,6 +384,26 @@ rcl_service_is_valid(const rcl_service_t * service)
   return true;
 }
 
+rcl_ret_t
+rcl_service_get_statistics(const rcl_service_t * service, rcl_service_statistics_t * statistics)
+{
+  if (!rcl_service_is_valid(service)) {
+    return RCL_RET_SERVICE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_service_counters_t * counters = &service->impl->counters;
+  statistics->request_count = RCL_COUNTER_LOAD(counters->request_count);
+  statistics->response_count = RCL_COUNTER_LOAD(counters->response_count);
+  statistics->take_failed_count =
+    rcutils_atomic_load_uint64_t(RCL_ATOMIC_UINT64(service->impl->take_failed_count));
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
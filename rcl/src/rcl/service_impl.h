@@ -0,0 +1,34 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__SERVICE_IMPL_H_
+#define RCL__SERVICE_IMPL_H_
+
+#include "rmw/rmw.h"
+
+#include "rcl/service.h"
+
+#include "./atomic_storage.h"
+#include "./counters.h"
+
+typedef struct rcl_service_impl_t
+{
+  rcl_service_options_t options;
+  rmw_service_t * rmw_handle;
+  // number of takes which found no request, used by edge triggered wait sets
+  rcl_atomic_storage_t take_failed_count;
+  rcl_service_counters_t counters;
+} rcl_service_impl_t;
+
+#endif  // RCL__SERVICE_IMPL_H_
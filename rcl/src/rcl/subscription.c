@@ -19,11 +19,14 @@ extern "C"
 
 #include "rcl/subscription.h"
 
+#include <inttypes.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include "rcl/error_handling.h"
 #include "rcl/node.h"
 #include "rcutils/logging_macros.h"
+#include "rcutils/time.h"
 #include "rmw/error_handling.h"
 #include "rmw/validate_full_topic_name.h"
 #include "tracetools/tracetools.h"
@@ -117,6 +120,11 @@ rcl_subscription_init(
     options->qos.avoid_ros_namespace_conventions;
   // options
   subscription->impl->options = *options;
+  atomic_init(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count), 0);
+  RCL_COUNTER_INIT(subscription->impl->counters.message_count);
+  RCL_COUNTER_INIT(subscription->impl->counters.serialized_message_count);
+  RCL_COUNTER_INIT(subscription->impl->counters.serialized_byte_count);
+  subscription->impl->message_pool = NULL;
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription initialized");
   ret = RCL_RET_OK;
   TRACEPOINT(
@@ -174,6 +182,7 @@ rcl_subscription_fini(rcl_subscription_t * subscription, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
+    rcl_message_pool_fini(subscription->impl->message_pool);
     allocator.deallocate(subscription->impl, allocator.state);
     subscription->impl = NULL;
   }
@@ -193,6 +202,38 @@ rcl_subscription_get_default_options()
   return default_options;
 }
 
+// Take a message without checking the arguments.
+static rcl_ret_t
+_rcl_take(
+  const rcl_subscription_t * subscription,
+  void * ros_message,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  bool taken = false;
+  rmw_ret_t ret;
+  if (message_info) {
+    *message_info = rmw_get_zero_initialized_message_info();
+    ret = rmw_take_with_info(
+      subscription->impl->rmw_handle, ros_message, &taken, message_info, allocation);
+  } else {
+    // Nothing to fill in, so no message info is initialized and passed.
+    ret = rmw_take(subscription->impl->rmw_handle, ros_message, &taken, allocation);
+  }
+  if (ret != RMW_RET_OK) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return rcl_convert_rmw_ret_to_rcl_ret(ret);
+  }
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Subscription take succeeded: %s", taken ? "true" : "false");
+  if (!taken) {
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count), 1);
+    return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
+  }
+  RCL_COUNTER_ADD(subscription->impl->counters.message_count, 1u);
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_take(
   const rcl_subscription_t * subscription,
@@ -206,25 +247,138 @@ rcl_take(
     return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+  return _rcl_take(subscription, ros_message, message_info, allocation);
+}
 
-  // If message_info is NULL, use a place holder which can be discarded.
-  rmw_message_info_t dummy_message_info;
-  rmw_message_info_t * message_info_local = message_info ? message_info : &dummy_message_info;
-  *message_info_local = rmw_get_zero_initialized_message_info();
-  // Call rmw_take_with_info.
-  bool taken = false;
-  rmw_ret_t ret = rmw_take_with_info(
-    subscription->impl->rmw_handle, ros_message, &taken, message_info_local, allocation);
-  if (ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    return rcl_convert_rmw_ret_to_rcl_ret(ret);
+rcl_ret_t
+rcl_take_many(
+  const rcl_subscription_t * const * subscriptions,
+  void * const * ros_messages,
+  rmw_message_info_t * message_infos,
+  size_t count,
+  rcl_ret_t * results,
+  size_t * taken_count)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Taking from %zu subscriptions", count);
+  RCL_CHECK_ARGUMENT_FOR_NULL(subscriptions, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_messages, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(results, RCL_RET_INVALID_ARGUMENT);
+  size_t taken = 0u;
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t i;
+  // Stop at the first error, so that the error state describes it.
+  for (i = 0u; i < count && RCL_RET_OK == ret; ++i) {
+    const rcl_subscription_t * subscription = subscriptions[i];
+    if (!subscription) {
+      results[i] = RCL_RET_SUBSCRIPTION_TAKE_FAILED;  // Not ready, skipped.
+      continue;
+    }
+    if (!subscription->impl || !subscription->impl->rmw_handle) {
+      RCL_SET_ERROR_MSG("subscription is invalid");
+      results[i] = RCL_RET_SUBSCRIPTION_INVALID;
+      ret = RCL_RET_SUBSCRIPTION_INVALID;
+      continue;
+    }
+    if (!ros_messages[i]) {
+      RCL_SET_ERROR_MSG("ros_message argument is null");
+      results[i] = RCL_RET_INVALID_ARGUMENT;
+      ret = RCL_RET_INVALID_ARGUMENT;
+      continue;
+    }
+    results[i] = _rcl_take(
+      subscription, ros_messages[i], message_infos ? &message_infos[i] : NULL, NULL);
+    if (RCL_RET_OK == results[i]) {
+      ++taken;
+    } else if (RCL_RET_SUBSCRIPTION_TAKE_FAILED != results[i]) {
+      ret = results[i];  // The error message is already set.
+    }
   }
-  RCUTILS_LOG_DEBUG_NAMED(
-    ROS_PACKAGE_NAME, "Subscription take succeeded: %s", taken ? "true" : "false");
-  if (!taken) {
-    return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
+  if (taken_count) {
+    *taken_count = taken;
   }
-  return RCL_RET_OK;
+  return ret;
+}
+
+rcl_ret_t
+rcl_subscription_init_message_pool(
+  const rcl_subscription_t * subscription,
+  size_t message_size,
+  rcl_message_init_function_t init_function,
+  rcl_message_fini_function_t fini_function,
+  size_t pool_size)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
+  }
+  if (subscription->impl->message_pool) {
+    RCL_SET_ERROR_MSG("subscription already has a message pool");
+    return RCL_RET_ALREADY_INIT;
+  }
+  if (0u == pool_size) {
+    pool_size = subscription->impl->actual_qos.depth;
+    if (0u == pool_size) {
+      RCL_SET_ERROR_MSG("pool size must be given when the QoS depth is 0");
+      return RCL_RET_INVALID_ARGUMENT;
+    }
+  }
+  return rcl_message_pool_init(
+    &subscription->impl->message_pool, message_size, init_function, fini_function, pool_size,
+    subscription->impl->options.allocator);
+}
+
+rcl_ret_t
+rcl_take_into_pool(
+  const rcl_subscription_t * subscription,
+  void ** ros_message,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription taking message into pool");
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+  rcl_message_pool_t * pool = subscription->impl->message_pool;
+  if (!pool) {
+    RCL_SET_ERROR_MSG("subscription has no message pool");
+    return RCL_RET_NOT_INIT;
+  }
+  // The pool stays locked while taking, so that the message taken into is not lent meanwhile.
+  rcl_mutex_lock(pool->mutex);
+  void * message = rcl_message_pool_next(pool);
+  if (!message) {
+    rcl_mutex_unlock(pool->mutex);
+    RCL_SET_ERROR_MSG("every message of the pool is borrowed");
+    return RCL_RET_SUBSCRIPTION_MESSAGE_POOL_EXHAUSTED;
+  }
+  rcl_ret_t ret = _rcl_take(subscription, message, message_info, allocation);
+  if (ret == RCL_RET_OK) {
+    rcl_message_pool_lend(pool);
+    *ros_message = message;
+  }
+  // Otherwise the message stays free.
+  rcl_mutex_unlock(pool->mutex);
+  return ret;
+}
+
+rcl_ret_t
+rcl_return_message_to_pool(
+  const rcl_subscription_t * subscription,
+  void * ros_message)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+  if (!subscription->impl->message_pool) {
+    RCL_SET_ERROR_MSG("subscription has no message pool");
+    return RCL_RET_NOT_INIT;
+  }
+  rcl_message_pool_t * pool = subscription->impl->message_pool;
+  rcl_mutex_lock(pool->mutex);
+  rcl_ret_t ret = rcl_message_pool_return(pool, ros_message);
+  rcl_mutex_unlock(pool->mutex);
+  return ret;
 }
 
 rcl_ret_t
@@ -268,6 +422,100 @@ rcl_take_sequence(
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription took %zu messages", taken);
   if (0u == taken) {
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count), 1);
+    return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
+  }
+  RCL_COUNTER_ADD(subscription->impl->counters.message_count, taken);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_take_sequence_with_budget(
+  const rcl_subscription_t * subscription,
+  size_t count,
+  int64_t budget,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  bool * drained,
+  rmw_subscription_allocation_t * allocation)
+{
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Subscription taking up to %zu messages within %" PRId64 "ns",
+    count, budget);
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(message_sequence, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(message_info_sequence, RCL_RET_INVALID_ARGUMENT);
+  if (budget < 0) {
+    RCL_SET_ERROR_MSG("budget must be positive or 0");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (message_sequence->capacity < count) {
+    RCL_SET_ERROR_MSG("Insufficient message sequence capacity for requested count");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (message_info_sequence->capacity < count) {
+    RCL_SET_ERROR_MSG("Insufficient message info sequence capacity for requested count");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcutils_time_point_value_t start;
+  if (rcutils_steady_time_now(&start) != RCUTILS_RET_OK) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+
+  // Set the sizes to zero to indicate that there are no valid messages
+  message_sequence->size = 0u;
+  message_info_sequence->size = 0u;
+  bool is_drained = false;
+  while (message_sequence->size < count) {
+    // Take the next batch into the rest of the sequences.
+    size_t batch_size = count - message_sequence->size;
+    if (batch_size > RCL_TAKE_SEQUENCE_BUDGET_BATCH_SIZE) {
+      batch_size = RCL_TAKE_SEQUENCE_BUDGET_BATCH_SIZE;
+    }
+    rmw_message_sequence_t batch = *message_sequence;
+    batch.data += message_sequence->size;
+    batch.size = 0u;
+    batch.capacity = batch_size;
+    rmw_message_info_sequence_t info_batch = *message_info_sequence;
+    info_batch.data += message_info_sequence->size;
+    info_batch.size = 0u;
+    info_batch.capacity = batch_size;
+    size_t taken = 0u;
+    rmw_ret_t ret = rmw_take_sequence(
+      subscription->impl->rmw_handle, batch_size, &batch, &info_batch, &taken, allocation);
+    if (ret != RMW_RET_OK) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      return rcl_convert_rmw_ret_to_rcl_ret(ret);
+    }
+    message_sequence->size += taken;
+    message_info_sequence->size += taken;
+    if (taken < batch_size) {
+      is_drained = true;
+      break;
+    }
+    rcutils_time_point_value_t now;
+    if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+      RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+      return RCL_RET_ERROR;
+    }
+    if (now - start >= budget) {
+      break;
+    }
+  }
+  if (drained) {
+    *drained = is_drained;
+  }
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Subscription took %zu messages", message_sequence->size);
+  RCL_COUNTER_ADD(subscription->impl->counters.message_count, message_sequence->size);
+  if (is_drained) {
+    // Finding the subscription empty re-arms it in edge triggered wait sets, as a failed take.
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count), 1);
+  }
+  if (0u == message_sequence->size) {
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
   return RCL_RET_OK;
@@ -301,8 +549,12 @@ rcl_take_serialized_message(
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription serialized take succeeded: %s", taken ? "true" : "false");
   if (!taken) {
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count), 1);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_COUNTER_ADD(subscription->impl->counters.serialized_message_count, 1u);
+  RCL_COUNTER_ADD(
+    subscription->impl->counters.serialized_byte_count, serialized_message->buffer_length);
   return RCL_RET_OK;
 }
 
@@ -337,8 +589,10 @@ rcl_take_loaned_message(
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription loaned take succeeded: %s", taken ? "true" : "false");
   if (!taken) {
+    rcutils_atomic_fetch_add_uint64_t(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count), 1);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_COUNTER_ADD(subscription->impl->counters.message_count, 1u);
   return RCL_RET_OK;
 }
 
@@ -437,6 +691,29 @@ rcl_subscription_can_loan_messages(const rcl_subscription_t * subscription)
   return subscription->impl->rmw_handle->can_loan_messages;
 }
 
+rcl_ret_t
+rcl_subscription_get_statistics(
+  const rcl_subscription_t * subscription,
+  rcl_subscription_statistics_t * statistics)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_subscription_counters_t * counters = &subscription->impl->counters;
+  statistics->message_count = RCL_COUNTER_LOAD(counters->message_count);
+  statistics->serialized_message_count = RCL_COUNTER_LOAD(counters->serialized_message_count);
+  statistics->serialized_byte_count = RCL_COUNTER_LOAD(counters->serialized_byte_count);
+  statistics->take_failed_count =
+    rcutils_atomic_load_uint64_t(RCL_ATOMIC_UINT64(subscription->impl->take_failed_count));
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,11 +19,20 @@
 
 #include "rcl/subscription.h"
 
+#include "./atomic_storage.h"
+#include "./counters.h"
+#include "./message_pool.h"
+
 typedef struct rcl_subscription_impl_t
 {
   rcl_subscription_options_t options;
   rmw_qos_profile_t actual_qos;
   rmw_subscription_t * rmw_handle;
+  // number of takes which found no message, used by edge triggered wait sets
+  rcl_atomic_storage_t take_failed_count;
+  // NULL until rcl_subscription_init_message_pool() is called
+  rcl_message_pool_t * message_pool;
+  rcl_subscription_counters_t counters;
 } rcl_subscription_impl_t;
 
 #endif  // RCL__SUBSCRIPTION_IMPL_H_
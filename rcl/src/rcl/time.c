@@ -15,22 +15,78 @@
 #include "rcl/time.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "./common.h"
+#include "./mutex.h"
 #include "rcl/allocator.h"
 #include "rcl/error_handling.h"
+#include "rcl/guard_condition.h"
+#include "rcutils/logging_macros.h"
 #include "rcutils/macros.h"
 #include "rcutils/stdatomic_helper.h"
 #include "rcutils/time.h"
 
-// Internal storage for RCL_ROS_TIME implementation
+// Internal storage for RCL_ROS_TIME implementation, shared by all the clocks attached to it.
 typedef struct rcl_ros_clock_storage_t
 {
   atomic_uint_least64_t current_time;
   bool active;
+  // Expected rate of the overridden time relative to wall time, used to compute wall timeouts.
+  double rate;
+  // Allocator of the storage itself, it may outlive the clock which created it.
+  rcl_allocator_t allocator;
+  // Clocks reading this storage, whose jump callbacks are called when it changes.
+  rcl_clock_t ** clocks;
+  size_t clock_count;
+  size_t clock_capacity;
+  // Guards the clocks, which are attached and detached while the time is set from other threads.
+  rcl_mutex_t * mutex;
 } rcl_ros_clock_storage_t;
 
+// Marks the end of a list of jump callbacks, or an empty hash table slot.
+#define RCL_JUMP_CALLBACK_NONE SIZE_MAX
+// Number of threshold buckets: one for a zero threshold and one per power of two.
+#define RCL_JUMP_THRESHOLD_BUCKETS 64
+
+// Lists a jump callback can be in, one per kind of jump.
+typedef enum rcl_jump_callback_list_t
+{
+  RCL_JUMP_CALLBACK_ON_CLOCK_CHANGE,
+  RCL_JUMP_CALLBACK_ON_FORWARD,
+  RCL_JUMP_CALLBACK_ON_BACKWARD,
+  RCL_JUMP_CALLBACK_LIST_COUNT
+} rcl_jump_callback_list_t;
+
+// Position of a jump callback in the lists it is in.
+typedef struct rcl_jump_callback_links_t
+{
+  size_t prev[RCL_JUMP_CALLBACK_LIST_COUNT];
+  size_t next[RCL_JUMP_CALLBACK_LIST_COUNT];
+} rcl_jump_callback_links_t;
+
+// Lookup structures for the jump callbacks of a clock, which are stored densely in
+// clock->jump_callbacks so they can be added in amortized constant time and removed by moving
+// the last one in their place.
+typedef struct rcl_jump_callback_index_t
+{
+  // Number of callbacks clock->jump_callbacks and links have room for.
+  size_t capacity;
+  // Links of each callback, parallel to clock->jump_callbacks.
+  rcl_jump_callback_links_t * links;
+  // Open addressing hash table of callback indices, keyed by callback and user data.
+  size_t * slots;
+  // Number of slots, a power of two twice the capacity.
+  size_t slot_count;
+  // Callbacks to call on clock changes.
+  size_t clock_change_head;
+  // Callbacks to call on forward (backward) jumps, bucketed by the magnitude of their threshold.
+  size_t forward_heads[RCL_JUMP_THRESHOLD_BUCKETS];
+  size_t backward_heads[RCL_JUMP_THRESHOLD_BUCKETS];
+} rcl_jump_callback_index_t;
+
 // Implementation only
 static rcl_ret_t
 rcl_get_steady_time(void * data, rcl_time_point_value_t * current_time)
@@ -47,6 +103,40 @@ rcl_get_system_time(void * data, rcl_time_point_value_t * current_time)
   return rcutils_system_time_now(current_time);
 }
 
+#if defined(CLOCK_MONOTONIC_COARSE) && defined(CLOCK_REALTIME_COARSE)
+// Coarse clocks are read from the vDSO without a hardware counter read, at tick resolution.
+static rcl_ret_t
+rcl_get_coarse_time(clockid_t clock_id, rcl_time_point_value_t * current_time)
+{
+  struct timespec timespec_now;
+  if (0 != clock_gettime(clock_id, &timespec_now)) {
+    RCL_SET_ERROR_MSG("failed to read coarse clock");
+    return RCL_RET_ERROR;
+  }
+  *current_time = RCUTILS_S_TO_NS((int64_t)timespec_now.tv_sec) + timespec_now.tv_nsec;
+  return RCL_RET_OK;
+}
+
+// Implementation only
+static rcl_ret_t
+rcl_get_coarse_steady_time(void * data, rcl_time_point_value_t * current_time)
+{
+  (void)data;  // unused
+  return rcl_get_coarse_time(CLOCK_MONOTONIC_COARSE, current_time);
+}
+
+// Implementation only
+static rcl_ret_t
+rcl_get_coarse_system_time(void * data, rcl_time_point_value_t * current_time)
+{
+  (void)data;  // unused
+  return rcl_get_coarse_time(CLOCK_REALTIME_COARSE, current_time);
+}
+#define RCL_HAS_COARSE_TIME 1
+#else
+#define RCL_HAS_COARSE_TIME 0
+#endif
+
 // Internal method for zeroing values on init, assumes clock is valid
 static void
 rcl_init_generic_clock(rcl_clock_t * clock, rcl_allocator_t * allocator)
@@ -57,6 +147,8 @@ rcl_init_generic_clock(rcl_clock_t * clock, rcl_allocator_t * allocator)
   clock->get_now = NULL;
   clock->data = NULL;
   clock->allocator = *allocator;
+  clock->jump_callback_index = NULL;
+  clock->timer_guard_condition = NULL;
 }
 
 // The function used to get the current ros time.
@@ -111,10 +203,22 @@ rcl_clock_generic_fini(
   rcl_clock_t * clock)
 {
   // Internal function; assume caller has already checked that clock is valid.
-  if (clock->num_jump_callbacks > 0) {
-    clock->num_jump_callbacks = 0;
-    clock->allocator.deallocate(clock->jump_callbacks, clock->allocator.state);
-    clock->jump_callbacks = NULL;
+  clock->num_jump_callbacks = 0;
+  clock->allocator.deallocate(clock->jump_callbacks, clock->allocator.state);
+  clock->jump_callbacks = NULL;
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  if (NULL != index) {
+    clock->allocator.deallocate(index->links, clock->allocator.state);
+    clock->allocator.deallocate(index->slots, clock->allocator.state);
+    clock->allocator.deallocate(index, clock->allocator.state);
+    clock->jump_callback_index = NULL;
+  }
+  if (NULL != clock->timer_guard_condition) {
+    if (RCL_RET_OK != rcl_guard_condition_fini(clock->timer_guard_condition)) {
+      RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to fini shared timer guard condition");
+    }
+    clock->allocator.deallocate(clock->timer_guard_condition, clock->allocator.state);
+    clock->timer_guard_condition = NULL;
   }
 }
 
@@ -139,6 +243,60 @@ rcl_clock_fini(
   }
 }
 
+// Add a clock to the clocks reading the given storage.
+static rcl_ret_t
+rcl_ros_clock_storage_attach(rcl_ros_clock_storage_t * storage, rcl_clock_t * clock)
+{
+  rcl_ret_t ret = RCL_RET_OK;
+  rcl_mutex_lock(storage->mutex);
+  if (storage->clock_count == storage->clock_capacity) {
+    size_t new_capacity = storage->clock_capacity ? 2u * storage->clock_capacity : 1u;
+    rcl_clock_t ** clocks = storage->allocator.reallocate(
+      storage->clocks, new_capacity * sizeof(rcl_clock_t *), storage->allocator.state);
+    if (NULL == clocks) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      ret = RCL_RET_BAD_ALLOC;
+    } else {
+      storage->clocks = clocks;
+      storage->clock_capacity = new_capacity;
+    }
+  }
+  if (RCL_RET_OK == ret) {
+    storage->clocks[storage->clock_count++] = clock;
+  }
+  rcl_mutex_unlock(storage->mutex);
+  return ret;
+}
+
+// Deallocate a storage which no clock reads anymore.
+static void
+rcl_ros_clock_storage_destroy(rcl_ros_clock_storage_t * storage)
+{
+  rcl_allocator_t allocator = storage->allocator;
+  rcl_mutex_fini(storage->mutex);
+  allocator.deallocate(storage->clocks, allocator.state);
+  allocator.deallocate(storage, allocator.state);
+}
+
+// Remove a clock from the clocks reading the given storage, freeing the storage after the last.
+static void
+rcl_ros_clock_storage_detach(rcl_ros_clock_storage_t * storage, rcl_clock_t * clock)
+{
+  rcl_mutex_lock(storage->mutex);
+  size_t i;
+  for (i = 0u; i < storage->clock_count; ++i) {
+    if (storage->clocks[i] == clock) {
+      storage->clocks[i] = storage->clocks[--(storage->clock_count)];
+      break;
+    }
+  }
+  const bool last = 0u == storage->clock_count;
+  rcl_mutex_unlock(storage->mutex);
+  if (last) {
+    rcl_ros_clock_storage_destroy(storage);
+  }
+}
+
 rcl_ret_t
 rcl_ros_clock_init(
   rcl_clock_t * clock,
@@ -147,16 +305,59 @@ rcl_ros_clock_init(
   RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
   rcl_init_generic_clock(clock, allocator);
-  clock->data = allocator->allocate(sizeof(rcl_ros_clock_storage_t), allocator->state);
-  if (NULL == clock->data) {
+  rcl_ros_clock_storage_t * storage =
+    allocator->allocate(sizeof(rcl_ros_clock_storage_t), allocator->state);
+  if (NULL == storage) {
     RCL_SET_ERROR_MSG("allocating memory failed");
     return RCL_RET_BAD_ALLOC;
   }
-
-  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
   // 0 is a special value meaning time has not been set
   atomic_init(&(storage->current_time), 0);
   storage->active = false;
+  storage->rate = 1.0;
+  storage->allocator = *allocator;
+  storage->clocks = NULL;
+  storage->clock_count = 0u;
+  storage->clock_capacity = 0u;
+  rcl_ret_t ret = rcl_mutex_init(&storage->mutex, *allocator);
+  if (RCL_RET_OK != ret) {
+    allocator->deallocate(storage, allocator->state);
+    return ret;
+  }
+  ret = rcl_ros_clock_storage_attach(storage, clock);
+  if (RCL_RET_OK != ret) {
+    rcl_ros_clock_storage_destroy(storage);
+    return ret;
+  }
+  clock->data = storage;
+  clock->get_now = rcl_get_ros_time;
+  clock->type = RCL_ROS_TIME;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_ros_clock_init_attached(
+  rcl_clock_t * clock,
+  rcl_clock_t * source,
+  rcl_allocator_t * allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(source, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
+  if (source->type != RCL_ROS_TIME) {
+    RCL_SET_ERROR_MSG("source clock not of type RCL_ROS_TIME");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)source->data;
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    storage, "Source clock storage is not initialized, cannot attach.",
+    return RCL_RET_INVALID_ARGUMENT);
+  rcl_init_generic_clock(clock, allocator);
+  rcl_ret_t ret = rcl_ros_clock_storage_attach(storage, clock);
+  if (RCL_RET_OK != ret) {
+    return ret;
+  }
+  clock->data = storage;
   clock->get_now = rcl_get_ros_time;
   clock->type = RCL_ROS_TIME;
   return RCL_RET_OK;
@@ -172,7 +373,9 @@ rcl_ros_clock_fini(
     return RCL_RET_ERROR;
   }
   rcl_clock_generic_fini(clock);
-  clock->allocator.deallocate(clock->data, clock->allocator.state);
+  if (NULL != clock->data) {
+    rcl_ros_clock_storage_detach((rcl_ros_clock_storage_t *)clock->data, clock);
+  }
   clock->data = NULL;
   return RCL_RET_OK;
 }
@@ -264,25 +467,149 @@ rcl_clock_get_now(rcl_clock_t * clock, rcl_time_point_value_t * time_point_value
   return RCL_RET_ERROR;
 }
 
+rcl_ret_t
+rcl_clock_enable_coarse_time(rcl_clock_t * clock)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_clock_valid(clock)) {
+    RCL_SET_ERROR_MSG("clock is not initialized");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+#if RCL_HAS_COARSE_TIME
+  switch (clock->type) {
+    case RCL_STEADY_TIME:
+      clock->get_now = rcl_get_coarse_steady_time;
+      return RCL_RET_OK;
+    case RCL_SYSTEM_TIME:
+      clock->get_now = rcl_get_coarse_system_time;
+      return RCL_RET_OK;
+    default:
+      RCL_SET_ERROR_MSG("coarse time is only supported by steady and system clocks");
+      return RCL_RET_UNSUPPORTED;
+  }
+#else
+  RCL_SET_ERROR_MSG("coarse time is not supported on this platform");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+bool
+rcl_clock_uses_coarse_time(const rcl_clock_t * clock)
+{
+#if RCL_HAS_COARSE_TIME
+  return NULL != clock &&
+         (clock->get_now == rcl_get_coarse_steady_time ||
+         clock->get_now == rcl_get_coarse_system_time);
+#else
+  (void)clock;
+  return false;
+#endif
+}
+
+// Magnitude of a duration, saturated for the most negative one.
+static int64_t
+rcl_duration_magnitude(int64_t nanoseconds)
+{
+  if (nanoseconds >= 0) {
+    return nanoseconds;
+  }
+  return INT64_MIN == nanoseconds ? INT64_MAX : -nanoseconds;
+}
+
+// Bucket of a jump threshold: 0 for a zero threshold, else 1 + floor(log2(magnitude)).
+static size_t
+rcl_jump_threshold_bucket(int64_t magnitude)
+{
+  size_t bucket = 0u;
+  while (magnitude > 0) {
+    ++bucket;
+    magnitude >>= 1;
+  }
+  return bucket;
+}
+
+static size_t *
+rcl_jump_callback_list_head(
+  rcl_jump_callback_index_t * index, const rcl_jump_callback_info_t * info,
+  rcl_jump_callback_list_t list)
+{
+  switch (list) {
+    case RCL_JUMP_CALLBACK_ON_CLOCK_CHANGE:
+      return info->threshold.on_clock_change ? &index->clock_change_head : NULL;
+    case RCL_JUMP_CALLBACK_ON_FORWARD:
+      return &index->forward_heads[
+        rcl_jump_threshold_bucket(info->threshold.min_forward.nanoseconds)];
+    case RCL_JUMP_CALLBACK_ON_BACKWARD:
+      return &index->backward_heads[
+        rcl_jump_threshold_bucket(
+          rcl_duration_magnitude(info->threshold.min_backward.nanoseconds))];
+    default:
+      return NULL;
+  }
+}
+
 static void
 rcl_clock_call_callbacks(
   rcl_clock_t * clock, const rcl_time_jump_t * time_jump, bool before_jump)
 {
   // Internal function; assume parameters are valid.
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  if (NULL == index) {
+    return;
+  }
   bool is_clock_change = time_jump->clock_change == RCL_ROS_TIME_ACTIVATED ||
     time_jump->clock_change == RCL_ROS_TIME_DEACTIVATED;
-  for (size_t cb_idx = 0; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
-    rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
-    if (
-      (is_clock_change && info->threshold.on_clock_change) ||
-      (time_jump->delta.nanoseconds < 0 &&
-      time_jump->delta.nanoseconds <= info->threshold.min_backward.nanoseconds) ||
-      (time_jump->delta.nanoseconds > 0 &&
-      time_jump->delta.nanoseconds >= info->threshold.min_forward.nanoseconds))
+  size_t cb_idx;
+  if (is_clock_change) {
+    for (
+      cb_idx = index->clock_change_head; RCL_JUMP_CALLBACK_NONE != cb_idx;
+      cb_idx = index->links[cb_idx].next[RCL_JUMP_CALLBACK_ON_CLOCK_CHANGE])
     {
+      rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
       info->callback(time_jump, before_jump, info->user_data);
     }
   }
+  const int64_t delta = time_jump->delta.nanoseconds;
+  if (0 == delta) {
+    return;
+  }
+  // Only the buckets of thresholds up to the magnitude of the jump can have been crossed.
+  const bool forward = delta > 0;
+  const rcl_jump_callback_list_t list =
+    forward ? RCL_JUMP_CALLBACK_ON_FORWARD : RCL_JUMP_CALLBACK_ON_BACKWARD;
+  const size_t * heads = forward ? index->forward_heads : index->backward_heads;
+  const size_t last_bucket = rcl_jump_threshold_bucket(rcl_duration_magnitude(delta));
+  size_t bucket;
+  for (bucket = 0u; bucket <= last_bucket; ++bucket) {
+    for (cb_idx = heads[bucket]; RCL_JUMP_CALLBACK_NONE != cb_idx;
+      cb_idx = index->links[cb_idx].next[list])
+    {
+      rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
+      if (is_clock_change && info->threshold.on_clock_change) {
+        continue;  // Already called above.
+      }
+      if (
+        (forward && delta >= info->threshold.min_forward.nanoseconds) ||
+        (!forward && delta <= info->threshold.min_backward.nanoseconds))
+      {
+        info->callback(time_jump, before_jump, info->user_data);
+      }
+    }
+  }
+}
+
+// Call the jump callbacks of every clock reading the given storage.
+static void
+rcl_ros_clock_storage_call_callbacks(
+  rcl_ros_clock_storage_t * storage, const rcl_time_jump_t * time_jump, bool before_jump)
+{
+  // The callbacks run with the clocks locked, so they must not attach or detach clocks.
+  rcl_mutex_lock(storage->mutex);
+  size_t i;
+  for (i = 0u; i < storage->clock_count; ++i) {
+    rcl_clock_call_callbacks(storage->clocks[i], time_jump, before_jump);
+  }
+  rcl_mutex_unlock(storage->mutex);
 }
 
 rcl_ret_t
@@ -300,9 +627,9 @@ rcl_enable_ros_time_override(rcl_clock_t * clock)
     rcl_time_jump_t time_jump;
     time_jump.delta.nanoseconds = 0;
     time_jump.clock_change = RCL_ROS_TIME_ACTIVATED;
-    rcl_clock_call_callbacks(clock, &time_jump, true);
+    rcl_ros_clock_storage_call_callbacks(storage, &time_jump, true);
     storage->active = true;
-    rcl_clock_call_callbacks(clock, &time_jump, false);
+    rcl_ros_clock_storage_call_callbacks(storage, &time_jump, false);
   }
   return RCL_RET_OK;
 }
@@ -322,9 +649,9 @@ rcl_disable_ros_time_override(rcl_clock_t * clock)
     rcl_time_jump_t time_jump;
     time_jump.delta.nanoseconds = 0;
     time_jump.clock_change = RCL_ROS_TIME_DEACTIVATED;
-    rcl_clock_call_callbacks(clock, &time_jump, true);
+    rcl_ros_clock_storage_call_callbacks(storage, &time_jump, true);
     storage->active = false;
-    rcl_clock_call_callbacks(clock, &time_jump, false);
+    rcl_ros_clock_storage_call_callbacks(storage, &time_jump, false);
   }
   return RCL_RET_OK;
 }
@@ -369,15 +696,248 @@ rcl_set_ros_time_override(
       return ret;
     }
     time_jump.delta.nanoseconds = time_value - current_time;
-    rcl_clock_call_callbacks(clock, &time_jump, true);
+    rcl_ros_clock_storage_call_callbacks(storage, &time_jump, true);
     rcutils_atomic_store(&(storage->current_time), time_value);
-    rcl_clock_call_callbacks(clock, &time_jump, false);
+    rcl_ros_clock_storage_call_callbacks(storage, &time_jump, false);
   } else {
     rcutils_atomic_store(&(storage->current_time), time_value);
   }
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_ros_clock_set_rate(
+  rcl_clock_t * clock,
+  double rate)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  if (clock->type != RCL_ROS_TIME) {
+    RCL_SET_ERROR_MSG("Clock is not of type RCL_ROS_TIME, cannot set rate.");
+    return RCL_RET_ERROR;
+  }
+  // Written so that NaN is rejected too.
+  if (!(rate >= RCL_ROS_CLOCK_MIN_RATE && rate <= RCL_ROS_CLOCK_MAX_RATE)) {
+    RCL_SET_ERROR_MSG("rate is out of range");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    storage, "Clock storage is not initialized, cannot set rate.", return RCL_RET_ERROR);
+  storage->rate = rate;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_ros_clock_get_rate(
+  rcl_clock_t * clock,
+  double * rate)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(rate, RCL_RET_INVALID_ARGUMENT);
+  if (clock->type != RCL_ROS_TIME) {
+    RCL_SET_ERROR_MSG("Clock is not of type RCL_ROS_TIME, cannot query rate.");
+    return RCL_RET_ERROR;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    storage, "Clock storage is not initialized, cannot query rate.", return RCL_RET_ERROR);
+  *rate = storage->rate;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_clock_get_wall_duration(
+  rcl_clock_t * clock,
+  rcl_duration_value_t duration,
+  rcl_duration_value_t * wall_duration)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(wall_duration, RCL_RET_INVALID_ARGUMENT);
+  *wall_duration = duration;
+  if (clock->type != RCL_ROS_TIME) {
+    return RCL_RET_OK;
+  }
+  rcl_ros_clock_storage_t * storage = (rcl_ros_clock_storage_t *)clock->data;
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    storage, "Clock storage is not initialized, cannot convert duration.",
+    return RCL_RET_ERROR);
+  if (!storage->active || 1.0 == storage->rate || INT64_MAX == duration) {
+    return RCL_RET_OK;
+  }
+  const double scaled = (double)duration / storage->rate;
+  if (scaled >= (double)INT64_MAX) {
+    *wall_duration = INT64_MAX;
+  } else if (scaled <= (double)INT64_MIN) {
+    *wall_duration = INT64_MIN;
+  } else {
+    *wall_duration = (rcl_duration_value_t)scaled;
+  }
+  return RCL_RET_OK;
+}
+
+static size_t
+rcl_jump_callback_hash(rcl_jump_callback_t callback, void * user_data)
+{
+  uint64_t hash = (uint64_t)(uintptr_t)callback * 0x9E3779B97F4A7C15ull;
+  hash ^= (uint64_t)(uintptr_t)user_data + (hash << 6) + (hash >> 2);
+  hash *= 0xBF58476D1CE4E5B9ull;
+  return (size_t)(hash ^ (hash >> 31));
+}
+
+// Find the hash table slot of a callback, or the empty slot where it would go.
+// Returns RCL_JUMP_CALLBACK_NONE if there is no hash table yet.
+static size_t
+rcl_jump_callback_find_slot(
+  const rcl_clock_t * clock, rcl_jump_callback_t callback, void * user_data)
+{
+  const rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  if (NULL == index || 0u == index->slot_count) {
+    return RCL_JUMP_CALLBACK_NONE;
+  }
+  const size_t mask = index->slot_count - 1;
+  size_t slot = rcl_jump_callback_hash(callback, user_data) & mask;
+  for (;; slot = (slot + 1) & mask) {
+    const size_t cb_idx = index->slots[slot];
+    if (RCL_JUMP_CALLBACK_NONE == cb_idx) {
+      return slot;
+    }
+    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
+    if (info->callback == callback && info->user_data == user_data) {
+      return slot;
+    }
+  }
+}
+
+// Empty a hash table slot, shifting back the callbacks which probed past it.
+static void
+rcl_jump_callback_remove_slot(rcl_clock_t * clock, size_t hole)
+{
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  const size_t mask = index->slot_count - 1;
+  size_t slot = hole;
+  for (;; ) {
+    slot = (slot + 1) & mask;
+    const size_t cb_idx = index->slots[slot];
+    if (RCL_JUMP_CALLBACK_NONE == cb_idx) {
+      break;
+    }
+    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
+    const size_t home = rcl_jump_callback_hash(info->callback, info->user_data) & mask;
+    // The callback can fill the hole unless its home slot lies cyclically in (hole, slot].
+    const bool stays = hole < slot ?
+      (home > hole && home <= slot) : (home > hole || home <= slot);
+    if (!stays) {
+      index->slots[hole] = cb_idx;
+      hole = slot;
+    }
+  }
+  index->slots[hole] = RCL_JUMP_CALLBACK_NONE;
+}
+
+static void
+rcl_jump_callback_link(rcl_clock_t * clock, size_t cb_idx, rcl_jump_callback_list_t list)
+{
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  rcl_jump_callback_links_t * links = &index->links[cb_idx];
+  links->prev[list] = RCL_JUMP_CALLBACK_NONE;
+  links->next[list] = RCL_JUMP_CALLBACK_NONE;
+  size_t * head = rcl_jump_callback_list_head(index, &clock->jump_callbacks[cb_idx], list);
+  if (NULL == head) {
+    return;
+  }
+  links->next[list] = *head;
+  if (RCL_JUMP_CALLBACK_NONE != *head) {
+    index->links[*head].prev[list] = cb_idx;
+  }
+  *head = cb_idx;
+}
+
+static void
+rcl_jump_callback_unlink(rcl_clock_t * clock, size_t cb_idx, rcl_jump_callback_list_t list)
+{
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  size_t * head = rcl_jump_callback_list_head(index, &clock->jump_callbacks[cb_idx], list);
+  if (NULL == head) {
+    return;
+  }
+  const rcl_jump_callback_links_t * links = &index->links[cb_idx];
+  if (RCL_JUMP_CALLBACK_NONE != links->prev[list]) {
+    index->links[links->prev[list]].next[list] = links->next[list];
+  } else {
+    *head = links->next[list];
+  }
+  if (RCL_JUMP_CALLBACK_NONE != links->next[list]) {
+    index->links[links->next[list]].prev[list] = links->prev[list];
+  }
+}
+
+// Make room for the given number of jump callbacks, growing the storage geometrically.
+static rcl_ret_t
+rcl_clock_reserve_jump_callbacks(rcl_clock_t * clock, size_t count)
+{
+  rcl_allocator_t * allocator = &clock->allocator;
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  if (NULL == index) {
+    index = allocator->allocate(sizeof(rcl_jump_callback_index_t), allocator->state);
+    if (NULL == index) {
+      RCL_SET_ERROR_MSG("Failed to allocate jump callback index");
+      return RCL_RET_BAD_ALLOC;
+    }
+    index->capacity = 0u;
+    index->links = NULL;
+    index->slots = NULL;
+    index->slot_count = 0u;
+    index->clock_change_head = RCL_JUMP_CALLBACK_NONE;
+    size_t bucket;
+    for (bucket = 0u; bucket < RCL_JUMP_THRESHOLD_BUCKETS; ++bucket) {
+      index->forward_heads[bucket] = RCL_JUMP_CALLBACK_NONE;
+      index->backward_heads[bucket] = RCL_JUMP_CALLBACK_NONE;
+    }
+    clock->jump_callback_index = index;
+  }
+  if (count <= index->capacity) {
+    return RCL_RET_OK;
+  }
+  size_t capacity = index->capacity ? index->capacity : 2u;
+  while (capacity < count) {
+    capacity *= 2u;
+  }
+  rcl_jump_callback_info_t * callbacks = allocator->reallocate(
+    clock->jump_callbacks, sizeof(rcl_jump_callback_info_t) * capacity, allocator->state);
+  if (NULL == callbacks) {
+    RCL_SET_ERROR_MSG("Failed to realloc jump callbacks");
+    return RCL_RET_BAD_ALLOC;
+  }
+  clock->jump_callbacks = callbacks;
+  rcl_jump_callback_links_t * links = allocator->reallocate(
+    index->links, sizeof(rcl_jump_callback_links_t) * capacity, allocator->state);
+  if (NULL == links) {
+    RCL_SET_ERROR_MSG("Failed to realloc jump callbacks");
+    return RCL_RET_BAD_ALLOC;
+  }
+  index->links = links;
+  size_t * slots = allocator->allocate(sizeof(size_t) * 2u * capacity, allocator->state);
+  if (NULL == slots) {
+    RCL_SET_ERROR_MSG("Failed to realloc jump callbacks");
+    return RCL_RET_BAD_ALLOC;
+  }
+  allocator->deallocate(index->slots, allocator->state);
+  index->slots = slots;
+  index->slot_count = 2u * capacity;
+  index->capacity = capacity;
+  // Rehash
+  size_t slot;
+  for (slot = 0u; slot < index->slot_count; ++slot) {
+    index->slots[slot] = RCL_JUMP_CALLBACK_NONE;
+  }
+  size_t cb_idx;
+  for (cb_idx = 0u; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
+    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
+    index->slots[rcl_jump_callback_find_slot(clock, info->callback, info->user_data)] = cb_idx;
+  }
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_clock_add_jump_callback(
   rcl_clock_t * clock, rcl_jump_threshold_t threshold, rcl_jump_callback_t callback,
@@ -398,26 +958,30 @@ rcl_clock_add_jump_callback(
   }
 
   // Callback/user_data pair must be unique
-  for (size_t cb_idx = 0; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
-    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
-    if (info->callback == callback && info->user_data == user_data) {
-      RCL_SET_ERROR_MSG("callback/user_data are already added to this clock");
-      return RCL_RET_ERROR;
-    }
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  size_t slot = rcl_jump_callback_find_slot(clock, callback, user_data);
+  if (RCL_JUMP_CALLBACK_NONE != slot && RCL_JUMP_CALLBACK_NONE != index->slots[slot]) {
+    RCL_SET_ERROR_MSG("callback/user_data are already added to this clock");
+    return RCL_RET_ERROR;
   }
 
-  // Add the new callback, increasing the size of the callback list
-  rcl_jump_callback_info_t * callbacks = clock->allocator.reallocate(
-    clock->jump_callbacks, sizeof(rcl_jump_callback_info_t) * (clock->num_jump_callbacks + 1),
-    clock->allocator.state);
-  if (NULL == callbacks) {
-    RCL_SET_ERROR_MSG("Failed to realloc jump callbacks");
-    return RCL_RET_BAD_ALLOC;
+  rcl_ret_t ret = rcl_clock_reserve_jump_callbacks(clock, clock->num_jump_callbacks + 1);
+  if (RCL_RET_OK != ret) {
+    return ret;
+  }
+  index = clock->jump_callback_index;
+  slot = rcl_jump_callback_find_slot(clock, callback, user_data);
+
+  // Add the new callback at the end of the callback array
+  const size_t cb_idx = clock->num_jump_callbacks;
+  clock->jump_callbacks[cb_idx].callback = callback;
+  clock->jump_callbacks[cb_idx].threshold = threshold;
+  clock->jump_callbacks[cb_idx].user_data = user_data;
+  index->slots[slot] = cb_idx;
+  int list;
+  for (list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+    rcl_jump_callback_link(clock, cb_idx, (rcl_jump_callback_list_t)list);
   }
-  clock->jump_callbacks = callbacks;
-  clock->jump_callbacks[clock->num_jump_callbacks].callback = callback;
-  clock->jump_callbacks[clock->num_jump_callbacks].threshold = threshold;
-  clock->jump_callbacks[clock->num_jump_callbacks].user_data = user_data;
   ++(clock->num_jump_callbacks);
   return RCL_RET_OK;
 }
@@ -432,34 +996,32 @@ rcl_clock_remove_jump_callback(
     &(clock->allocator), "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(callback, RCL_RET_INVALID_ARGUMENT);
 
-  // Delete callback if found, moving all callbacks after back one
-  bool found_callback = false;
-  for (size_t cb_idx = 0; cb_idx < clock->num_jump_callbacks; ++cb_idx) {
-    const rcl_jump_callback_info_t * info = &(clock->jump_callbacks[cb_idx]);
-    if (found_callback) {
-      clock->jump_callbacks[cb_idx - 1] = *info;
-    } else if (info->callback == callback && info->user_data == user_data) {
-      found_callback = true;
-    }
-  }
-  if (!found_callback) {
+  rcl_jump_callback_index_t * index = clock->jump_callback_index;
+  size_t slot = rcl_jump_callback_find_slot(clock, callback, user_data);
+  if (RCL_JUMP_CALLBACK_NONE == slot || RCL_JUMP_CALLBACK_NONE == index->slots[slot]) {
     RCL_SET_ERROR_MSG("jump callback was not found");
     return RCL_RET_ERROR;
   }
+  const size_t cb_idx = index->slots[slot];
+  rcl_jump_callback_remove_slot(clock, slot);
+  int list;
+  for (list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+    rcl_jump_callback_unlink(clock, cb_idx, (rcl_jump_callback_list_t)list);
+  }
 
-  // Shrink size of the callback array
-  if (--(clock->num_jump_callbacks) == 0) {
-    clock->allocator.deallocate(clock->jump_callbacks, clock->allocator.state);
-    clock->jump_callbacks = NULL;
-  } else {
-    rcl_jump_callback_info_t * callbacks = clock->allocator.reallocate(
-      clock->jump_callbacks, sizeof(rcl_jump_callback_info_t) * clock->num_jump_callbacks,
-      clock->allocator.state);
-    if (NULL == callbacks) {
-      RCL_SET_ERROR_MSG("Failed to shrink jump callbacks");
-      return RCL_RET_BAD_ALLOC;
+  // Move the last callback in the freed place
+  const size_t last_idx = --(clock->num_jump_callbacks);
+  if (cb_idx != last_idx) {
+    const rcl_jump_callback_info_t * last = &clock->jump_callbacks[last_idx];
+    slot = rcl_jump_callback_find_slot(clock, last->callback, last->user_data);
+    index->slots[slot] = cb_idx;
+    for (list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+      rcl_jump_callback_unlink(clock, last_idx, (rcl_jump_callback_list_t)list);
+    }
+    clock->jump_callbacks[cb_idx] = *last;
+    for (list = 0; list < RCL_JUMP_CALLBACK_LIST_COUNT; ++list) {
+      rcl_jump_callback_link(clock, cb_idx, (rcl_jump_callback_list_t)list);
     }
-    clock->jump_callbacks = callbacks;
   }
   return RCL_RET_OK;
 }
@@ -27,6 +27,8 @@ extern "C"
 #include "rcutils/time.h"
 #include "tracetools/tracetools.h"
 
+#include "./kernel_timer.h"
+
 typedef struct rcl_timer_impl_t
 {
   // The clock providing time.
@@ -36,6 +38,9 @@ typedef struct rcl_timer_impl_t
   // A guard condition used to wake the associated wait set, either when
   // ROSTime causes the timer to expire or when the timer is reset.
   rcl_guard_condition_t guard_condition;
+  // The guard condition shared by the timers of the clock, used instead of guard_condition
+  // (which is then left zero initialized) if not NULL.
+  rcl_guard_condition_t * shared_guard_condition;
   // The user supplied callback.
   atomic_uintptr_t callback;
   // This is a duration in nanoseconds.
@@ -50,6 +55,8 @@ typedef struct rcl_timer_impl_t
   atomic_bool canceled;
   // The user supplied allocator.
   rcl_allocator_t allocator;
+  // Kernel timer triggering the guard condition at the next call time, if enabled.
+  rcl_kernel_timer_t * kernel_timer;
 } rcl_timer_impl_t;
 
 rcl_timer_t
@@ -59,6 +66,13 @@ rcl_get_zero_initialized_timer()
   return null_timer;
 }
 
+// The guard condition which wakes the wait sets of the timer.
+static rcl_guard_condition_t *
+_rcl_timer_guard_condition(rcl_timer_impl_t * impl)
+{
+  return impl->shared_guard_condition ? impl->shared_guard_condition : &impl->guard_condition;
+}
+
 void _rcl_timer_time_jump(
   const struct rcl_time_jump_t * time_jump,
   bool before_jump,
@@ -106,10 +120,15 @@ void _rcl_timer_time_jump(
         // set times in new epoch so timer only waits the remainder of the period
         rcutils_atomic_store(&timer->impl->next_call_time, now - time_credit + period);
         rcutils_atomic_store(&timer->impl->last_call_time, now - time_credit);
+        // wake the wait sets so they pick up the new next call time
+        if (RCL_RET_OK != rcl_trigger_guard_condition(_rcl_timer_guard_condition(timer->impl))) {
+          RCUTILS_LOG_ERROR_NAMED(
+            ROS_PACKAGE_NAME, "Failed to get trigger guard condition in jump callback");
+        }
       }
     } else if (next_call_time <= now) {
       // Post Forward jump and timer is ready
-      if (RCL_RET_OK != rcl_trigger_guard_condition(&timer->impl->guard_condition)) {
+      if (RCL_RET_OK != rcl_trigger_guard_condition(_rcl_timer_guard_condition(timer->impl))) {
         RCUTILS_LOG_ERROR_NAMED(
           ROS_PACKAGE_NAME, "Failed to get trigger guard condition in jump callback");
       }
@@ -118,6 +137,11 @@ void _rcl_timer_time_jump(
       // next callback should happen after 1 period
       rcutils_atomic_store(&timer->impl->next_call_time, now + period);
       rcutils_atomic_store(&timer->impl->last_call_time, now);
+      // wake the wait sets so they pick up the new next call time
+      if (RCL_RET_OK != rcl_trigger_guard_condition(_rcl_timer_guard_condition(timer->impl))) {
+        RCUTILS_LOG_ERROR_NAMED(
+          ROS_PACKAGE_NAME, "Failed to get trigger guard condition in jump callback");
+      }
       return;
     }
   }
@@ -154,10 +178,19 @@ rcl_timer_init(
   impl.clock = clock;
   impl.context = context;
   impl.guard_condition = rcl_get_zero_initialized_guard_condition();
-  rcl_guard_condition_options_t options = rcl_guard_condition_get_default_options();
-  rcl_ret_t ret = rcl_guard_condition_init(&(impl.guard_condition), context, options);
-  if (RCL_RET_OK != ret) {
-    return ret;
+  impl.shared_guard_condition = clock->timer_guard_condition;
+  rcl_ret_t ret = RCL_RET_OK;
+  if (NULL != impl.shared_guard_condition) {
+    if (impl.shared_guard_condition->context != context) {
+      RCL_SET_ERROR_MSG("the clock's shared timer guard condition belongs to another context");
+      return RCL_RET_INVALID_ARGUMENT;
+    }
+  } else {
+    rcl_guard_condition_options_t options = rcl_guard_condition_get_default_options();
+    ret = rcl_guard_condition_init(&(impl.guard_condition), context, options);
+    if (RCL_RET_OK != ret) {
+      return ret;
+    }
   }
   if (RCL_ROS_TIME == impl.clock->type) {
     rcl_jump_threshold_t threshold;
@@ -181,6 +214,7 @@ rcl_timer_init(
   atomic_init(&impl.next_call_time, now + period);
   atomic_init(&impl.canceled, false);
   impl.allocator = allocator;
+  impl.kernel_timer = NULL;
   timer->impl = (rcl_timer_impl_t *)allocator.allocate(sizeof(rcl_timer_impl_t), allocator.state);
   if (NULL == timer->impl) {
     if (RCL_RET_OK != rcl_guard_condition_fini(&(impl.guard_condition))) {
@@ -218,6 +252,11 @@ rcl_timer_fini(rcl_timer_t * timer)
       RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to remove timer jump callback");
     }
   }
+  // The kernel timer also uses the guard condition.
+  fail_ret = rcl_kernel_timer_fini(timer->impl->kernel_timer);
+  if (RCL_RET_OK != fail_ret) {
+    RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to fini kernel timer");
+  }
   fail_ret = rcl_guard_condition_fini(&(timer->impl->guard_condition));
   if (RCL_RET_OK != fail_ret) {
     RCL_SET_ERROR_MSG("Failure to fini guard condition");
@@ -239,29 +278,13 @@ rcl_timer_clock(rcl_timer_t * timer, rcl_clock_t ** clock)
   return RCL_RET_OK;
 }
 
-rcl_ret_t
-rcl_timer_call(rcl_timer_t * timer)
+// Set the last call time of the timer to now and move its next call time forward.
+// Returns the previous last call time.
+static rcl_time_point_value_t
+__rcl_timer_advance(rcl_timer_t * timer, rcl_time_point_value_t now)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Calling timer");
-  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
-  if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
-    RCL_SET_ERROR_MSG("timer is canceled");
-    return RCL_RET_TIMER_CANCELED;
-  }
-  rcl_time_point_value_t now;
-  rcl_ret_t now_ret = rcl_clock_get_now(timer->impl->clock, &now);
-  if (now_ret != RCL_RET_OK) {
-    return now_ret;  // rcl error state should already be set.
-  }
-  if (now < 0) {
-    RCL_SET_ERROR_MSG("clock now returned negative time point value");
-    return RCL_RET_ERROR;
-  }
   rcl_time_point_value_t previous_ns =
     rcutils_atomic_exchange_int64_t(&timer->impl->last_call_time, now);
-  rcl_timer_callback_t typed_callback =
-    (rcl_timer_callback_t)rcutils_atomic_load_uintptr_t(&timer->impl->callback);
-
   int64_t next_call_time = rcutils_atomic_load_int64_t(&timer->impl->next_call_time);
   int64_t period = rcutils_atomic_load_uint64_t(&timer->impl->period);
   // always move the next call time by exactly period forward
@@ -282,6 +305,35 @@ rcl_timer_call(rcl_timer_t * timer)
     }
   }
   rcutils_atomic_store(&timer->impl->next_call_time, next_call_time);
+  if (NULL != timer->impl->kernel_timer &&
+    RCL_RET_OK != rcl_kernel_timer_arm(timer->impl->kernel_timer, next_call_time))
+  {
+    RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to arm kernel timer");
+  }
+  return previous_ns;
+}
+
+rcl_ret_t
+rcl_timer_call(rcl_timer_t * timer)
+{
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Calling timer");
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
+    RCL_SET_ERROR_MSG("timer is canceled");
+    return RCL_RET_TIMER_CANCELED;
+  }
+  rcl_time_point_value_t now;
+  rcl_ret_t now_ret = rcl_clock_get_now(timer->impl->clock, &now);
+  if (now_ret != RCL_RET_OK) {
+    return now_ret;  // rcl error state should already be set.
+  }
+  if (now < 0) {
+    RCL_SET_ERROR_MSG("clock now returned negative time point value");
+    return RCL_RET_ERROR;
+  }
+  rcl_time_point_value_t previous_ns = __rcl_timer_advance(timer, now);
+  rcl_timer_callback_t typed_callback =
+    (rcl_timer_callback_t)rcutils_atomic_load_uintptr_t(&timer->impl->callback);
 
   if (typed_callback != NULL) {
     int64_t since_last_call = now - previous_ns;
@@ -290,13 +342,95 @@ rcl_timer_call(rcl_timer_t * timer)
   return RCL_RET_OK;
 }
 
+// Number of distinct clocks whose time rcl_timer_call_ready_batch() remembers.
+// Timers using further clocks are still called, reading their clock each time.
+#define RCL_TIMER_BATCH_CLOCK_CACHE_SIZE 8
+
+rcl_ret_t
+rcl_timer_call_ready_batch(
+  const rcl_timer_t * const * timers,
+  size_t timer_count,
+  rcl_timer_batch_call_t * calls,
+  size_t * call_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timers, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(calls, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(call_count, RCL_RET_INVALID_ARGUMENT);
+  *call_count = 0u;
+  rcl_clock_t * clocks[RCL_TIMER_BATCH_CLOCK_CACHE_SIZE];
+  rcl_time_point_value_t clock_now[RCL_TIMER_BATCH_CLOCK_CACHE_SIZE];
+  size_t clock_count = 0u;
+  size_t i;
+  for (i = 0; i < timer_count; ++i) {
+    // The timer state is atomic, the const only comes from the wait set storage.
+    rcl_timer_t * timer = (rcl_timer_t *)timers[i];
+    if (NULL == timer) {
+      continue;
+    }
+    RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
+    if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
+      continue;
+    }
+    size_t c = 0u;
+    while (c < clock_count && clocks[c] != timer->impl->clock) {
+      ++c;
+    }
+    rcl_time_point_value_t now;
+    if (c < clock_count) {
+      now = clock_now[c];
+    } else {
+      rcl_ret_t now_ret = rcl_clock_get_now(timer->impl->clock, &now);
+      if (now_ret != RCL_RET_OK) {
+        return now_ret;  // rcl error state should already be set.
+      }
+      if (now < 0) {
+        RCL_SET_ERROR_MSG("clock now returned negative time point value");
+        return RCL_RET_ERROR;
+      }
+      if (clock_count < RCL_TIMER_BATCH_CLOCK_CACHE_SIZE) {
+        clocks[clock_count] = timer->impl->clock;
+        clock_now[clock_count] = now;
+        ++clock_count;
+      }
+    }
+    if (rcutils_atomic_load_int64_t(&timer->impl->next_call_time) > now) {
+      continue;  // Not ready.
+    }
+    rcl_time_point_value_t previous_ns = __rcl_timer_advance(timer, now);
+    rcl_timer_batch_call_t * call = &calls[*call_count];
+    call->timer = timer;
+    call->callback =
+      (rcl_timer_callback_t)rcutils_atomic_load_uintptr_t(&timer->impl->callback);
+    call->time_since_last_call = now - previous_ns;
+    ++(*call_count);
+  }
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_timer_is_ready(const rcl_timer_t * timer, bool * is_ready)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(is_ready, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
+  rcl_time_point_value_t now;
+  rcl_ret_t ret = rcl_clock_get_now(timer->impl->clock, &now);
+  if (ret != RCL_RET_OK) {
+    return ret;  // rcl error state should already be set.
+  }
+  return rcl_timer_is_ready_at(timer, now, is_ready);
+}
+
+rcl_ret_t
+rcl_timer_is_ready_at(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  bool * is_ready)
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(is_ready, RCL_RET_INVALID_ARGUMENT);
   int64_t time_until_next_call;
-  rcl_ret_t ret = rcl_timer_get_time_until_next_call(timer, &time_until_next_call);
+  rcl_ret_t ret = rcl_timer_get_time_until_next_call_at(timer, now, &time_until_next_call);
   if (ret != RCL_RET_OK) {
     return ret;  // rcl error state should already be set.
   }
@@ -309,16 +443,39 @@ rcl_timer_get_time_until_next_call(const rcl_timer_t * timer, int64_t * time_unt
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(time_until_next_call, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
   rcl_time_point_value_t now;
   rcl_ret_t ret = rcl_clock_get_now(timer->impl->clock, &now);
   if (ret != RCL_RET_OK) {
     return ret;  // rcl error state should already be set.
   }
+  return rcl_timer_get_time_until_next_call_at(timer, now, time_until_next_call);
+}
+
+rcl_ret_t
+rcl_timer_get_time_until_next_call_at(
+  const rcl_timer_t * timer,
+  rcl_time_point_value_t now,
+  int64_t * time_until_next_call)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(time_until_next_call, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
   *time_until_next_call =
     rcutils_atomic_load_int64_t(&timer->impl->next_call_time) - now;
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_timer_get_next_call_time(const rcl_timer_t * timer, int64_t * next_call_time)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(next_call_time, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
+  *next_call_time = rcutils_atomic_load_int64_t(&timer->impl->next_call_time);
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_timer_get_time_since_last_call(
   const rcl_timer_t * timer,
@@ -386,6 +543,11 @@ rcl_timer_cancel(rcl_timer_t * timer)
   RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
   rcutils_atomic_store(&timer->impl->canceled, true);
+  if (NULL != timer->impl->kernel_timer &&
+    RCL_RET_OK != rcl_kernel_timer_disarm(timer->impl->kernel_timer))
+  {
+    RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to disarm kernel timer");
+  }
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Timer canceled");
   return RCL_RET_OK;
 }
@@ -414,7 +576,12 @@ rcl_timer_reset(rcl_timer_t * timer)
   int64_t period = rcutils_atomic_load_uint64_t(&timer->impl->period);
   rcutils_atomic_store(&timer->impl->next_call_time, now + period);
   rcutils_atomic_store(&timer->impl->canceled, false);
-  rcl_ret_t ret = rcl_trigger_guard_condition(&timer->impl->guard_condition);
+  if (NULL != timer->impl->kernel_timer &&
+    RCL_RET_OK != rcl_kernel_timer_arm(timer->impl->kernel_timer, now + period))
+  {
+    RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to arm kernel timer");
+  }
+  rcl_ret_t ret = rcl_trigger_guard_condition(_rcl_timer_guard_condition(timer->impl));
   if (ret != RCL_RET_OK) {
     RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to trigger timer guard condition");
   }
@@ -433,10 +600,92 @@ rcl_timer_get_allocator(const rcl_timer_t * timer)
 rcl_guard_condition_t *
 rcl_timer_get_guard_condition(const rcl_timer_t * timer)
 {
-  if (NULL == timer || NULL == timer->impl || NULL == timer->impl->guard_condition.impl) {
+  if (NULL == timer || NULL == timer->impl) {
     return NULL;
   }
-  return &timer->impl->guard_condition;
+  rcl_guard_condition_t * guard_condition = _rcl_timer_guard_condition(timer->impl);
+  return NULL != guard_condition->impl ? guard_condition : NULL;
+}
+
+rcl_ret_t
+rcl_timer_enable_kernel_wakeup(rcl_timer_t * timer)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(timer->impl, "timer is invalid", return RCL_RET_TIMER_INVALID);
+  if (NULL != timer->impl->kernel_timer) {
+    return RCL_RET_OK;
+  }
+  if (
+    RCL_STEADY_TIME != timer->impl->clock->type ||
+    rcl_clock_uses_coarse_time(timer->impl->clock))
+  {
+    RCL_SET_ERROR_MSG("kernel wake ups are only supported by timers using precise steady time");
+    return RCL_RET_UNSUPPORTED;
+  }
+  rcl_kernel_timer_t * kernel_timer = NULL;
+  rcl_ret_t ret = rcl_kernel_timer_init(
+    &kernel_timer, _rcl_timer_guard_condition(timer->impl), timer->impl->allocator);
+  if (RCL_RET_OK != ret) {
+    return ret;  // rcl error state should already be set.
+  }
+  if (!rcutils_atomic_load_bool(&timer->impl->canceled)) {
+    ret = rcl_kernel_timer_arm(
+      kernel_timer, rcutils_atomic_load_int64_t(&timer->impl->next_call_time));
+    if (RCL_RET_OK != ret) {
+      if (RCL_RET_OK != rcl_kernel_timer_fini(kernel_timer)) {
+        RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to fini kernel timer after arm failure");
+      }
+      return ret;  // rcl error state should already be set.
+    }
+  }
+  timer->impl->kernel_timer = kernel_timer;
+  return RCL_RET_OK;
+}
+
+bool
+rcl_timer_uses_kernel_wakeup(const rcl_timer_t * timer)
+{
+  return NULL != timer && NULL != timer->impl && NULL != timer->impl->kernel_timer;
+}
+
+bool
+rcl_timer_uses_shared_guard_condition(const rcl_timer_t * timer)
+{
+  return NULL != timer && NULL != timer->impl && NULL != timer->impl->shared_guard_condition;
+}
+
+rcl_ret_t
+rcl_clock_enable_shared_timer_guard_condition(rcl_clock_t * clock, rcl_context_t * context)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(clock, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_clock_valid(clock)) {
+    RCL_SET_ERROR_MSG("clock is not initialized");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (NULL != clock->timer_guard_condition) {
+    if (clock->timer_guard_condition->context != context) {
+      RCL_SET_ERROR_MSG("the clock's shared timer guard condition belongs to another context");
+      return RCL_RET_INVALID_ARGUMENT;
+    }
+    return RCL_RET_OK;
+  }
+  rcl_allocator_t allocator = clock->allocator;
+  rcl_guard_condition_t * guard_condition = (rcl_guard_condition_t *)allocator.allocate(
+    sizeof(rcl_guard_condition_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    guard_condition, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  *guard_condition = rcl_get_zero_initialized_guard_condition();
+  rcl_guard_condition_options_t options = rcl_guard_condition_get_default_options();
+  options.allocator = allocator;
+  rcl_ret_t ret = rcl_guard_condition_init(guard_condition, context, options);
+  if (RCL_RET_OK != ret) {
+    allocator.deallocate(guard_condition, allocator.state);
+    return ret;  // rcl error state should already be set.
+  }
+  // Finalized along with the clock.
+  clock->timer_guard_condition = guard_condition;
+  return RCL_RET_OK;
 }
 
 #ifdef __cplusplus
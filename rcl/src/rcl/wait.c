@@ -22,16 +22,63 @@ extern "C"
 #include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <sched.h>
+#endif
+
 #include "rcl/error_handling.h"
 #include "rcl/time.h"
 #include "rcutils/logging_macros.h"
+#include "rcutils/time.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
 #include "rmw/event.h"
 
+#include "./client_impl.h"
 #include "./context_impl.h"
+#include "./counters.h"
+#include "./event_impl.h"
+#include "./service_impl.h"
+#include "./subscription_impl.h"
+
+// Edge mark of an entity which is passed to rmw_wait().
+#define RCL_WAIT_SET_EDGE_ARMED UINT64_MAX
+
+// A timer in one of the wait set's timer heaps, keyed by its next call time.
+typedef struct rcl_wait_set_timer_heap_entry_t
+{
+  // index of the timer in the wait set
+  size_t timer_index;
+  // next call time of the timer when it was last looked at, INT64_MAX if it is canceled
+  int64_t key;
+} rcl_wait_set_timer_heap_entry_t;
+
+// Min-heap of the timers in the wait set which share a time source.
+typedef struct rcl_wait_set_timer_heap_t
+{
+  rcl_clock_t * clock;
+  // true if the timers wake the wait set with kernel timers, so need no timeout
+  bool kernel_wakeup;
+  rcl_wait_set_timer_heap_entry_t * entries;
+  size_t size;
+} rcl_wait_set_timer_heap_t;
+
+#ifdef RCL_ENABLE_STATISTICS
+// Wake up causes and wait latencies of a profiled wait set, see rcl_wait_set_profile_t.
+typedef struct rcl_wait_set_profile_counters_t
+{
+  rcl_counter_t ready_counts[RCL_WAIT_SET_ENTITY_TYPE_COUNT];
+  rcl_counter_t timeout_count;
+  rcl_counter_t spurious_count;
+  rcl_counter_t blocked[RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT];
+  rcl_counter_t overshoot[RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT];
+} rcl_wait_set_profile_counters_t;
+#endif
 
 typedef struct rcl_wait_set_impl_t
 {
@@ -58,6 +105,48 @@ typedef struct rcl_wait_set_impl_t
   rcl_context_t * context;
   // allocator used in the wait set
   rcl_allocator_t allocator;
+  // true if the entities in the wait set persist across calls to rcl_wait()
+  bool persistent;
+  // snapshot of the rmw storage, restored on every call to rcl_wait() while persistent
+  void ** persistent_rmw_storage;
+  size_t persistent_subscription_count;
+  size_t persistent_guard_condition_count;
+  size_t persistent_client_count;
+  size_t persistent_service_count;
+  size_t persistent_event_count;
+  // readiness of every entity after the last call to rcl_wait() while persistent
+  bool * ready;
+  // true if entities reported ready are left out of rcl_wait() until a take on them fails
+  bool edge_triggered;
+  // per entity, RCL_WAIT_SET_EDGE_ARMED or the failed take count when it was reported ready
+  uint64_t * edge_marks;
+  // time spent polling in rcl_wait() before blocking, 0 to block right away, kept across clears
+  int64_t spin_budget;
+  rcl_wait_set_spin_relax_t spin_relax;
+  // one timer heap per clock, all sharing the storage in timer_heap_entries
+  rcl_wait_set_timer_heap_t * timer_heaps;
+  size_t timer_heap_count;
+  rcl_wait_set_timer_heap_entry_t * timer_heap_entries;
+  // scratch space of size_of_timers indices used to build and query the heaps
+  size_t * timer_scratch;
+  // true if the timer heaps match the timers in the wait set, only kept while persistent
+  bool timer_heaps_valid;
+  // number of entries allocated for each array, which only shrinks in rcl_wait_set_shrink_to_fit()
+  // the rmw storage of each kind shares the capacity of the rcl array, as do the timer heaps
+  size_t subscription_capacity;
+  size_t guard_condition_capacity;
+  size_t timer_capacity;
+  size_t client_capacity;
+  size_t service_capacity;
+  size_t event_capacity;
+  size_t rmw_guard_condition_capacity;
+  // shared by the persistent snapshot, the readiness flags and the edge marks
+  size_t persistent_capacity;
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_wait_set_counters_t counters;
+  // NULL unless profiling is enabled with rcl_wait_set_set_profiling()
+  rcl_wait_set_profile_counters_t * profile;
+#endif
 } rcl_wait_set_impl_t;
 
 rcl_wait_set_t
@@ -87,6 +176,444 @@ rcl_wait_set_is_valid(const rcl_wait_set_t * wait_set)
   return wait_set && wait_set->impl;
 }
 
+// Number of entities of all kinds which fit in the wait set.
+static size_t
+__wait_set_total_size(const rcl_wait_set_t * wait_set)
+{
+  return
+    wait_set->size_of_subscriptions +
+    wait_set->size_of_guard_conditions +
+    wait_set->size_of_timers +
+    wait_set->size_of_clients +
+    wait_set->size_of_services +
+    wait_set->size_of_events;
+}
+
+// Offset of the first entity of the given kind in the per entity arrays of a persistent wait set,
+// which are laid out in the same order as the enum.
+static size_t
+__wait_set_entity_offset(const rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t type)
+{
+  size_t offset = 0u;
+  if (RCL_WAIT_SET_SUBSCRIPTION == type) {
+    return offset;
+  }
+  offset += wait_set->size_of_subscriptions;
+  if (RCL_WAIT_SET_GUARD_CONDITION == type) {
+    return offset;
+  }
+  offset += wait_set->size_of_guard_conditions;
+  if (RCL_WAIT_SET_TIMER == type) {
+    return offset;
+  }
+  offset += wait_set->size_of_timers;
+  if (RCL_WAIT_SET_CLIENT == type) {
+    return offset;
+  }
+  offset += wait_set->size_of_clients;
+  if (RCL_WAIT_SET_SERVICE == type) {
+    return offset;
+  }
+  return offset + wait_set->size_of_services;
+}
+
+// Readiness flags for the given kind of entity.
+static bool *
+__wait_set_ready_flags(const rcl_wait_set_t * wait_set, rcl_wait_set_entity_type_t type)
+{
+  return wait_set->impl->ready + __wait_set_entity_offset(wait_set, type);
+}
+
+static void
+__copy_rmw_storage(void ** destination, void ** source, size_t size)
+{
+  if (0u != size) {
+    memcpy(destination, source, sizeof(void *) * size);
+  }
+}
+
+// Layout of the persistent snapshot, one section per kind of rmw storage.
+// The guard condition section includes the slots reserved for the timers' guard conditions.
+static void
+__wait_set_persistent_sections(
+  const rcl_wait_set_t * wait_set,
+  void *** storage,
+  size_t * sizes)
+{
+  const rcl_wait_set_impl_t * impl = wait_set->impl;
+  storage[0] = impl->rmw_subscriptions.subscribers;
+  storage[1] = impl->rmw_guard_conditions.guard_conditions;
+  storage[2] = impl->rmw_clients.clients;
+  storage[3] = impl->rmw_services.services;
+  storage[4] = impl->rmw_events.events;
+  sizes[0] = wait_set->size_of_subscriptions;
+  sizes[1] = wait_set->size_of_guard_conditions + wait_set->size_of_timers;
+  sizes[2] = wait_set->size_of_clients;
+  sizes[3] = wait_set->size_of_services;
+  sizes[4] = wait_set->size_of_events;
+}
+
+// Restore the rmw storage from the persistent snapshot.
+static void
+__wait_set_restore_persistent_storage(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  void ** snapshot = impl->persistent_rmw_storage;
+  void ** storage[5];
+  size_t sizes[5];
+  __wait_set_persistent_sections(wait_set, storage, sizes);
+  size_t i;
+  for (i = 0; i < 5; ++i) {
+    __copy_rmw_storage(storage[i], snapshot, sizes[i]);
+    snapshot += sizes[i];
+  }
+  impl->rmw_subscriptions.subscriber_count = impl->persistent_subscription_count;
+  impl->rmw_guard_conditions.guard_condition_count = impl->persistent_guard_condition_count;
+  impl->rmw_clients.client_count = impl->persistent_client_count;
+  impl->rmw_services.service_count = impl->persistent_service_count;
+  impl->rmw_events.event_count = impl->persistent_event_count;
+}
+
+// Fill the persistent snapshot from the entities in the wait set, laid out as the add functions
+// lay out the rmw storage.
+// The rmw storage itself is not used, as rmw_wait() prunes it and rcl_wait() moves the timers'
+// guard conditions in it.
+static rcl_ret_t
+__wait_set_snapshot_persistent_storage(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  void ** snapshot = impl->persistent_rmw_storage;
+  void ** storage[5];
+  size_t sizes[5];
+  __wait_set_persistent_sections(wait_set, storage, sizes);
+  size_t i;
+  // Slots past the added entities are restored as NULL, so that they are never reported ready.
+  for (i = 0; i < 5; ++i) {
+    size_t j;
+    for (j = 0; j < sizes[i]; ++j) {
+      *snapshot++ = NULL;
+    }
+  }
+  snapshot = impl->persistent_rmw_storage;
+  for (i = 0; i < impl->subscription_index; ++i) {
+    rmw_subscription_t * rmw_handle = rcl_subscription_get_rmw_handle(wait_set->subscriptions[i]);
+    RCL_CHECK_FOR_NULL_WITH_MSG(rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+    snapshot[i] = rmw_handle->data;
+  }
+  snapshot += wait_set->size_of_subscriptions;
+  for (i = 0; i < impl->guard_condition_index; ++i) {
+    rmw_guard_condition_t * rmw_handle =
+      rcl_guard_condition_get_rmw_handle(wait_set->guard_conditions[i]);
+    RCL_CHECK_FOR_NULL_WITH_MSG(rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+    snapshot[i] = rmw_handle->data;
+  }
+  for (i = 0; i < impl->timer_index; ++i) {
+    rcl_guard_condition_t * guard_condition = rcl_timer_get_guard_condition(wait_set->timers[i]);
+    if (NULL == guard_condition) {
+      continue;
+    }
+    rmw_guard_condition_t * rmw_handle = rcl_guard_condition_get_rmw_handle(guard_condition);
+    RCL_CHECK_FOR_NULL_WITH_MSG(rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+    snapshot[wait_set->size_of_guard_conditions + i] = rmw_handle->data;
+  }
+  snapshot += wait_set->size_of_guard_conditions + wait_set->size_of_timers;
+  for (i = 0; i < impl->client_index; ++i) {
+    rmw_client_t * rmw_handle = rcl_client_get_rmw_handle(wait_set->clients[i]);
+    RCL_CHECK_FOR_NULL_WITH_MSG(rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+    snapshot[i] = rmw_handle->data;
+  }
+  snapshot += wait_set->size_of_clients;
+  for (i = 0; i < impl->service_index; ++i) {
+    rmw_service_t * rmw_handle = rcl_service_get_rmw_handle(wait_set->services[i]);
+    RCL_CHECK_FOR_NULL_WITH_MSG(rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+    snapshot[i] = rmw_handle->data;
+  }
+  snapshot += wait_set->size_of_services;
+  for (i = 0; i < impl->event_index; ++i) {
+    rmw_event_t * rmw_handle = rcl_event_get_rmw_handle(wait_set->events[i]);
+    RCL_CHECK_FOR_NULL_WITH_MSG(rmw_handle, rcl_get_error_string().str, return RCL_RET_ERROR);
+    snapshot[i] = rmw_handle;
+  }
+  impl->persistent_subscription_count = impl->subscription_index;
+  impl->persistent_guard_condition_count = impl->guard_condition_index;
+  impl->persistent_client_count = impl->client_index;
+  impl->persistent_service_count = impl->service_index;
+  impl->persistent_event_count = impl->event_index;
+  return RCL_RET_OK;
+}
+
+// Return true if rcl_wait() in the default mode set some of the entities added to the wait set
+// to NULL, which are then lost until the wait set is cleared and filled again.
+static bool
+__wait_set_is_pruned(const rcl_wait_set_t * wait_set)
+{
+  const rcl_wait_set_impl_t * impl = wait_set->impl;
+  size_t i;
+#define WAIT_SET_CHECK_PRUNED(Type) \
+  for (i = 0; i < impl->Type ## _index; ++i) { \
+    if (NULL == wait_set->Type ## s[i]) { \
+      return true; \
+    } \
+  }
+  WAIT_SET_CHECK_PRUNED(subscription)
+  WAIT_SET_CHECK_PRUNED(guard_condition)
+  WAIT_SET_CHECK_PRUNED(timer)
+  WAIT_SET_CHECK_PRUNED(client)
+  WAIT_SET_CHECK_PRUNED(service)
+  WAIT_SET_CHECK_PRUNED(event)
+#undef WAIT_SET_CHECK_PRUNED
+  return false;
+}
+
+// Drop the persistent snapshot, if any, returning the wait set to the default mode.
+// Its storage is kept for the next call to rcl_wait_set_persist().
+static void
+__wait_set_release_persistent(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  impl->edge_triggered = false;
+  impl->persistent = false;
+  impl->timer_heaps_valid = false;
+}
+
+// Capacity to grow an array to so that it fits `size` entries, at least double the current one.
+static size_t
+__wait_set_grown_capacity(size_t capacity, size_t size)
+{
+  return size > 2 * capacity ? size : 2 * capacity;
+}
+
+// Shrink an array to `size` entries, or deallocate it if `size` is 0, returning the new array.
+static void *
+__wait_set_shrink_array(
+  const rcl_allocator_t * allocator,
+  void * array,
+  size_t size,
+  size_t element_size)
+{
+  if (0u == size) {
+    if (array) {
+      allocator->deallocate(array, allocator->state);
+    }
+    return NULL;
+  }
+  void * shrunk = allocator->reallocate(array, element_size * size, allocator->state);
+  // If shrinking failed the original array is still valid, and large enough.
+  return shrunk ? shrunk : array;
+}
+
+// Grow the storage of the timer heaps to fit the given number of timers.
+static rcl_ret_t
+__wait_set_grow_timer_heaps(rcl_wait_set_t * wait_set, size_t capacity)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rcl_allocator_t allocator = impl->allocator;
+  impl->timer_heap_count = 0u;
+  impl->timer_heaps_valid = false;
+  // Each array which could be grown is kept, the capacity is only updated once all of them are.
+  void * timer_heaps = allocator.reallocate(
+    impl->timer_heaps, sizeof(rcl_wait_set_timer_heap_t) * capacity, allocator.state);
+  if (timer_heaps) {
+    impl->timer_heaps = (rcl_wait_set_timer_heap_t *)timer_heaps;
+  }
+  void * timer_heap_entries = allocator.reallocate(
+    impl->timer_heap_entries, sizeof(rcl_wait_set_timer_heap_entry_t) * capacity,
+    allocator.state);
+  if (timer_heap_entries) {
+    impl->timer_heap_entries = (rcl_wait_set_timer_heap_entry_t *)timer_heap_entries;
+  }
+  void * timer_scratch = allocator.reallocate(
+    impl->timer_scratch, sizeof(size_t) * capacity, allocator.state);
+  if (timer_scratch) {
+    impl->timer_scratch = (size_t *)timer_scratch;
+  }
+  if (!timer_heaps || !timer_heap_entries || !timer_scratch) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  return RCL_RET_OK;
+}
+
+// Compute the heap key of a timer: its next call time, or INT64_MAX if it is never going to be
+// ready. This does not read the clock.
+static rcl_ret_t
+__wait_set_timer_key(const rcl_wait_set_t * wait_set, size_t timer_index, int64_t * key)
+{
+  const rcl_timer_t * timer = wait_set->timers[timer_index];
+  *key = INT64_MAX;
+  if (NULL == timer) {
+    return RCL_RET_OK;
+  }
+  bool is_canceled = false;
+  rcl_ret_t ret = rcl_timer_is_canceled(timer, &is_canceled);
+  if (ret != RCL_RET_OK || is_canceled) {
+    return ret;
+  }
+  return rcl_timer_get_next_call_time(timer, key);
+}
+
+static void
+__timer_heap_sift_down(rcl_wait_set_timer_heap_t * heap, size_t index)
+{
+  rcl_wait_set_timer_heap_entry_t * entries = heap->entries;
+  for (;;) {
+    const size_t left = 2 * index + 1;
+    const size_t right = left + 1;
+    size_t smallest = index;
+    if (left < heap->size && entries[left].key < entries[smallest].key) {
+      smallest = left;
+    }
+    if (right < heap->size && entries[right].key < entries[smallest].key) {
+      smallest = right;
+    }
+    if (smallest == index) {
+      return;
+    }
+    const rcl_wait_set_timer_heap_entry_t entry = entries[index];
+    entries[index] = entries[smallest];
+    entries[smallest] = entry;
+    index = smallest;
+  }
+}
+
+// Group the timers in the wait set by clock and by whether they use kernel wake ups,
+// and build a heap for each group.
+static rcl_ret_t
+__wait_set_build_timer_heaps(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rcl_wait_set_timer_heap_t * heaps = impl->timer_heaps;
+  // The scratch space holds the heap of every timer until the heaps are laid out.
+  size_t * heap_of_timer = impl->timer_scratch;
+  size_t i;
+  size_t h;
+  impl->timer_heap_count = 0u;
+  impl->timer_heaps_valid = false;
+  for (i = 0; i < impl->timer_index; ++i) {
+    if (!wait_set->timers[i]) {
+      continue;
+    }
+    rcl_clock_t * clock = NULL;
+    rcl_ret_t ret = rcl_timer_clock((rcl_timer_t *)wait_set->timers[i], &clock);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    }
+    const bool kernel_wakeup = rcl_timer_uses_kernel_wakeup(wait_set->timers[i]);
+    h = 0u;
+    // Clocks reading the same time source, like ROS clocks attached to each other, share a heap.
+    while (
+      h < impl->timer_heap_count &&
+      (heaps[h].clock->get_now != clock->get_now || heaps[h].clock->data != clock->data ||
+      heaps[h].kernel_wakeup != kernel_wakeup))
+    {
+      ++h;
+    }
+    if (h == impl->timer_heap_count) {
+      heaps[h].clock = clock;
+      heaps[h].kernel_wakeup = kernel_wakeup;
+      heaps[h].size = 0u;
+      ++(impl->timer_heap_count);
+    }
+    ++(heaps[h].size);
+    heap_of_timer[i] = h;
+  }
+  rcl_wait_set_timer_heap_entry_t * entries = impl->timer_heap_entries;
+  for (h = 0; h < impl->timer_heap_count; ++h) {
+    heaps[h].entries = entries;
+    entries += heaps[h].size;
+    heaps[h].size = 0u;
+  }
+  for (i = 0; i < impl->timer_index; ++i) {
+    if (!wait_set->timers[i]) {
+      continue;
+    }
+    rcl_wait_set_timer_heap_t * heap = &heaps[heap_of_timer[i]];
+    rcl_wait_set_timer_heap_entry_t * entry = &heap->entries[heap->size];
+    entry->timer_index = i;
+    rcl_ret_t ret = __wait_set_timer_key(wait_set, i, &entry->key);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    }
+    ++(heap->size);
+  }
+  for (h = 0; h < impl->timer_heap_count; ++h) {
+    for (i = heaps[h].size / 2; i > 0; --i) {
+      __timer_heap_sift_down(&heaps[h], i - 1);
+    }
+  }
+  impl->timer_heaps_valid = true;
+  return RCL_RET_OK;
+}
+
+// Bring the root of a heap up to date.
+// Calling a timer only ever moves its next call time later, so stale keys are too small and it
+// is enough to refresh them as they reach the root. Anything that can move a next call time
+// earlier triggers the timer's guard condition instead, and rcl_wait() rebuilds the heaps then.
+static rcl_ret_t
+__timer_heap_update_root(const rcl_wait_set_t * wait_set, rcl_wait_set_timer_heap_t * heap)
+{
+  size_t attempts;
+  for (attempts = 0; attempts < heap->size; ++attempts) {
+    int64_t key = INT64_MAX;
+    rcl_ret_t ret = __wait_set_timer_key(wait_set, heap->entries[0].timer_index, &key);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    }
+    if (key == heap->entries[0].key) {
+      break;
+    }
+    heap->entries[0].key = key;
+    __timer_heap_sift_down(heap, 0);
+  }
+  return RCL_RET_OK;
+}
+
+// Collect the timers of the subtree rooted at `index` which are ready at the time `now`.
+// Only the subtrees whose keys are due are visited.
+static rcl_ret_t
+__timer_heap_collect_ready(
+  const rcl_wait_set_t * wait_set,
+  const rcl_wait_set_timer_heap_t * heap,
+  size_t index,
+  int64_t now,
+  size_t * ready_timers,
+  size_t * ready_timer_count)
+{
+  if (index >= heap->size || heap->entries[index].key > now) {
+    return RCL_RET_OK;
+  }
+  // The key may be stale, so check the timer itself.
+  bool is_ready = false;
+  rcl_ret_t ret = rcl_timer_is_ready_at(
+    wait_set->timers[heap->entries[index].timer_index], now, &is_ready);
+  if (ret != RCL_RET_OK) {
+    return ret;  // The rcl error state should already be set.
+  }
+  if (is_ready) {
+    ready_timers[*ready_timer_count] = heap->entries[index].timer_index;
+    ++(*ready_timer_count);
+  }
+  ret = __timer_heap_collect_ready(
+    wait_set, heap, 2 * index + 1, now, ready_timers, ready_timer_count);
+  if (ret != RCL_RET_OK) {
+    return ret;
+  }
+  return __timer_heap_collect_ready(
+    wait_set, heap, 2 * index + 2, now, ready_timers, ready_timer_count);
+}
+
+static int
+__compare_timer_indices(const void * lhs, const void * rhs)
+{
+  const size_t left = *(const size_t *)lhs;
+  const size_t right = *(const size_t *)rhs;
+  return (left > right) - (left < right);
+}
+
+// Shrink every array of the wait set to its size, see rcl_wait_set_shrink_to_fit().
+static void
+__wait_set_shrink(rcl_wait_set_t * wait_set);
+
 static void
 __wait_set_clean_up(rcl_wait_set_t * wait_set)
 {
@@ -94,6 +621,11 @@ __wait_set_clean_up(rcl_wait_set_t * wait_set)
   (void)ret;  // NO LINT
   assert(RCL_RET_OK == ret);  // Defensive, shouldn't fail with size 0.
   if (wait_set->impl) {
+    // Resizing keeps the capacity, so the arrays are only deallocated here.
+    __wait_set_shrink(wait_set);
+#ifdef RCL_ENABLE_STATISTICS
+    wait_set->impl->allocator.deallocate(wait_set->impl->profile, wait_set->impl->allocator.state);
+#endif
     wait_set->impl->allocator.deallocate(wait_set->impl, wait_set->impl->allocator.state);
     wait_set->impl = NULL;
   }
@@ -138,6 +670,12 @@ rcl_wait_set_init(
   RCL_CHECK_FOR_NULL_WITH_MSG(
     wait_set->impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
   memset(wait_set->impl, 0, sizeof(rcl_wait_set_impl_t));
+  RCL_COUNTER_INIT(wait_set->impl->counters.wait_count);
+  RCL_COUNTER_INIT(wait_set->impl->counters.ready_wakeup_count);
+  RCL_COUNTER_INIT(wait_set->impl->counters.timeout_wakeup_count);
+  RCL_COUNTER_INIT(wait_set->impl->counters.error_count);
+  RCL_COUNTER_INIT(wait_set->impl->counters.wait_duration_ns);
+  RCL_COUNTER_INIT(wait_set->impl->counters.max_wait_duration_ns);
   wait_set->impl->rmw_subscriptions.subscribers = NULL;
   wait_set->impl->rmw_subscriptions.subscriber_count = 0;
   wait_set->impl->rmw_guard_conditions.guard_conditions = NULL;
@@ -222,6 +760,11 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
     return RCL_RET_WAIT_SET_INVALID; \
   } \
   RCL_CHECK_ARGUMENT_FOR_NULL(Type, RCL_RET_INVALID_ARGUMENT); \
+  if (wait_set->impl->persistent) { \
+    /* The snapshot no longer matches the contents, go back to the default mode. */ \
+    __wait_set_restore_persistent_storage(wait_set); \
+    __wait_set_release_persistent(wait_set); \
+  } \
   if (!(wait_set->impl->Type ## _index < wait_set->size_of_ ## Type ## s)) { \
     RCL_SET_ERROR_MSG(#Type "s set is full"); \
     return RCL_RET_WAIT_SET_FULL; \
@@ -264,50 +807,56 @@ rcl_wait_set_get_allocator(const rcl_wait_set_t * wait_set, rcl_allocator_t * al
     } \
   } while (false)
 
-#define SET_RESIZE(Type, ExtraDealloc, ExtraRealloc) \
+#define SET_RESIZE(Type, ExtraRealloc, ExtraClear) \
   do { \
     rcl_allocator_t allocator = wait_set->impl->allocator; \
     wait_set->size_of_ ## Type ## s = 0; \
     wait_set->impl->Type ## _index = 0; \
-    if (0 == Type ## s_size) { \
-      if (wait_set->Type ## s) { \
-        allocator.deallocate((void *)wait_set->Type ## s, allocator.state); \
-        wait_set->Type ## s = NULL; \
-      } \
-      ExtraDealloc \
-    } else { \
-      wait_set->Type ## s = (const rcl_ ## Type ## _t **)allocator.reallocate( \
-        (void *)wait_set->Type ## s, sizeof(rcl_ ## Type ## _t *) * Type ## s_size, \
-        allocator.state); \
+    if (Type ## s_size > wait_set->impl->Type ## _capacity) { \
+      const size_t capacity = \
+        __wait_set_grown_capacity(wait_set->impl->Type ## _capacity, Type ## s_size); \
+      void * storage = allocator.reallocate( \
+        (void *)wait_set->Type ## s, sizeof(rcl_ ## Type ## _t *) * capacity, allocator.state); \
       RCL_CHECK_FOR_NULL_WITH_MSG( \
-        wait_set->Type ## s, "allocating memory failed", return RCL_RET_BAD_ALLOC); \
-      memset((void *)wait_set->Type ## s, 0, sizeof(rcl_ ## Type ## _t *) * Type ## s_size); \
-      wait_set->size_of_ ## Type ## s = Type ## s_size; \
+        storage, "allocating memory failed", return RCL_RET_BAD_ALLOC); \
+      wait_set->Type ## s = (const rcl_ ## Type ## _t **)storage; \
       ExtraRealloc \
+      wait_set->impl->Type ## _capacity = capacity; \
     } \
+    if (0u != Type ## s_size) { \
+      memset((void *)wait_set->Type ## s, 0, sizeof(rcl_ ## Type ## _t *) * Type ## s_size); \
+    } \
+    wait_set->size_of_ ## Type ## s = Type ## s_size; \
+    ExtraClear \
   } while (false)
 
-#define SET_RESIZE_RMW_DEALLOC(RMWStorage, RMWCount) \
-  /* Also deallocate the rmw storage. */ \
-  if (wait_set->impl->RMWStorage) { \
-    allocator.deallocate((void *)wait_set->impl->RMWStorage, allocator.state); \
-    wait_set->impl->RMWStorage = NULL; \
-    wait_set->impl->RMWCount = 0; \
-  }
-
-#define SET_RESIZE_RMW_REALLOC(Type, RMWStorage, RMWCount) \
-  /* Also resize the rmw storage. */ \
-  wait_set->impl->RMWCount = 0; \
-  wait_set->impl->RMWStorage = (void **)allocator.reallocate( \
-    wait_set->impl->RMWStorage, sizeof(void *) * Type ## s_size, allocator.state); \
-  if (!wait_set->impl->RMWStorage) { \
-    allocator.deallocate((void *)wait_set->Type ## s, allocator.state); \
-    wait_set->Type ## s = NULL; \
-    wait_set->size_of_ ## Type ## s = 0; \
+#define SET_RESIZE_RMW_REALLOC(RMWStorage) \
+  /* Also grow the rmw storage. */ \
+  void * rmw_storage = allocator.reallocate( \
+    wait_set->impl->RMWStorage, sizeof(void *) * capacity, allocator.state); \
+  if (!rmw_storage) { \
+    /* The grown rcl array is kept, the capacity still describes both arrays. */ \
     RCL_SET_ERROR_MSG("allocating memory failed"); \
     return RCL_RET_BAD_ALLOC; \
   } \
-  memset(wait_set->impl->RMWStorage, 0, sizeof(void *) * Type ## s_size);
+  wait_set->impl->RMWStorage = (void **)rmw_storage;
+
+#define SET_RESIZE_RMW_CLEAR(Type, RMWStorage, RMWCount) \
+  /* Also reset the rmw storage. */ \
+  wait_set->impl->RMWCount = 0; \
+  if (0u != Type ## s_size) { \
+    memset(wait_set->impl->RMWStorage, 0, sizeof(void *) * Type ## s_size); \
+  }
+
+#define SET_SHRINK(Type) \
+  wait_set->Type ## s = (const rcl_ ## Type ## _t **)__wait_set_shrink_array( \
+    &allocator, (void *)wait_set->Type ## s, wait_set->size_of_ ## Type ## s, \
+    sizeof(rcl_ ## Type ## _t *)); \
+  wait_set->impl->Type ## _capacity = wait_set->size_of_ ## Type ## s;
+
+#define SET_SHRINK_RMW(Type, RMWStorage) \
+  wait_set->impl->RMWStorage = (void **)__wait_set_shrink_array( \
+    &allocator, wait_set->impl->RMWStorage, wait_set->size_of_ ## Type ## s, sizeof(void *));
 
 /* Implementation-specific notes:
  *
@@ -335,6 +884,7 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set)
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set->impl, RCL_RET_WAIT_SET_INVALID);
+  __wait_set_release_persistent(wait_set);
 
   SET_CLEAR(subscription);
   SET_CLEAR(guard_condition);
@@ -384,72 +934,124 @@ rcl_wait_set_resize(
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set->impl, RCL_RET_WAIT_SET_INVALID);
+  __wait_set_release_persistent(wait_set);
   SET_RESIZE(
     subscription,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count),
-    SET_RESIZE_RMW_REALLOC(
+    SET_RESIZE_RMW_REALLOC(rmw_subscriptions.subscribers),
+    SET_RESIZE_RMW_CLEAR(
       subscription, rmw_subscriptions.subscribers, rmw_subscriptions.subscriber_count)
   );
   // Guard condition RCL size is the resize amount given
   SET_RESIZE(guard_condition,;,;);  // NOLINT
 
   // Guard condition RMW size needs to be guard conditions + timers
-  rmw_guard_conditions_t * rmw_gcs = &(wait_set->impl->rmw_guard_conditions);
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rmw_guard_conditions_t * rmw_gcs = &(impl->rmw_guard_conditions);
   const size_t num_rmw_gc = guard_conditions_size + timers_size;
   // Clear added guard conditions
   rmw_gcs->guard_condition_count = 0u;
-  if (0u == num_rmw_gc) {
-    if (rmw_gcs->guard_conditions) {
-      wait_set->impl->allocator.deallocate(
-        (void *)rmw_gcs->guard_conditions, wait_set->impl->allocator.state);
-      rmw_gcs->guard_conditions = NULL;
-    }
-  } else {
-    rmw_gcs->guard_conditions = (void **)wait_set->impl->allocator.reallocate(
-      rmw_gcs->guard_conditions, sizeof(void *) * num_rmw_gc, wait_set->impl->allocator.state);
-    if (!rmw_gcs->guard_conditions) {
-      // Deallocate rcl arrays to match unallocated rmw guard conditions
-      wait_set->impl->allocator.deallocate(
-        (void *)wait_set->guard_conditions, wait_set->impl->allocator.state);
+  if (num_rmw_gc > impl->rmw_guard_condition_capacity) {
+    const size_t capacity =
+      __wait_set_grown_capacity(impl->rmw_guard_condition_capacity, num_rmw_gc);
+    void * guard_conditions = impl->allocator.reallocate(
+      rmw_gcs->guard_conditions, sizeof(void *) * capacity, impl->allocator.state);
+    if (!guard_conditions) {
+      // Empty the rcl arrays to match the rmw guard conditions which could not be grown
       wait_set->size_of_guard_conditions = 0u;
-      wait_set->guard_conditions = NULL;
-      wait_set->impl->allocator.deallocate(
-        (void *)wait_set->timers, wait_set->impl->allocator.state);
       wait_set->size_of_timers = 0u;
-      wait_set->timers = NULL;
+      impl->timer_index = 0u;
       RCL_SET_ERROR_MSG("allocating memory failed");
       return RCL_RET_BAD_ALLOC;
     }
+    rmw_gcs->guard_conditions = (void **)guard_conditions;
+    impl->rmw_guard_condition_capacity = capacity;
+  }
+  if (0u != num_rmw_gc) {
     memset(rmw_gcs->guard_conditions, 0, sizeof(void *) * num_rmw_gc);
   }
 
-  SET_RESIZE(timer,;,;);  // NOLINT
+  // The timer heaps are grown with the timers, and rebuilt on the next call to rcl_wait().
+  rcl_ret_t ret = RCL_RET_OK;
+  SET_RESIZE(
+    timer,
+    ret = __wait_set_grow_timer_heaps(wait_set, capacity);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    },
+    impl->timer_heap_count = 0u;
+    impl->timer_heaps_valid = false;
+  );
   SET_RESIZE(
     client,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_clients.clients, rmw_clients.client_count),
-    SET_RESIZE_RMW_REALLOC(
-      client, rmw_clients.clients, rmw_clients.client_count)
+    SET_RESIZE_RMW_REALLOC(rmw_clients.clients),
+    SET_RESIZE_RMW_CLEAR(client, rmw_clients.clients, rmw_clients.client_count)
   );
   SET_RESIZE(
     service,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_services.services, rmw_services.service_count),
-    SET_RESIZE_RMW_REALLOC(
-      service, rmw_services.services, rmw_services.service_count)
+    SET_RESIZE_RMW_REALLOC(rmw_services.services),
+    SET_RESIZE_RMW_CLEAR(service, rmw_services.services, rmw_services.service_count)
   );
   SET_RESIZE(
     event,
-    SET_RESIZE_RMW_DEALLOC(
-      rmw_events.events, rmw_events.event_count),
-    SET_RESIZE_RMW_REALLOC(
-      event, rmw_events.events, rmw_events.event_count)
+    SET_RESIZE_RMW_REALLOC(rmw_events.events),
+    SET_RESIZE_RMW_CLEAR(event, rmw_events.events, rmw_events.event_count)
   );
 
   return RCL_RET_OK;
 }
 
+static void
+__wait_set_shrink(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rcl_allocator_t allocator = impl->allocator;
+  SET_SHRINK(subscription)
+  SET_SHRINK_RMW(subscription, rmw_subscriptions.subscribers)
+  SET_SHRINK(guard_condition)
+  SET_SHRINK(timer)
+  SET_SHRINK(client)
+  SET_SHRINK_RMW(client, rmw_clients.clients)
+  SET_SHRINK(service)
+  SET_SHRINK_RMW(service, rmw_services.services)
+  SET_SHRINK(event)
+  SET_SHRINK_RMW(event, rmw_events.events)
+  const size_t num_rmw_gc = wait_set->size_of_guard_conditions + wait_set->size_of_timers;
+  impl->rmw_guard_conditions.guard_conditions = (void **)__wait_set_shrink_array(
+    &allocator, impl->rmw_guard_conditions.guard_conditions, num_rmw_gc, sizeof(void *));
+  impl->rmw_guard_condition_capacity = num_rmw_gc;
+  // The heaps point into their entries, so they are rebuilt on the next call to rcl_wait().
+  impl->timer_heap_count = 0u;
+  impl->timer_heaps_valid = false;
+  const size_t timers_size = wait_set->size_of_timers;
+  impl->timer_heaps = (rcl_wait_set_timer_heap_t *)__wait_set_shrink_array(
+    &allocator, impl->timer_heaps, timers_size, sizeof(rcl_wait_set_timer_heap_t));
+  impl->timer_heap_entries = (rcl_wait_set_timer_heap_entry_t *)__wait_set_shrink_array(
+    &allocator, impl->timer_heap_entries, timers_size, sizeof(rcl_wait_set_timer_heap_entry_t));
+  impl->timer_scratch = (size_t *)__wait_set_shrink_array(
+    &allocator, impl->timer_scratch, timers_size, sizeof(size_t));
+  // Without a snapshot to keep, the persistent storage is deallocated.
+  const size_t persistent_size = impl->persistent ? __wait_set_total_size(wait_set) : 0u;
+  impl->persistent_rmw_storage = (void **)__wait_set_shrink_array(
+    &allocator, (void *)impl->persistent_rmw_storage, persistent_size, sizeof(void *));
+  impl->ready = (bool *)__wait_set_shrink_array(
+    &allocator, impl->ready, persistent_size, sizeof(bool));
+  impl->edge_marks = (uint64_t *)__wait_set_shrink_array(
+    &allocator, impl->edge_marks, persistent_size, sizeof(uint64_t));
+  impl->persistent_capacity = persistent_size;
+}
+
+rcl_ret_t
+rcl_wait_set_shrink_to_fit(rcl_wait_set_t * wait_set)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  __wait_set_shrink(wait_set);
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_wait_set_add_guard_condition(
   rcl_wait_set_t * wait_set,
@@ -518,121 +1120,594 @@ rcl_wait_set_add_event(
   return RCL_RET_OK;
 }
 
-rcl_ret_t
-rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+static void
+__append_ready_entity(
+  rcl_wait_set_ready_entity_t * ready_entities,
+  size_t * ready_count,
+  rcl_wait_set_entity_type_t type,
+  size_t index,
+  bool client_timed_out)
 {
-  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
-  if (!rcl_wait_set_is_valid(wait_set)) {
-    RCL_SET_ERROR_MSG("wait set is invalid");
-    return RCL_RET_WAIT_SET_INVALID;
+  if (NULL != ready_entities) {
+    ready_entities[*ready_count].type = type;
+    ready_entities[*ready_count].index = index;
+    ready_entities[*ready_count].client_timed_out = client_timed_out;
+    ++(*ready_count);
   }
-  if (
-    wait_set->size_of_subscriptions == 0 &&
-    wait_set->size_of_guard_conditions == 0 &&
-    wait_set->size_of_timers == 0 &&
-    wait_set->size_of_clients == 0 &&
-    wait_set->size_of_services == 0 &&
-    wait_set->size_of_events == 0)
-  {
-    RCL_SET_ERROR_MSG("wait set is empty");
-    return RCL_RET_WAIT_SET_EMPTY;
+}
+
+// Number of takes which failed on an entity that can be edge triggered.
+static uint64_t
+__wait_set_take_failed_count(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t type,
+  size_t index)
+{
+  switch (type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      return rcutils_atomic_load_uint64_t(
+        RCL_ATOMIC_UINT64(wait_set->subscriptions[index]->impl->take_failed_count));
+    case RCL_WAIT_SET_CLIENT:
+      return rcutils_atomic_load_uint64_t(
+        RCL_ATOMIC_UINT64(wait_set->clients[index]->impl->take_failed_count));
+    case RCL_WAIT_SET_SERVICE:
+      return rcutils_atomic_load_uint64_t(
+        RCL_ATOMIC_UINT64(wait_set->services[index]->impl->take_failed_count));
+    case RCL_WAIT_SET_EVENT:
+      return rcutils_atomic_load_uint64_t(
+        RCL_ATOMIC_UINT64(wait_set->events[index]->impl->take_failed_count));
+    default:
+      assert(false && "guard conditions and timers are not edge triggered");
+      return 0u;
   }
-  // Calculate the timeout argument.
-  // By default, set the timer to block indefinitely if none of the below conditions are met.
-  rmw_time_t * timeout_argument = NULL;
-  rmw_time_t temporary_timeout_storage;
+}
 
-  bool is_timer_timeout = false;
-  int64_t min_timeout = timeout > 0 ? timeout : INT64_MAX;
-  {  // scope to prevent i from colliding below
-    uint64_t i = 0;
-    for (i = 0; i < wait_set->impl->timer_index; ++i) {
-      if (!wait_set->timers[i]) {
-        continue;  // Skip NULL timers.
-      }
-      rmw_guard_conditions_t * rmw_gcs = &(wait_set->impl->rmw_guard_conditions);
-      size_t gc_idx = wait_set->size_of_guard_conditions + i;
-      if (NULL != rmw_gcs->guard_conditions[gc_idx]) {
-        // This timer has a guard condition, so move it to make a legal wait set.
-        rmw_gcs->guard_conditions[rmw_gcs->guard_condition_count] =
-          rmw_gcs->guard_conditions[gc_idx];
-        ++(rmw_gcs->guard_condition_count);
-      }
-      bool is_canceled = false;
-      rcl_ret_t ret = rcl_timer_is_canceled(wait_set->timers[i], &is_canceled);
-      if (ret != RCL_RET_OK) {
-        return ret;  // The rcl error state should already be set.
-      }
-      if (is_canceled) {
-        wait_set->timers[i] = NULL;
-        continue;
-      }
-      // use timer time to to set the rmw_wait timeout
-      // TODO(sloretz) fix spurious wake-ups on ROS_TIME timers with ROS_TIME enabled
-      int64_t timer_timeout = INT64_MAX;
-      ret = rcl_timer_get_time_until_next_call(wait_set->timers[i], &timer_timeout);
-      if (ret != RCL_RET_OK) {
-        return ret;  // The rcl error state should already be set.
-      }
-      if (timer_timeout < min_timeout) {
-        is_timer_timeout = true;
-        min_timeout = timer_timeout;
-      }
+// Re-arm the entities of one kind on which a take failed since they were reported ready,
+// and compact the rmw storage to the armed ones. Returns the number of armed entities.
+static size_t
+__wait_set_edge_compact(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t type,
+  void ** storage,
+  size_t count)
+{
+  uint64_t * marks = wait_set->impl->edge_marks + __wait_set_entity_offset(wait_set, type);
+  size_t armed = 0u;
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    if (
+      RCL_WAIT_SET_EDGE_ARMED != marks[i] &&
+      marks[i] != __wait_set_take_failed_count(wait_set, type, i))
+    {
+      marks[i] = RCL_WAIT_SET_EDGE_ARMED;
+    }
+    if (RCL_WAIT_SET_EDGE_ARMED == marks[i]) {
+      storage[armed++] = storage[i];
     }
   }
+  return armed;
+}
 
-  if (timeout == 0) {
-    // Then it is non-blocking, so set the temporary storage to 0, 0 and pass it.
-    temporary_timeout_storage.sec = 0;
-    temporary_timeout_storage.nsec = 0;
-    timeout_argument = &temporary_timeout_storage;
-  } else if (timeout > 0 || is_timer_timeout) {
-    // If min_timeout was negative, we need to wake up immediately.
-    if (min_timeout < 0) {
-      min_timeout = 0;
+// Undo __wait_set_edge_compact() after rmw_wait(), moving the armed entities back to their index
+// and leaving the disarmed ones NULL, i.e. not ready.
+static void
+__wait_set_edge_expand(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t type,
+  void ** storage,
+  size_t count,
+  size_t armed)
+{
+  const uint64_t * marks = wait_set->impl->edge_marks + __wait_set_entity_offset(wait_set, type);
+  size_t i;
+  for (i = count; i > 0; --i) {
+    storage[i - 1] = RCL_WAIT_SET_EDGE_ARMED == marks[i - 1] ? storage[--armed] : NULL;
+  }
+}
+
+// Disarm the entities of one kind which rmw_wait() reported ready, remembering their failed take
+// count. Entities ready for another reason, like a client with an expired request, stay armed, as
+// nothing they are waited for was drained.
+static void
+__wait_set_edge_disarm_ready(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t type,
+  void * const * storage,
+  size_t count)
+{
+  uint64_t * marks = wait_set->impl->edge_marks + __wait_set_entity_offset(wait_set, type);
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    if (NULL != storage[i]) {
+      marks[i] = __wait_set_take_failed_count(wait_set, type, i);
     }
-    temporary_timeout_storage.sec = RCL_NS_TO_S(min_timeout);
-    temporary_timeout_storage.nsec = min_timeout % 1000000000;
-    timeout_argument = &temporary_timeout_storage;
   }
-  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
-    !timeout_argument, ROS_PACKAGE_NAME, "Waiting without timeout");
-  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
-    timeout_argument, ROS_PACKAGE_NAME,
-    "Waiting with timeout: %" PRIu64 "s + %" PRIu64 "ns",
-    temporary_timeout_storage.sec, temporary_timeout_storage.nsec);
-  RCUTILS_LOG_DEBUG_NAMED(
-    ROS_PACKAGE_NAME, "Timeout calculated based on next scheduled timer: %s",
-    is_timer_timeout ? "true" : "false");
+}
 
-  // Wait.
-  rmw_ret_t ret = rmw_wait(
-    &wait_set->impl->rmw_subscriptions,
-    &wait_set->impl->rmw_guard_conditions,
-    &wait_set->impl->rmw_services,
-    &wait_set->impl->rmw_clients,
-    &wait_set->impl->rmw_events,
-    wait_set->impl->rmw_wait_set,
-    timeout_argument);
+// Prepare the rmw storage for a call to rmw_wait(), which prunes it, and return the index of the
+// first timer guard condition in the rmw guard conditions.
+// A persistent wait set can be prepared again after rmw_wait(), a default one only once.
+static size_t
+__wait_set_prepare_rmw_storage(rcl_wait_set_t * wait_set)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  // A persistent wait set keeps its entities, so only the rmw storage, which is
+  // pruned by rmw_wait(), has to be rebuilt and that is done from the snapshot.
+  if (impl->persistent) {
+    __wait_set_restore_persistent_storage(wait_set);
+  }
+  // An edge triggered wait set leaves out the entities which are still to be drained.
+  if (impl->edge_triggered) {
+    impl->rmw_subscriptions.subscriber_count = __wait_set_edge_compact(
+      wait_set, RCL_WAIT_SET_SUBSCRIPTION, impl->rmw_subscriptions.subscribers,
+      impl->persistent_subscription_count);
+    impl->rmw_clients.client_count = __wait_set_edge_compact(
+      wait_set, RCL_WAIT_SET_CLIENT, impl->rmw_clients.clients, impl->persistent_client_count);
+    impl->rmw_services.service_count = __wait_set_edge_compact(
+      wait_set, RCL_WAIT_SET_SERVICE, impl->rmw_services.services,
+      impl->persistent_service_count);
+    impl->rmw_events.event_count = __wait_set_edge_compact(
+      wait_set, RCL_WAIT_SET_EVENT, impl->rmw_events.events, impl->persistent_event_count);
+  }
+  rmw_guard_conditions_t * rmw_gcs = &(impl->rmw_guard_conditions);
+  // The timers' guard conditions start here once moved next to the other guard conditions.
+  const size_t timer_guard_conditions_begin = rmw_gcs->guard_condition_count;
+  // The guard conditions shared by timers are kept first, so only they are searched for
+  // duplicates; their number is at most the number of clocks.
+  size_t shared_end = timer_guard_conditions_begin;
+  uint64_t i = 0;
+  for (i = 0; i < wait_set->impl->timer_index; ++i) {
+    if (!wait_set->timers[i]) {
+      continue;  // Skip NULL timers.
+    }
+    size_t gc_idx = wait_set->size_of_guard_conditions + i;
+    void * guard_condition = rmw_gcs->guard_conditions[gc_idx];
+    if (NULL == guard_condition) {
+      continue;
+    }
+    if (rcl_timer_uses_shared_guard_condition(wait_set->timers[i])) {
+      size_t j = timer_guard_conditions_begin;
+      while (j < shared_end && rmw_gcs->guard_conditions[j] != guard_condition) {
+        ++j;
+      }
+      if (j < shared_end) {
+        continue;  // Another timer of the same clock already passes it.
+      }
+      rmw_gcs->guard_conditions[rmw_gcs->guard_condition_count] =
+        rmw_gcs->guard_conditions[shared_end];
+      rmw_gcs->guard_conditions[shared_end] = guard_condition;
+      ++shared_end;
+    } else {
+      // This timer has a guard condition, so move it to make a legal wait set.
+      rmw_gcs->guard_conditions[rmw_gcs->guard_condition_count] = guard_condition;
+    }
+    ++(rmw_gcs->guard_condition_count);
+  }
+  return timer_guard_conditions_begin;
+}
+
+// Relax between two polls of a spinning rcl_wait().
+static void
+__wait_set_spin_relax(rcl_wait_set_spin_relax_t relax)
+{
+  switch (relax) {
+    case RCL_WAIT_SET_SPIN_RELAX_PAUSE:
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+      YieldProcessor();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+      __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+      __asm__ __volatile__ ("yield");
+#endif
+      break;
+    case RCL_WAIT_SET_SPIN_RELAX_YIELD:
+#ifdef _WIN32
+      SwitchToThread();
+#else
+      sched_yield();
+#endif
+      break;
+    default:
+      break;
+  }
+}
+
+#ifdef RCL_ENABLE_STATISTICS
+// Index of the histogram bucket counting a value, see rcl_wait_set_histogram_t.
+static size_t
+__wait_set_histogram_bucket(uint64_t value)
+{
+  const uint64_t sub_bucket_count = UINT64_C(1) << RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS;
+  if (value < sub_bucket_count) {
+    return (size_t)value;
+  }
+  unsigned int exponent = RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS;
+  while (exponent < 63u && (value >> (exponent + 1u)) != 0u) {
+    ++exponent;
+  }
+  if (exponent >= RCL_WAIT_SET_HISTOGRAM_MAX_EXPONENT) {
+    return RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT - 1u;
+  }
+  // The leading bit is implied by the exponent, the next ones select the sub-bucket.
+  const uint64_t sub_bucket =
+    (value >> (exponent - RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS)) & (sub_bucket_count - 1u);
+  return (size_t)(
+    (exponent - RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS + 1u) * sub_bucket_count + sub_bucket);
+}
+#endif
+
+// Start timing a blocking rmw_wait() of a profiled wait set, returns 0 if it is not profiled.
+static rcutils_time_point_value_t
+__wait_set_profile_block_start(const rcl_wait_set_impl_t * impl)
+{
+  rcutils_time_point_value_t start = 0;
+#ifdef RCL_ENABLE_STATISTICS
+  if (impl->profile && rcutils_steady_time_now(&start) != RCUTILS_RET_OK) {
+    start = 0;
+  }
+#else
+  (void)impl;
+#endif
+  return start;
+}
+
+// Count how long a blocking rmw_wait() blocked, and how late it was if it timed out.
+static void
+__wait_set_profile_block_end(
+  rcl_wait_set_impl_t * impl,
+  rcutils_time_point_value_t start,
+  rmw_ret_t ret,
+  const rmw_time_t * timeout_argument)
+{
+#ifdef RCL_ENABLE_STATISTICS
+  rcutils_time_point_value_t end;
+  if (!impl->profile || 0 == start || rcutils_steady_time_now(&end) != RCUTILS_RET_OK) {
+    return;
+  }
+  const uint64_t blocked = end > start ? (uint64_t)(end - start) : 0u;
+  RCL_COUNTER_ADD(impl->profile->blocked[__wait_set_histogram_bucket(blocked)], 1u);
+  if (RMW_RET_TIMEOUT == ret && timeout_argument) {
+    const uint64_t requested =
+      (uint64_t)RCL_S_TO_NS(timeout_argument->sec) + timeout_argument->nsec;
+    const uint64_t overshoot = blocked > requested ? blocked - requested : 0u;
+    RCL_COUNTER_ADD(impl->profile->overshoot[__wait_set_histogram_bucket(overshoot)], 1u);
+  }
+#else
+  (void)impl;
+  (void)start;
+  (void)ret;
+  (void)timeout_argument;
+#endif
+}
+
+// Count what woke a profiled wait set up, given a mask of the kinds of entities found ready.
+static void
+__wait_set_profile_wakeup(rcl_wait_set_impl_t * impl, unsigned int ready_kinds, bool timed_out)
+{
+#ifdef RCL_ENABLE_STATISTICS
+  if (!impl->profile) {
+    return;
+  }
+  if (0u == ready_kinds) {
+    // Nothing is ready, either because the timeout expired or because rmw_wait() returned
+    // early, e.g. for a timer which is not due yet or a guard condition of a removed timer.
+    if (timed_out) {
+      RCL_COUNTER_ADD(impl->profile->timeout_count, 1u);
+    } else {
+      RCL_COUNTER_ADD(impl->profile->spurious_count, 1u);
+    }
+    return;
+  }
+  unsigned int type;
+  for (type = 0u; type < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++type) {
+    if (ready_kinds & (1u << type)) {
+      RCL_COUNTER_ADD(impl->profile->ready_counts[type], 1u);
+    }
+  }
+#else
+  (void)impl;
+  (void)ready_kinds;
+  (void)timed_out;
+#endif
+}
+
+// Get the steady time from which a client in a wait set is ready without a response arriving,
+// see rcl_request_window_get_ready_time(), and the earliest deadline of its requests in flight.
+static void
+__client_get_ready_time(const rcl_client_t * client, int64_t * ready_time, int64_t * deadline)
+{
+  *ready_time = INT64_MAX;
+  *deadline = INT64_MAX;
+  if (!client || !client->impl || !client->impl->request_window) {
+    return;
+  }
+  rcl_request_window_t * window = client->impl->request_window;
+  // Both update the cached earliest deadline, which other threads sending requests update too.
+  rcl_mutex_lock(window->mutex);
+  *ready_time = rcl_request_window_get_ready_time(window);
+  *deadline = rcl_request_window_get_earliest_deadline(window);
+  rcl_mutex_unlock(window->mutex);
+}
+
+// Get the earliest steady time from which a client of a wait set is ready without a response
+// arriving.
+static int64_t
+__wait_set_earliest_client_ready_time(const rcl_wait_set_t * wait_set)
+{
+  int64_t earliest_ready_time = INT64_MAX;
+  size_t i;
+  for (i = 0; i < wait_set->size_of_clients; ++i) {
+    int64_t ready_time;
+    int64_t deadline;
+    __client_get_ready_time(wait_set->clients[i], &ready_time, &deadline);
+    if (ready_time < earliest_ready_time) {
+      earliest_ready_time = ready_time;
+    }
+  }
+  return earliest_ready_time;
+}
+
+// Implementation of rcl_wait(), which optionally fills a compact list of ready entities.
+// If given, ready_entities must have room for every entity in the wait set.
+static rcl_ret_t
+__rcl_wait(
+  rcl_wait_set_t * wait_set,
+  int64_t timeout,
+  rcl_wait_set_ready_entity_t * ready_entities,
+  size_t * ready_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (
+    wait_set->size_of_subscriptions == 0 &&
+    wait_set->size_of_guard_conditions == 0 &&
+    wait_set->size_of_timers == 0 &&
+    wait_set->size_of_clients == 0 &&
+    wait_set->size_of_services == 0 &&
+    wait_set->size_of_events == 0)
+  {
+    RCL_SET_ERROR_MSG("wait set is empty");
+    return RCL_RET_WAIT_SET_EMPTY;
+  }
+  const bool persistent = wait_set->impl->persistent;
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  const bool edge_triggered = impl->edge_triggered;
+  rmw_guard_conditions_t * rmw_gcs = &(impl->rmw_guard_conditions);
+  const size_t timer_guard_conditions_begin = __wait_set_prepare_rmw_storage(wait_set);
+  // Calculate the timeout argument.
+  // By default, set the timer to block indefinitely if none of the below conditions are met.
+  rmw_time_t * timeout_argument = NULL;
+  rmw_time_t temporary_timeout_storage;
+
+  bool is_timer_timeout = false;
+  int64_t min_timeout = timeout > 0 ? timeout : INT64_MAX;
+  // The timers are kept in one heap per clock, so only the earliest timer of each clock has to
+  // be looked at and each clock is read once. A persistent wait set keeps its heaps across calls.
+  rcl_wait_set_timer_heap_t * timer_heaps = wait_set->impl->timer_heaps;
+  if (!persistent || !wait_set->impl->timer_heaps_valid) {
+    rcl_ret_t ret = __wait_set_build_timer_heaps(wait_set);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
+    }
+  }
+  {  // scope to prevent h from colliding below
+    size_t h;
+    for (h = 0; h < wait_set->impl->timer_heap_count; ++h) {
+      rcl_ret_t ret = __timer_heap_update_root(wait_set, &timer_heaps[h]);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      if (0u == timer_heaps[h].size || INT64_MAX == timer_heaps[h].entries[0].key) {
+        continue;  // Only canceled timers.
+      }
+      rcl_time_point_value_t now;
+      ret = rcl_clock_get_now(timer_heaps[h].clock, &now);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      // use timer time to to set the rmw_wait timeout
+      // TODO(sloretz) fix spurious wake-ups on ROS_TIME timers with ROS_TIME enabled
+      int64_t timer_timeout = INT64_MAX;
+      ret = rcl_timer_get_time_until_next_call_at(
+        wait_set->timers[timer_heaps[h].entries[0].timer_index], now, &timer_timeout);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      if (timer_heaps[h].kernel_wakeup) {
+        // Their guard conditions wake the wait set, but a timer which is already due may have
+        // had its trigger consumed by an earlier wait without being called since.
+        if (timer_timeout <= 0) {
+          is_timer_timeout = true;
+          min_timeout = 0;
+        }
+        continue;
+      }
+      // rmw_wait sleeps in wall time, while ROS time may run at another rate.
+      ret = rcl_clock_get_wall_duration(timer_heaps[h].clock, timer_timeout, &timer_timeout);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      if (timer_timeout < min_timeout) {
+        is_timer_timeout = true;
+        min_timeout = timer_timeout;
+      }
+    }
+  }
+  // The requests in flight of the clients expire like timers, on the steady clock, and
+  // responses kept in their request windows can be taken right away.
+  bool is_client_timeout = false;
+  const int64_t client_ready_time = __wait_set_earliest_client_ready_time(wait_set);
+  if (INT64_MAX != client_ready_time) {
+    rcutils_time_point_value_t now;
+    if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+      RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+      return RCL_RET_ERROR;
+    }
+    const int64_t client_timeout = client_ready_time <= now ? 0 : client_ready_time - now;
+    if (client_timeout < min_timeout) {
+      is_client_timeout = true;
+      min_timeout = client_timeout;
+    }
+  }
+
+  if (timeout == 0) {
+    // Then it is non-blocking, so set the temporary storage to 0, 0 and pass it.
+    temporary_timeout_storage.sec = 0;
+    temporary_timeout_storage.nsec = 0;
+    timeout_argument = &temporary_timeout_storage;
+  } else if (timeout > 0 || is_timer_timeout || is_client_timeout) {
+    // If min_timeout was negative, we need to wake up immediately.
+    if (min_timeout < 0) {
+      min_timeout = 0;
+    }
+    temporary_timeout_storage.sec = RCL_NS_TO_S(min_timeout);
+    temporary_timeout_storage.nsec = min_timeout % 1000000000;
+    timeout_argument = &temporary_timeout_storage;
+  }
+  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+    !timeout_argument, ROS_PACKAGE_NAME, "Waiting without timeout");
+  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+    timeout_argument, ROS_PACKAGE_NAME,
+    "Waiting with timeout: %" PRIu64 "s + %" PRIu64 "ns",
+    temporary_timeout_storage.sec, temporary_timeout_storage.nsec);
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Timeout calculated based on next scheduled timer: %s",
+    is_timer_timeout ? "true" : "false");
+  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+    is_client_timeout, ROS_PACKAGE_NAME, "Timeout calculated based on a client request deadline");
+
+  // Wait, polling first if the wait set spins. Each poll prunes the rmw storage, which a
+  // persistent wait set can rebuild from its snapshot.
+  rmw_ret_t ret = RMW_RET_TIMEOUT;
+  if (persistent && impl->spin_budget > 0 && timeout != 0) {
+    rcutils_time_point_value_t start;
+    rcutils_time_point_value_t now;
+    if (rcutils_steady_time_now(&start) != RCUTILS_RET_OK) {
+      RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+      return RCL_RET_ERROR;
+    }
+    rmw_time_t zero_timeout = {0, 0};
+    int64_t elapsed = 0;
+    // The budget never extends the timeout.
+    const int64_t spin_until = (timeout_argument && min_timeout < impl->spin_budget) ?
+      min_timeout : impl->spin_budget;
+    while (true) {
+      ret = rmw_wait(
+        &impl->rmw_subscriptions, rmw_gcs, &impl->rmw_services, &impl->rmw_clients,
+        &impl->rmw_events, impl->rmw_wait_set, &zero_timeout);
+      if (ret != RMW_RET_TIMEOUT) {
+        break;
+      }
+      if (rcutils_steady_time_now(&now) != RCUTILS_RET_OK) {
+        RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+        return RCL_RET_ERROR;
+      }
+      elapsed = now - start;
+      // Rebuild the rmw storage for the next poll, or for blocking.
+      __wait_set_prepare_rmw_storage(wait_set);
+      if (elapsed >= spin_until) {
+        break;
+      }
+      __wait_set_spin_relax(impl->spin_relax);
+    }
+    if (ret == RMW_RET_TIMEOUT && timeout_argument) {
+      // Block only for what is left of the timeout.
+      const int64_t remaining = elapsed < min_timeout ? min_timeout - elapsed : 0;
+      temporary_timeout_storage.sec = RCL_NS_TO_S(remaining);
+      temporary_timeout_storage.nsec = remaining % 1000000000;
+    }
+  }
+  if (ret == RMW_RET_TIMEOUT) {
+    const rcutils_time_point_value_t block_start = __wait_set_profile_block_start(impl);
+    ret = rmw_wait(
+      &wait_set->impl->rmw_subscriptions,
+      &wait_set->impl->rmw_guard_conditions,
+      &wait_set->impl->rmw_services,
+      &wait_set->impl->rmw_clients,
+      &wait_set->impl->rmw_events,
+      wait_set->impl->rmw_wait_set,
+      timeout_argument);
+    __wait_set_profile_block_end(impl, block_start, ret, timeout_argument);
+  }
+  if (edge_triggered) {
+    __wait_set_edge_expand(
+      wait_set, RCL_WAIT_SET_SUBSCRIPTION, impl->rmw_subscriptions.subscribers,
+      impl->persistent_subscription_count, impl->rmw_subscriptions.subscriber_count);
+    __wait_set_edge_expand(
+      wait_set, RCL_WAIT_SET_CLIENT, impl->rmw_clients.clients,
+      impl->persistent_client_count, impl->rmw_clients.client_count);
+    __wait_set_edge_expand(
+      wait_set, RCL_WAIT_SET_SERVICE, impl->rmw_services.services,
+      impl->persistent_service_count, impl->rmw_services.service_count);
+    __wait_set_edge_expand(
+      wait_set, RCL_WAIT_SET_EVENT, impl->rmw_events.events,
+      impl->persistent_event_count, impl->rmw_events.event_count);
+  }
 
   // Items that are not ready will have been set to NULL by rmw_wait.
-  // We now update our handles accordingly.
+  // We now update our handles accordingly, or the readiness flags if persistent.
+  bool * ready = NULL;
+  // bit per rcl_wait_set_entity_type_t of the kinds of entities found ready
+  unsigned int ready_kinds = 0u;
 
   // Check for ready timers
   // and set not ready timers (which includes canceled timers) to NULL.
   size_t i;
-  for (i = 0; i < wait_set->impl->timer_index; ++i) {
-    if (!wait_set->timers[i]) {
-      continue;
+  // A triggered timer guard condition means that a next call time may have moved earlier,
+  // e.g. because the timer was reset or time jumped, which the heaps cannot account for.
+  for (i = timer_guard_conditions_begin; i < rmw_gcs->guard_condition_count; ++i) {
+    if (NULL != rmw_gcs->guard_conditions[i]) {
+      rcl_ret_t ret = __wait_set_build_timer_heaps(wait_set);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      break;
+    }
+  }
+  size_t * ready_timers = wait_set->impl->timer_scratch;
+  size_t ready_timer_count = 0u;
+  // Sample each clock once, so that the timers sharing it are checked against the same instant.
+  for (i = 0; i < wait_set->impl->timer_heap_count; ++i) {
+    if (0u == timer_heaps[i].size || INT64_MAX == timer_heaps[i].entries[0].key) {
+      continue;  // Only canceled timers.
+    }
+    rcl_time_point_value_t now;
+    rcl_ret_t ret = rcl_clock_get_now(timer_heaps[i].clock, &now);
+    if (ret != RCL_RET_OK) {
+      return ret;  // The rcl error state should already be set.
     }
-    bool is_ready = false;
-    rcl_ret_t ret = rcl_timer_is_ready(wait_set->timers[i], &is_ready);
+    ret = __timer_heap_collect_ready(
+      wait_set, &timer_heaps[i], 0, now, ready_timers, &ready_timer_count);
     if (ret != RCL_RET_OK) {
       return ret;  // The rcl error state should already be set.
     }
-    RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Timer in wait set is ready");
-    if (!is_ready) {
-      wait_set->timers[i] = NULL;
+  }
+  if (ready_timer_count > 0u) {
+    ready_kinds |= 1u << RCL_WAIT_SET_TIMER;
+  }
+  if (ready_timer_count > 1u) {
+    qsort(ready_timers, ready_timer_count, sizeof(size_t), __compare_timer_indices);
+  }
+  if (persistent) {
+    ready = __wait_set_ready_flags(wait_set, RCL_WAIT_SET_TIMER);
+    memset(ready, 0, sizeof(bool) * wait_set->size_of_timers);
+  }
+  {  // scope to prevent j from colliding below
+    size_t j = 0u;
+    for (i = 0; i < wait_set->impl->timer_index; ++i) {
+      if (j < ready_timer_count && ready_timers[j] == i) {
+        RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Timer in wait set is ready");
+        __append_ready_entity(ready_entities, ready_count, RCL_WAIT_SET_TIMER, i, false);
+        if (persistent) {
+          ready[i] = true;
+        }
+        ++j;
+      } else if (!persistent) {
+        wait_set->timers[i] = NULL;
+      }
     }
   }
   // Check for timeout, return RCL_RET_TIMEOUT only if it wasn't a timer.
@@ -641,54 +1716,569 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     return RCL_RET_ERROR;
   }
   // Set corresponding rcl subscription handles NULL.
+  if (persistent) {
+    ready = __wait_set_ready_flags(wait_set, RCL_WAIT_SET_SUBSCRIPTION);
+  }
   for (i = 0; i < wait_set->size_of_subscriptions; ++i) {
     bool is_ready = wait_set->impl->rmw_subscriptions.subscribers[i] != NULL;
     RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
       is_ready, ROS_PACKAGE_NAME, "Subscription in wait set is ready");
-    if (!is_ready) {
+    if (is_ready) {
+      __append_ready_entity(ready_entities, ready_count, RCL_WAIT_SET_SUBSCRIPTION, i, false);
+      ready_kinds |= 1u << RCL_WAIT_SET_SUBSCRIPTION;
+    }
+    if (persistent) {
+      ready[i] = is_ready;
+    } else if (!is_ready) {
       wait_set->subscriptions[i] = NULL;
     }
   }
   // Set corresponding rcl guard_condition handles NULL.
+  if (persistent) {
+    ready = __wait_set_ready_flags(wait_set, RCL_WAIT_SET_GUARD_CONDITION);
+  }
   for (i = 0; i < wait_set->size_of_guard_conditions; ++i) {
-    bool is_ready = wait_set->impl->rmw_guard_conditions.guard_conditions[i] != NULL;
+    // Slots past the added guard conditions may hold the timers' guard conditions.
+    bool is_ready =
+      i < wait_set->impl->guard_condition_index &&
+      wait_set->impl->rmw_guard_conditions.guard_conditions[i] != NULL;
     RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
       is_ready, ROS_PACKAGE_NAME, "Guard condition in wait set is ready");
-    if (!is_ready) {
+    if (is_ready) {
+      __append_ready_entity(ready_entities, ready_count, RCL_WAIT_SET_GUARD_CONDITION, i, false);
+      ready_kinds |= 1u << RCL_WAIT_SET_GUARD_CONDITION;
+    }
+    if (persistent) {
+      ready[i] = is_ready;
+    } else if (!is_ready) {
       wait_set->guard_conditions[i] = NULL;
     }
   }
   // Set corresponding rcl client handles NULL.
+  // A client with an expired request is ready too, so that the request can be swept, as is one
+  // with a kept response, so that it can be taken.
+  if (persistent) {
+    ready = __wait_set_ready_flags(wait_set, RCL_WAIT_SET_CLIENT);
+  }
+  rcutils_time_point_value_t client_now = INT64_MIN;
+  if (INT64_MAX != client_ready_time && rcutils_steady_time_now(&client_now) != RCUTILS_RET_OK) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
   for (i = 0; i < wait_set->size_of_clients; ++i) {
-    bool is_ready = wait_set->impl->rmw_clients.clients[i] != NULL;
+    int64_t ready_time;
+    int64_t deadline;
+    __client_get_ready_time(wait_set->clients[i], &ready_time, &deadline);
+    const bool request_timed_out = deadline <= client_now;
+    bool is_ready = wait_set->impl->rmw_clients.clients[i] != NULL || ready_time <= client_now;
     RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Client in wait set is ready");
-    if (!is_ready) {
+    if (is_ready) {
+      __append_ready_entity(ready_entities, ready_count, RCL_WAIT_SET_CLIENT, i, request_timed_out);
+      ready_kinds |= 1u << RCL_WAIT_SET_CLIENT;
+    }
+    if (persistent) {
+      ready[i] = is_ready;
+    } else if (!is_ready) {
       wait_set->clients[i] = NULL;
     }
   }
   // Set corresponding rcl service handles NULL.
+  if (persistent) {
+    ready = __wait_set_ready_flags(wait_set, RCL_WAIT_SET_SERVICE);
+  }
   for (i = 0; i < wait_set->size_of_services; ++i) {
     bool is_ready = wait_set->impl->rmw_services.services[i] != NULL;
     RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Service in wait set is ready");
-    if (!is_ready) {
+    if (is_ready) {
+      __append_ready_entity(ready_entities, ready_count, RCL_WAIT_SET_SERVICE, i, false);
+      ready_kinds |= 1u << RCL_WAIT_SET_SERVICE;
+    }
+    if (persistent) {
+      ready[i] = is_ready;
+    } else if (!is_ready) {
       wait_set->services[i] = NULL;
     }
   }
   // Set corresponding rcl event handles NULL.
+  if (persistent) {
+    ready = __wait_set_ready_flags(wait_set, RCL_WAIT_SET_EVENT);
+  }
   for (i = 0; i < wait_set->size_of_events; ++i) {
     bool is_ready = wait_set->impl->rmw_events.events[i] != NULL;
     RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Event in wait set is ready");
-    if (!is_ready) {
+    if (is_ready) {
+      __append_ready_entity(ready_entities, ready_count, RCL_WAIT_SET_EVENT, i, false);
+      ready_kinds |= 1u << RCL_WAIT_SET_EVENT;
+    }
+    if (persistent) {
+      ready[i] = is_ready;
+    } else if (!is_ready) {
       wait_set->events[i] = NULL;
     }
   }
+  if (edge_triggered) {
+    __wait_set_edge_disarm_ready(
+      wait_set, RCL_WAIT_SET_SUBSCRIPTION, impl->rmw_subscriptions.subscribers,
+      impl->persistent_subscription_count);
+    __wait_set_edge_disarm_ready(
+      wait_set, RCL_WAIT_SET_CLIENT, impl->rmw_clients.clients, impl->persistent_client_count);
+    __wait_set_edge_disarm_ready(
+      wait_set, RCL_WAIT_SET_SERVICE, impl->rmw_services.services,
+      impl->persistent_service_count);
+    __wait_set_edge_disarm_ready(
+      wait_set, RCL_WAIT_SET_EVENT, impl->rmw_events.events, impl->persistent_event_count);
+  }
 
-  if (RMW_RET_TIMEOUT == ret && !is_timer_timeout) {
+  const bool timed_out = RMW_RET_TIMEOUT == ret && !is_timer_timeout && !is_client_timeout;
+  __wait_set_profile_wakeup(impl, ready_kinds, timed_out);
+  if (timed_out) {
     return RCL_RET_TIMEOUT;
   }
   return RCL_RET_OK;
 }
 
+// Wait, accounting for the wait in the counters of the wait set if statistics are enabled.
+static rcl_ret_t
+__rcl_wait_counted(
+  rcl_wait_set_t * wait_set,
+  int64_t timeout,
+  rcl_wait_set_ready_entity_t * ready_entities,
+  size_t * ready_count)
+{
+#ifdef RCL_ENABLE_STATISTICS
+  rcutils_time_point_value_t start;
+  if (!rcl_wait_set_is_valid(wait_set) || rcutils_steady_time_now(&start) != RCUTILS_RET_OK) {
+    return __rcl_wait(wait_set, timeout, ready_entities, ready_count);
+  }
+  rcl_ret_t ret = __rcl_wait(wait_set, timeout, ready_entities, ready_count);
+  rcl_wait_set_counters_t * counters = &wait_set->impl->counters;
+  RCL_COUNTER_ADD(counters->wait_count, 1u);
+  if (RCL_RET_OK == ret) {
+    RCL_COUNTER_ADD(counters->ready_wakeup_count, 1u);
+  } else if (RCL_RET_TIMEOUT == ret) {
+    RCL_COUNTER_ADD(counters->timeout_wakeup_count, 1u);
+  } else {
+    RCL_COUNTER_ADD(counters->error_count, 1u);
+  }
+  rcutils_time_point_value_t end;
+  if (rcutils_steady_time_now(&end) == RCUTILS_RET_OK && end > start) {
+    RCL_COUNTER_ADD(counters->wait_duration_ns, end - start);
+    RCL_COUNTER_STORE_MAX(counters->max_wait_duration_ns, end - start);
+  }
+  return ret;
+#else
+  return __rcl_wait(wait_set, timeout, ready_entities, ready_count);
+#endif
+}
+
+rcl_ret_t
+rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+{
+  return __rcl_wait_counted(wait_set, timeout, NULL, NULL);
+}
+
+rcl_ret_t
+rcl_wait_ex(
+  rcl_wait_set_t * wait_set,
+  int64_t timeout,
+  rcl_wait_set_ready_entity_t * ready_entities,
+  size_t capacity,
+  size_t * ready_count)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_entities, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ready_count, RCL_RET_INVALID_ARGUMENT);
+  if (capacity < __wait_set_total_size(wait_set)) {
+    RCL_SET_ERROR_MSG("ready entities capacity is smaller than the wait set");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  *ready_count = 0u;
+  return __rcl_wait_counted(wait_set, timeout, ready_entities, ready_count);
+}
+
+rcl_ret_t
+rcl_wait_set_persist(rcl_wait_set_t * wait_set)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (impl->persistent) {
+    return RCL_RET_OK;
+  }
+  if (__wait_set_is_pruned(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set was pruned by rcl_wait(), clear it and add its entities again");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  const size_t total_size = __wait_set_total_size(wait_set);
+  if (total_size > impl->persistent_capacity) {
+    rcl_allocator_t allocator = impl->allocator;
+    const size_t capacity = __wait_set_grown_capacity(impl->persistent_capacity, total_size);
+    // Each array which could be grown is kept, the capacity is only updated once all of them are.
+    void * persistent_rmw_storage = allocator.reallocate(
+      (void *)impl->persistent_rmw_storage, sizeof(void *) * capacity, allocator.state);
+    if (persistent_rmw_storage) {
+      impl->persistent_rmw_storage = (void **)persistent_rmw_storage;
+    }
+    void * ready = allocator.reallocate(
+      (void *)impl->ready, sizeof(bool) * capacity, allocator.state);
+    if (ready) {
+      impl->ready = (bool *)ready;
+    }
+    void * edge_marks = allocator.reallocate(
+      (void *)impl->edge_marks, sizeof(uint64_t) * capacity, allocator.state);
+    if (edge_marks) {
+      impl->edge_marks = (uint64_t *)edge_marks;
+    }
+    if (!persistent_rmw_storage || !ready || !edge_marks) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+    impl->persistent_capacity = capacity;
+  }
+  if (0u != total_size) {
+    memset(impl->ready, 0, sizeof(bool) * total_size);
+  }
+  rcl_ret_t ret = __wait_set_snapshot_persistent_storage(wait_set);
+  if (ret != RCL_RET_OK) {
+    return ret;  // The rcl error state should already be set.
+  }
+  impl->persistent = true;
+  return RCL_RET_OK;
+}
+
+bool
+rcl_wait_set_is_persistent(const rcl_wait_set_t * wait_set)
+{
+  return rcl_wait_set_is_valid(wait_set) && wait_set->impl->persistent;
+}
+
+rcl_ret_t
+rcl_wait_set_set_edge_triggered(rcl_wait_set_t * wait_set, bool edge_triggered)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (!edge_triggered || impl->edge_triggered) {
+    impl->edge_triggered = edge_triggered;
+    return RCL_RET_OK;
+  }
+  // The edge marks are allocated along with the persistent snapshot.
+  rcl_ret_t ret = rcl_wait_set_persist(wait_set);
+  if (ret != RCL_RET_OK) {
+    return ret;  // The rcl error state should already be set.
+  }
+  const size_t total_size = __wait_set_total_size(wait_set);
+  size_t i;
+  for (i = 0; i < total_size; ++i) {
+    impl->edge_marks[i] = RCL_WAIT_SET_EDGE_ARMED;
+  }
+  impl->edge_triggered = true;
+  return RCL_RET_OK;
+}
+
+bool
+rcl_wait_set_is_edge_triggered(const rcl_wait_set_t * wait_set)
+{
+  return rcl_wait_set_is_valid(wait_set) && wait_set->impl->edge_triggered;
+}
+
+rcl_ret_t
+rcl_wait_set_set_spin_budget(
+  rcl_wait_set_t * wait_set,
+  int64_t spin_budget,
+  rcl_wait_set_spin_relax_t relax)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  if (spin_budget < 0) {
+    RCL_SET_ERROR_MSG("spin budget must be positive or 0");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (
+    relax != RCL_WAIT_SET_SPIN_RELAX_NONE &&
+    relax != RCL_WAIT_SET_SPIN_RELAX_PAUSE &&
+    relax != RCL_WAIT_SET_SPIN_RELAX_YIELD)
+  {
+    RCL_SET_ERROR_MSG("unknown spin relax strategy");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  wait_set->impl->spin_budget = spin_budget;
+  wait_set->impl->spin_relax = relax;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_get_spin_budget(const rcl_wait_set_t * wait_set, int64_t * spin_budget)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(spin_budget, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  *spin_budget = wait_set->impl->spin_budget;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_get_statistics(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_statistics_t * statistics)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_wait_set_counters_t * counters = &wait_set->impl->counters;
+  statistics->wait_count = RCL_COUNTER_LOAD(counters->wait_count);
+  statistics->ready_wakeup_count = RCL_COUNTER_LOAD(counters->ready_wakeup_count);
+  statistics->timeout_wakeup_count = RCL_COUNTER_LOAD(counters->timeout_wakeup_count);
+  statistics->error_count = RCL_COUNTER_LOAD(counters->error_count);
+  statistics->wait_duration_ns = RCL_COUNTER_LOAD(counters->wait_duration_ns);
+  statistics->max_wait_duration_ns = RCL_COUNTER_LOAD(counters->max_wait_duration_ns);
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+rcl_ret_t
+rcl_wait_set_set_profiling(rcl_wait_set_t * wait_set, bool enabled)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  if (!enabled) {
+    impl->allocator.deallocate(impl->profile, impl->allocator.state);
+    impl->profile = NULL;
+    return RCL_RET_OK;
+  }
+  if (impl->profile) {
+    return RCL_RET_OK;
+  }
+  rcl_wait_set_profile_counters_t * profile = (rcl_wait_set_profile_counters_t *)
+    impl->allocator.allocate(sizeof(rcl_wait_set_profile_counters_t), impl->allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    profile, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  size_t i;
+  for (i = 0u; i < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++i) {
+    RCL_COUNTER_INIT(profile->ready_counts[i]);
+  }
+  RCL_COUNTER_INIT(profile->timeout_count);
+  RCL_COUNTER_INIT(profile->spurious_count);
+  for (i = 0u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    RCL_COUNTER_INIT(profile->blocked[i]);
+    RCL_COUNTER_INIT(profile->overshoot[i]);
+  }
+  impl->profile = profile;
+  return RCL_RET_OK;
+#else
+  (void)enabled;
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+rcl_ret_t
+rcl_wait_set_get_profile(const rcl_wait_set_t * wait_set, rcl_wait_set_profile_t * profile)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(profile, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_wait_set_profile_counters_t * counters = wait_set->impl->profile;
+  if (!counters) {
+    RCL_SET_ERROR_MSG("wait set profiling is not enabled");
+    return RCL_RET_NOT_INIT;
+  }
+  size_t i;
+  for (i = 0u; i < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++i) {
+    profile->ready_counts[i] = RCL_COUNTER_LOAD(counters->ready_counts[i]);
+  }
+  profile->timeout_count = RCL_COUNTER_LOAD(counters->timeout_count);
+  profile->spurious_count = RCL_COUNTER_LOAD(counters->spurious_count);
+  for (i = 0u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    profile->blocked.counts[i] = RCL_COUNTER_LOAD(counters->blocked[i]);
+    profile->overshoot.counts[i] = RCL_COUNTER_LOAD(counters->overshoot[i]);
+  }
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+rcl_ret_t
+rcl_wait_set_reset_profile(rcl_wait_set_t * wait_set)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+#ifdef RCL_ENABLE_STATISTICS
+  rcl_wait_set_profile_counters_t * counters = wait_set->impl->profile;
+  if (!counters) {
+    RCL_SET_ERROR_MSG("wait set profiling is not enabled");
+    return RCL_RET_NOT_INIT;
+  }
+  size_t i;
+  for (i = 0u; i < RCL_WAIT_SET_ENTITY_TYPE_COUNT; ++i) {
+    RCL_COUNTER_RESET(counters->ready_counts[i]);
+  }
+  RCL_COUNTER_RESET(counters->timeout_count);
+  RCL_COUNTER_RESET(counters->spurious_count);
+  for (i = 0u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    RCL_COUNTER_RESET(counters->blocked[i]);
+    RCL_COUNTER_RESET(counters->overshoot[i]);
+  }
+  return RCL_RET_OK;
+#else
+  RCL_SET_ERROR_MSG("rcl was built without statistics");
+  return RCL_RET_UNSUPPORTED;
+#endif
+}
+
+uint64_t
+rcl_wait_set_histogram_bucket_lower_bound(size_t bucket)
+{
+  const size_t sub_bucket_count = (size_t)1u << RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS;
+  if (bucket >= RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT) {
+    return UINT64_MAX;
+  }
+  if (bucket < sub_bucket_count) {
+    return (uint64_t)bucket;
+  }
+  // The inverse of __wait_set_histogram_bucket(): the leading bit followed by the sub-bucket.
+  const unsigned int exponent =
+    (unsigned int)(bucket / sub_bucket_count) + RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS - 1u;
+  const uint64_t sub_bucket = (uint64_t)(bucket % sub_bucket_count);
+  return (sub_bucket_count + sub_bucket) << (exponent - RCL_WAIT_SET_HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+rcl_ret_t
+rcl_wait_set_histogram_percentile(
+  const rcl_wait_set_histogram_t * histogram,
+  double percentile,
+  uint64_t * value)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(histogram, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(value, RCL_RET_INVALID_ARGUMENT);
+  if (!(percentile >= 0.0 && percentile <= 100.0)) {
+    RCL_SET_ERROR_MSG("percentile must be between 0 and 100");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  uint64_t total = 0u;
+  size_t i;
+  for (i = 0u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    total += histogram->counts[i];
+  }
+  *value = 0u;
+  if (0u == total) {
+    return RCL_RET_OK;
+  }
+  // Rank of the value holding the percentile, counting from 1.
+  uint64_t rank = (uint64_t)((percentile / 100.0) * (double)total + 0.5);
+  if (rank < 1u) {
+    rank = 1u;
+  } else if (rank > total) {
+    rank = total;
+  }
+  uint64_t seen = 0u;
+  for (i = 0u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    seen += histogram->counts[i];
+    if (seen >= rank) {
+      break;
+    }
+  }
+  if (i + 1u < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT) {
+    *value = rcl_wait_set_histogram_bucket_lower_bound(i + 1u) - 1u;
+  } else {
+    *value = rcl_wait_set_histogram_bucket_lower_bound(i);
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_is_ready(
+  const rcl_wait_set_t * wait_set,
+  rcl_wait_set_entity_type_t type,
+  size_t index,
+  bool * is_ready)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_wait_set_is_valid(wait_set)) {
+    RCL_SET_ERROR_MSG("wait set is invalid");
+    return RCL_RET_WAIT_SET_INVALID;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(is_ready, RCL_RET_INVALID_ARGUMENT);
+  size_t size = 0;
+  const void * entity = NULL;
+  switch (type) {
+    case RCL_WAIT_SET_SUBSCRIPTION:
+      size = wait_set->size_of_subscriptions;
+      entity = index < size ? wait_set->subscriptions[index] : NULL;
+      break;
+    case RCL_WAIT_SET_GUARD_CONDITION:
+      size = wait_set->size_of_guard_conditions;
+      entity = index < size ? wait_set->guard_conditions[index] : NULL;
+      break;
+    case RCL_WAIT_SET_TIMER:
+      size = wait_set->size_of_timers;
+      entity = index < size ? wait_set->timers[index] : NULL;
+      break;
+    case RCL_WAIT_SET_CLIENT:
+      size = wait_set->size_of_clients;
+      entity = index < size ? wait_set->clients[index] : NULL;
+      break;
+    case RCL_WAIT_SET_SERVICE:
+      size = wait_set->size_of_services;
+      entity = index < size ? wait_set->services[index] : NULL;
+      break;
+    case RCL_WAIT_SET_EVENT:
+      size = wait_set->size_of_events;
+      entity = index < size ? wait_set->events[index] : NULL;
+      break;
+    default:
+      RCL_SET_ERROR_MSG("unknown wait set entity type");
+      return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (index >= size) {
+    RCL_SET_ERROR_MSG("index is out of range");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (wait_set->impl->persistent) {
+    *is_ready = __wait_set_ready_flags(wait_set, type)[index];
+  } else {
+    *is_ready = NULL != entity;
+  }
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
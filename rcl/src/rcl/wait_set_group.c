@@ -0,0 +1,596 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/wait_set_group.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcl/error_handling.h"
+#include "rcl/guard_condition.h"
+#include "rcutils/logging_macros.h"
+#include "rcutils/stdatomic_helper.h"
+
+// Number of kinds of entities in rcl_wait_set_entity_type_t.
+#define RCL_WAIT_SET_GROUP_KIND_COUNT 6
+
+// An entity of the group, or a free entry if entity is NULL.
+typedef struct rcl_wait_set_group_entry_t
+{
+  rcl_wait_set_entity_type_t type;
+  const void * entity;
+  size_t shard;
+  // true from the time the entity is queued until its work is done
+  atomic_bool queued;
+} rcl_wait_set_group_entry_t;
+
+// Cell of a bounded multi-producer multi-consumer queue, in the style of D. Vyukov's.
+// The sequence tells whether the cell is free for the enqueue at that position, or holds the
+// entry for the dequeue at the position before it.
+typedef struct rcl_wait_set_group_cell_t
+{
+  atomic_uint_least64_t sequence;
+  size_t entry;
+} rcl_wait_set_group_cell_t;
+
+typedef struct rcl_wait_set_group_shard_t
+{
+  rcl_wait_set_t wait_set;
+  // wakes up the wait on this shard, always the first guard condition in its wait set
+  rcl_guard_condition_t guard_condition;
+  // entries of the group in this shard
+  size_t * members;
+  size_t member_count;
+  // entries added to the wait set by the last wait, in order
+  size_t * waited;
+  // number of members of each kind
+  size_t kind_counts[RCL_WAIT_SET_GROUP_KIND_COUNT];
+  // queue of ready entries, with room for every member
+  rcl_wait_set_group_cell_t * cells;
+  size_t cell_count;
+  atomic_uint_least64_t enqueue_position;
+  atomic_uint_least64_t dequeue_position;
+} rcl_wait_set_group_shard_t;
+
+typedef struct rcl_wait_set_group_impl_t
+{
+  rcl_allocator_t allocator;
+  rcl_context_t * context;
+  rcl_wait_set_group_entry_t * entries;
+  size_t entry_count;
+  rcl_wait_set_group_shard_t * shards;
+} rcl_wait_set_group_impl_t;
+
+rcl_wait_set_group_t
+rcl_get_zero_initialized_wait_set_group(void)
+{
+  static rcl_wait_set_group_t null_group = {0, NULL};
+  return null_group;
+}
+
+static bool
+__group_enqueue(rcl_wait_set_group_shard_t * shard, size_t entry)
+{
+  const uint64_t mask = shard->cell_count - 1u;
+  uint64_t position = rcutils_atomic_load_uint64_t(&shard->enqueue_position);
+  rcl_wait_set_group_cell_t * cell;
+  for (;;) {
+    cell = &shard->cells[position & mask];
+    const int64_t diff =
+      (int64_t)(rcutils_atomic_load_uint64_t(&cell->sequence) - position);
+    if (0 == diff) {
+      bool success = false;
+      rcutils_atomic_compare_exchange_strong(
+        &shard->enqueue_position, success, &position, position + 1u);
+      if (success) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // Full.
+    } else {
+      position = rcutils_atomic_load_uint64_t(&shard->enqueue_position);
+    }
+  }
+  cell->entry = entry;
+  rcutils_atomic_store(&cell->sequence, position + 1u);
+  return true;
+}
+
+static bool
+__group_dequeue(rcl_wait_set_group_shard_t * shard, size_t * entry)
+{
+  if (0u == shard->cell_count) {
+    return false;
+  }
+  const uint64_t mask = shard->cell_count - 1u;
+  uint64_t position = rcutils_atomic_load_uint64_t(&shard->dequeue_position);
+  rcl_wait_set_group_cell_t * cell;
+  for (;;) {
+    cell = &shard->cells[position & mask];
+    const int64_t diff =
+      (int64_t)(rcutils_atomic_load_uint64_t(&cell->sequence) - (position + 1u));
+    if (0 == diff) {
+      bool success = false;
+      rcutils_atomic_compare_exchange_strong(
+        &shard->dequeue_position, success, &position, position + 1u);
+      if (success) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // Empty.
+    } else {
+      position = rcutils_atomic_load_uint64_t(&shard->dequeue_position);
+    }
+  }
+  *entry = cell->entry;
+  rcutils_atomic_store(&cell->sequence, position + mask + 1u);
+  return true;
+}
+
+// Rebuild the queue of a shard with room for at least min_cells entries, keeping the queued
+// entries except the one given, if any. Only called while no other thread uses the group,
+// with shard->waited large enough to hold every queued entry.
+static rcl_ret_t
+__group_rebuild_queue(
+  rcl_wait_set_group_impl_t * impl,
+  rcl_wait_set_group_shard_t * shard,
+  size_t min_cells,
+  size_t removed_entry)
+{
+  size_t cell_count = shard->cell_count;
+  while (cell_count < min_cells) {
+    cell_count = cell_count ? 2u * cell_count : 4u;
+  }
+  rcl_wait_set_group_cell_t * cells = shard->cells;
+  if (cell_count != shard->cell_count) {
+    cells = impl->allocator.allocate(
+      cell_count * sizeof(rcl_wait_set_group_cell_t), impl->allocator.state);
+    if (NULL == cells) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+  }
+  // Drain the old queue in order, then lay the kept entries out from the start.
+  size_t kept = 0u;
+  size_t entry;
+  while (__group_dequeue(shard, &entry)) {
+    if (entry != removed_entry) {
+      shard->waited[kept++] = entry;
+    }
+  }
+  size_t i;
+  for (i = 0u; i < cell_count; ++i) {
+    if (i < kept) {
+      cells[i].entry = shard->waited[i];
+      atomic_init(&cells[i].sequence, i + 1u);
+    } else {
+      atomic_init(&cells[i].sequence, i);
+    }
+  }
+  if (cells != shard->cells) {
+    impl->allocator.deallocate(shard->cells, impl->allocator.state);
+  }
+  shard->cells = cells;
+  shard->cell_count = cell_count;
+  atomic_init(&shard->enqueue_position, kept);
+  atomic_init(&shard->dequeue_position, 0u);
+  return RCL_RET_OK;
+}
+
+// Size the wait set of a shard for all its members and its own guard condition.
+static rcl_ret_t
+__group_resize_wait_set(rcl_wait_set_group_shard_t * shard)
+{
+  const size_t * counts = shard->kind_counts;
+  return rcl_wait_set_resize(
+    &shard->wait_set,
+    counts[RCL_WAIT_SET_SUBSCRIPTION],
+    counts[RCL_WAIT_SET_GUARD_CONDITION] + 1u,
+    counts[RCL_WAIT_SET_TIMER],
+    counts[RCL_WAIT_SET_CLIENT],
+    counts[RCL_WAIT_SET_SERVICE],
+    counts[RCL_WAIT_SET_EVENT]);
+}
+
+rcl_ret_t
+rcl_wait_set_group_init(
+  rcl_wait_set_group_t * group,
+  size_t shard_count,
+  rcl_context_t * context,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(&allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  if (NULL != group->impl) {
+    RCL_SET_ERROR_MSG("wait set group already initialized, or memory was uninitialized.");
+    return RCL_RET_ALREADY_INIT;
+  }
+  if (0u == shard_count) {
+    RCL_SET_ERROR_MSG("shard_count must be at least 1");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (!rcl_context_is_valid(context)) {
+    RCL_SET_ERROR_MSG(
+      "the given context is not valid, "
+      "either rcl_init() was not called or rcl_shutdown() was called.");
+    return RCL_RET_NOT_INIT;
+  }
+  rcl_wait_set_group_impl_t * impl =
+    allocator.zero_allocate(1, sizeof(rcl_wait_set_group_impl_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  impl->allocator = allocator;
+  impl->context = context;
+  impl->shards =
+    allocator.zero_allocate(shard_count, sizeof(rcl_wait_set_group_shard_t), allocator.state);
+  if (NULL == impl->shards) {
+    allocator.deallocate(impl, allocator.state);
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  group->impl = impl;
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t s;
+  for (s = 0u; s < shard_count; ++s) {
+    rcl_wait_set_group_shard_t * shard = &impl->shards[s];
+    shard->wait_set = rcl_get_zero_initialized_wait_set();
+    shard->guard_condition = rcl_get_zero_initialized_guard_condition();
+    atomic_init(&shard->enqueue_position, 0u);
+    atomic_init(&shard->dequeue_position, 0u);
+    group->shard_count = s + 1u;
+    ret = rcl_wait_set_init(&shard->wait_set, 0u, 1u, 0u, 0u, 0u, 0u, context, allocator);
+    if (RCL_RET_OK != ret) {
+      break;
+    }
+    rcl_guard_condition_options_t options = rcl_guard_condition_get_default_options();
+    options.allocator = allocator;
+    ret = rcl_guard_condition_init(&shard->guard_condition, context, options);
+    if (RCL_RET_OK != ret) {
+      break;
+    }
+  }
+  if (RCL_RET_OK != ret) {
+    if (RCL_RET_OK != rcl_wait_set_group_fini(group)) {
+      RCUTILS_LOG_ERROR_NAMED(
+        ROS_PACKAGE_NAME, "Failed to fini wait set group after init failure");
+    }
+    return ret;  // rcl error state should already be set.
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_group_fini(rcl_wait_set_group_t * group)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  rcl_wait_set_group_impl_t * impl = group->impl;
+  if (NULL == impl) {
+    return RCL_RET_OK;
+  }
+  rcl_allocator_t allocator = impl->allocator;
+  rcl_ret_t result = RCL_RET_OK;
+  size_t s;
+  for (s = 0u; s < group->shard_count; ++s) {
+    rcl_wait_set_group_shard_t * shard = &impl->shards[s];
+    if (RCL_RET_OK != rcl_wait_set_fini(&shard->wait_set)) {
+      result = RCL_RET_ERROR;
+    }
+    if (RCL_RET_OK != rcl_guard_condition_fini(&shard->guard_condition)) {
+      result = RCL_RET_ERROR;
+    }
+    allocator.deallocate(shard->members, allocator.state);
+    allocator.deallocate(shard->waited, allocator.state);
+    allocator.deallocate(shard->cells, allocator.state);
+  }
+  allocator.deallocate(impl->shards, allocator.state);
+  allocator.deallocate(impl->entries, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+  *group = rcl_get_zero_initialized_wait_set_group();
+  return result;
+}
+
+rcl_ret_t
+rcl_wait_set_group_add(
+  rcl_wait_set_group_t * group,
+  rcl_wait_set_entity_type_t type,
+  const void * entity,
+  size_t * shard_index)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    group->impl, "wait set group is invalid", return RCL_RET_WAIT_SET_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(entity, RCL_RET_INVALID_ARGUMENT);
+  if ((size_t)type >= RCL_WAIT_SET_GROUP_KIND_COUNT) {
+    RCL_SET_ERROR_MSG("unknown entity type");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_group_impl_t * impl = group->impl;
+  rcl_allocator_t * allocator = &impl->allocator;
+  // Reuse a free entry, or append one.
+  size_t e;
+  size_t free_entry = impl->entry_count;
+  for (e = 0u; e < impl->entry_count; ++e) {
+    if (impl->entries[e].entity == entity && impl->entries[e].type == type) {
+      RCL_SET_ERROR_MSG("entity already in the wait set group");
+      return RCL_RET_INVALID_ARGUMENT;
+    }
+    if (NULL == impl->entries[e].entity && free_entry == impl->entry_count) {
+      free_entry = e;
+    }
+  }
+  if (free_entry == impl->entry_count) {
+    rcl_wait_set_group_entry_t * entries = allocator->reallocate(
+      impl->entries, (impl->entry_count + 1u) * sizeof(rcl_wait_set_group_entry_t),
+      allocator->state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      entries, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    impl->entries = entries;
+    entries[free_entry].entity = NULL;
+    ++(impl->entry_count);
+  }
+  // Pick the shard with the fewest members.
+  size_t s;
+  size_t chosen = 0u;
+  for (s = 1u; s < group->shard_count; ++s) {
+    if (impl->shards[s].member_count < impl->shards[chosen].member_count) {
+      chosen = s;
+    }
+  }
+  rcl_wait_set_group_shard_t * shard = &impl->shards[chosen];
+  const size_t member_count = shard->member_count + 1u;
+  size_t * members = allocator->reallocate(
+    shard->members, member_count * sizeof(size_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    members, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  shard->members = members;
+  size_t * waited = allocator->reallocate(
+    shard->waited, member_count * sizeof(size_t), allocator->state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    waited, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  shard->waited = waited;
+  rcl_ret_t ret = __group_rebuild_queue(impl, shard, member_count, SIZE_MAX);
+  if (RCL_RET_OK != ret) {
+    return ret;  // rcl error state should already be set.
+  }
+  ++(shard->kind_counts[type]);
+  ret = __group_resize_wait_set(shard);
+  if (RCL_RET_OK != ret) {
+    --(shard->kind_counts[type]);
+    return ret;  // rcl error state should already be set.
+  }
+  rcl_wait_set_group_entry_t * entry = &impl->entries[free_entry];
+  entry->type = type;
+  entry->entity = entity;
+  entry->shard = chosen;
+  atomic_init(&entry->queued, false);
+  members[shard->member_count] = free_entry;
+  shard->member_count = member_count;
+  if (NULL != shard_index) {
+    *shard_index = chosen;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_group_remove(
+  rcl_wait_set_group_t * group,
+  rcl_wait_set_entity_type_t type,
+  const void * entity)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    group->impl, "wait set group is invalid", return RCL_RET_WAIT_SET_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(entity, RCL_RET_INVALID_ARGUMENT);
+  rcl_wait_set_group_impl_t * impl = group->impl;
+  size_t e;
+  for (e = 0u; e < impl->entry_count; ++e) {
+    if (impl->entries[e].entity == entity && impl->entries[e].type == type) {
+      break;
+    }
+  }
+  if (e == impl->entry_count) {
+    RCL_SET_ERROR_MSG("entity not in the wait set group");
+    return RCL_RET_ERROR;
+  }
+  rcl_wait_set_group_shard_t * shard = &impl->shards[impl->entries[e].shard];
+  size_t m;
+  for (m = 0u; m < shard->member_count; ++m) {
+    if (shard->members[m] == e) {
+      shard->members[m] = shard->members[--(shard->member_count)];
+      break;
+    }
+  }
+  --(shard->kind_counts[type]);
+  rcl_ret_t ret = __group_rebuild_queue(impl, shard, shard->member_count, e);
+  if (RCL_RET_OK != ret) {
+    return ret;  // rcl error state should already be set.
+  }
+  impl->entries[e].entity = NULL;
+  return __group_resize_wait_set(shard);
+}
+
+rcl_ret_t
+rcl_wait_set_group_interrupt(rcl_wait_set_group_t * group)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    group->impl, "wait set group is invalid", return RCL_RET_WAIT_SET_INVALID);
+  size_t s;
+  for (s = 0u; s < group->shard_count; ++s) {
+    rcl_ret_t ret = rcl_trigger_guard_condition(&group->impl->shards[s].guard_condition);
+    if (RCL_RET_OK != ret) {
+      return ret;  // rcl error state should already be set.
+    }
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_group_wait(
+  rcl_wait_set_group_t * group,
+  size_t shard_index,
+  int64_t timeout)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    group->impl, "wait set group is invalid", return RCL_RET_WAIT_SET_INVALID);
+  if (shard_index >= group->shard_count) {
+    RCL_SET_ERROR_MSG("shard index out of range");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_group_impl_t * impl = group->impl;
+  rcl_wait_set_group_shard_t * shard = &impl->shards[shard_index];
+  rcl_wait_set_t * wait_set = &shard->wait_set;
+  rcl_ret_t ret = rcl_wait_set_clear(wait_set);
+  if (RCL_RET_OK != ret) {
+    return ret;  // rcl error state should already be set.
+  }
+  ret = rcl_wait_set_add_guard_condition(wait_set, &shard->guard_condition, NULL);
+  if (RCL_RET_OK != ret) {
+    return ret;  // rcl error state should already be set.
+  }
+  // Entities whose work is not done yet are left out, or they would wake the wait at once.
+  size_t waited_count = 0u;
+  size_t m;
+  for (m = 0u; m < shard->member_count; ++m) {
+    rcl_wait_set_group_entry_t * entry = &impl->entries[shard->members[m]];
+    if (rcutils_atomic_load_bool(&entry->queued)) {
+      continue;
+    }
+    switch (entry->type) {
+      case RCL_WAIT_SET_SUBSCRIPTION:
+        ret = rcl_wait_set_add_subscription(wait_set, entry->entity, NULL);
+        break;
+      case RCL_WAIT_SET_GUARD_CONDITION:
+        ret = rcl_wait_set_add_guard_condition(wait_set, entry->entity, NULL);
+        break;
+      case RCL_WAIT_SET_TIMER:
+        ret = rcl_wait_set_add_timer(wait_set, entry->entity, NULL);
+        break;
+      case RCL_WAIT_SET_CLIENT:
+        ret = rcl_wait_set_add_client(wait_set, entry->entity, NULL);
+        break;
+      case RCL_WAIT_SET_SERVICE:
+        ret = rcl_wait_set_add_service(wait_set, entry->entity, NULL);
+        break;
+      case RCL_WAIT_SET_EVENT:
+        ret = rcl_wait_set_add_event(wait_set, entry->entity, NULL);
+        break;
+      default:
+        RCL_SET_ERROR_MSG("unknown entity type");
+        ret = RCL_RET_ERROR;
+        break;
+    }
+    if (RCL_RET_OK != ret) {
+      return ret;  // rcl error state should already be set.
+    }
+    shard->waited[waited_count++] = shard->members[m];
+  }
+  ret = rcl_wait(wait_set, timeout);
+  if (RCL_RET_OK != ret) {
+    return ret;  // Timeout, or the rcl error state should already be set.
+  }
+  // The entities were added to the wait set in the order of waited, so walk it again with
+  // one index per kind to find them; the first guard condition is the one of the shard.
+  size_t kind_index[RCL_WAIT_SET_GROUP_KIND_COUNT] = {0u};
+  kind_index[RCL_WAIT_SET_GUARD_CONDITION] = 1u;
+  size_t w;
+  for (w = 0u; w < waited_count; ++w) {
+    rcl_wait_set_group_entry_t * entry = &impl->entries[shard->waited[w]];
+    const size_t i = kind_index[entry->type]++;
+    bool is_ready = false;
+    ret = rcl_wait_set_is_ready(wait_set, entry->type, i, &is_ready);
+    if (RCL_RET_OK != ret) {
+      return ret;  // rcl error state should already be set.
+    }
+    if (!is_ready) {
+      continue;
+    }
+    rcutils_atomic_store(&entry->queued, true);
+    if (!__group_enqueue(shard, shard->waited[w])) {
+      // Cannot happen, as the queue has room for every member and each is queued once.
+      rcutils_atomic_store(&entry->queued, false);
+      RCL_SET_ERROR_MSG("ready queue of the shard is full");
+      return RCL_RET_ERROR;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_group_take_work(
+  rcl_wait_set_group_t * group,
+  size_t shard_index,
+  rcl_wait_set_group_work_t * work,
+  bool * taken)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    group->impl, "wait set group is invalid", return RCL_RET_WAIT_SET_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(work, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(taken, RCL_RET_INVALID_ARGUMENT);
+  if (shard_index >= group->shard_count) {
+    RCL_SET_ERROR_MSG("shard index out of range");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_wait_set_group_impl_t * impl = group->impl;
+  *taken = false;
+  // Own queue first, then steal from the next shards in turn.
+  size_t k;
+  for (k = 0u; k < group->shard_count; ++k) {
+    size_t s = (shard_index + k) % group->shard_count;
+    size_t e;
+    if (__group_dequeue(&impl->shards[s], &e)) {
+      work->type = impl->entries[e].type;
+      work->entity = impl->entries[e].entity;
+      work->shard = s;
+      work->entry = e;
+      *taken = true;
+      break;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_wait_set_group_work_done(
+  rcl_wait_set_group_t * group,
+  size_t shard_index,
+  const rcl_wait_set_group_work_t * work)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(group, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    group->impl, "wait set group is invalid", return RCL_RET_WAIT_SET_INVALID);
+  RCL_CHECK_ARGUMENT_FOR_NULL(work, RCL_RET_INVALID_ARGUMENT);
+  rcl_wait_set_group_impl_t * impl = group->impl;
+  if (work->entry >= impl->entry_count || work->shard >= group->shard_count) {
+    RCL_SET_ERROR_MSG("work does not belong to this wait set group");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcutils_atomic_store(&impl->entries[work->entry].queued, false);
+  if (work->shard != shard_index) {
+    // The owner may be blocked waiting without this entity.
+    return rcl_trigger_guard_condition(&impl->shards[work->shard].guard_condition);
+  }
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
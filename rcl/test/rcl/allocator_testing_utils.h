@@ -161,6 +161,62 @@ set_time_bombed_allocator_count(rcutils_allocator_t & time_bombed_allocator, int
   ((time_bomb_allocator_state *)time_bombed_allocator.state)->count_until_failure = count;
 }
 
+typedef struct counting_allocator_state
+{
+  size_t allocations;
+} counting_allocator_state;
+
+static void *
+counting_malloc(size_t size, void * state)
+{
+  ++((counting_allocator_state *)state)->allocations;
+  return rcutils_get_default_allocator().allocate(size, rcutils_get_default_allocator().state);
+}
+
+static void *
+counting_realloc(void * pointer, size_t size, void * state)
+{
+  ++((counting_allocator_state *)state)->allocations;
+  return rcutils_get_default_allocator().reallocate(
+    pointer, size, rcutils_get_default_allocator().state);
+}
+
+static void
+counting_free(void * pointer, void * state)
+{
+  (void)state;
+  rcutils_get_default_allocator().deallocate(pointer, rcutils_get_default_allocator().state);
+}
+
+static void *
+counting_calloc(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  ++((counting_allocator_state *)state)->allocations;
+  return rcutils_get_default_allocator().zero_allocate(
+    number_of_elements, size_of_element, rcutils_get_default_allocator().state);
+}
+
+/// Get an allocator which counts the allocations and reallocations done with it.
+static inline rcutils_allocator_t
+get_counting_allocator(void)
+{
+  static counting_allocator_state state;
+  state.allocations = 0u;
+  auto counting_allocator = rcutils_get_default_allocator();
+  counting_allocator.allocate = counting_malloc;
+  counting_allocator.deallocate = counting_free;
+  counting_allocator.reallocate = counting_realloc;
+  counting_allocator.zero_allocate = counting_calloc;
+  counting_allocator.state = &state;
+  return counting_allocator;
+}
+
+static inline size_t
+get_counting_allocator_allocations(const rcutils_allocator_t & counting_allocator)
+{
+  return ((counting_allocator_state *)counting_allocator.state)->allocations;
+}
+
 #ifdef __cplusplus
 }
 #endif
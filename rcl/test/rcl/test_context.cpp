@@ -147,6 +147,23 @@ TEST_F(CLASSNAME(TestContextFixture, RMW_IMPLEMENTATION), nominal) {
   EXPECT_NE(rmw_context_ptr, nullptr) << rcl_get_error_string().str;
   rcl_reset_error();
 
+  // test rcl_context_get_ros_clock
+  rcl_clock_t * ros_clock_ptr;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ros_clock_ptr = rcl_context_get_ros_clock(nullptr);
+  });
+  EXPECT_EQ(ros_clock_ptr, nullptr);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ros_clock_ptr = rcl_context_get_ros_clock(&context);
+  });
+  ASSERT_NE(ros_clock_ptr, nullptr) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_ROS_TIME, ros_clock_ptr->type);
+
   ret = rcl_init_options_fini(&init_options);
   EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
 }
@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <sstream>
+#include <vector>
+
 #include "rcl/publisher.h"
 
 #include "rcl/rcl.h"
@@ -24,6 +28,7 @@
 #include "mimick/mimick.h"
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
 #include "rcl/error_handling.h"
+#include "rcutils/logging_macros.h"
 #include "rmw/validate_full_topic_name.h"
 #include "rmw/validate_node_name.h"
 
@@ -370,6 +375,90 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_loan)
   }
 }
 
+/* Test loaning the messages of a publisher message pool.
+ */
+TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_message_pool) {
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  constexpr char topic_name[] = "chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.qos.depth = 2;
+  rcl_ret_t ret =
+    rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_message_init_function_t init_function = [](void * msg) {
+      return test_msgs__msg__Strings__init(static_cast<test_msgs__msg__Strings *>(msg));
+    };
+  rcl_message_fini_function_t fini_function = [](void * msg) {
+      test_msgs__msg__Strings__fini(static_cast<test_msgs__msg__Strings *>(msg));
+    };
+  EXPECT_EQ(
+    RCL_RET_PUBLISHER_INVALID, rcl_publisher_init_message_pool(
+      nullptr, sizeof(test_msgs__msg__Strings), init_function, fini_function, 0u));
+  rcl_reset_error();
+  const bool middleware_loans = rcl_publisher_can_loan_messages(&publisher);
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_publisher_has_message_pool(&publisher));
+  ret = rcl_publisher_init_message_pool(
+    &publisher, sizeof(test_msgs__msg__Strings), init_function, fini_function, 0u);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  if (middleware_loans) {
+    // No pool is needed, the loans of the middleware are covered by test_publisher_loan.
+    EXPECT_FALSE(rcl_publisher_has_message_pool(&publisher));
+    return;
+  }
+  EXPECT_TRUE(rcl_publisher_has_message_pool(&publisher));
+  EXPECT_FALSE(rcl_publisher_can_loan_messages(&publisher));
+  EXPECT_EQ(
+    RCL_RET_ALREADY_INIT, rcl_publisher_init_message_pool(
+      &publisher, sizeof(test_msgs__msg__Strings), init_function, fini_function, 0u));
+  rcl_reset_error();
+
+  // The pool is sized by the QoS depth.
+  void * msgs[2] = {nullptr, nullptr};
+  for (auto & msg : msgs) {
+    ret = rcl_borrow_loaned_message(&publisher, ts, &msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_NE(nullptr, msg);
+  }
+  EXPECT_NE(msgs[0], msgs[1]);
+  void * msg = nullptr;
+  EXPECT_EQ(
+    RCL_RET_PUBLISHER_MESSAGE_POOL_EXHAUSTED, rcl_borrow_loaned_message(&publisher, ts, &msg));
+  rcl_reset_error();
+
+  // Publishing returns the message to the pool, which keeps its string capacity.
+  auto loaned = static_cast<test_msgs__msg__Strings *>(msgs[0]);
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&loaned->string_value, "testing"));
+  const char * data = loaned->string_value.data;
+  ret = rcl_publish_loaned_message(&publisher, msgs[0], nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_return_loaned_message_from_publisher(&publisher, msgs[0]));
+  rcl_reset_error();
+  ret = rcl_borrow_loaned_message(&publisher, ts, &msg);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(msgs[0], msg);
+  EXPECT_EQ(data, static_cast<test_msgs__msg__Strings *>(msg)->string_value.data);
+
+  // Messages which were not published are returned as well.
+  test_msgs__msg__Strings foreign;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_return_loaned_message_from_publisher(&publisher, &foreign));
+  rcl_reset_error();
+  for (auto & msg : msgs) {
+    ret = rcl_return_loaned_message_from_publisher(&publisher, msg);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+}
+
 TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_invalid_publisher) {
   rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
   const rosidl_message_type_support_t * ts =
@@ -527,6 +616,8 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_invalid_publish
   rcl_reset_error();
   EXPECT_FALSE(rcl_publisher_can_loan_messages(nullptr));
   rcl_reset_error();
+  EXPECT_FALSE(rcl_publisher_has_message_pool(nullptr));
+  rcl_reset_error();
   EXPECT_EQ(
     RCL_RET_PUBLISHER_INVALID, rcl_publisher_get_subscription_count(nullptr, &count_size));
   rcl_reset_error();
@@ -634,6 +725,115 @@ TEST_F(
   }
 }
 
+/* Test publishing several messages at once.
+ */
+TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_publish_batch) {
+  test_msgs__msg__BasicTypes msgs[3];
+  for (size_t i = 0u; i < 3u; ++i) {
+    test_msgs__msg__BasicTypes__init(&msgs[i]);
+    msgs[i].int64_value = static_cast<int64_t>(i);
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (auto & msg : msgs) {
+      test_msgs__msg__BasicTypes__fini(&msg);
+    }
+  });
+  const void * ros_messages[3] = {&msgs[0], &msgs[1], &msgs[2]};
+  size_t published_count = 0u;
+  rcl_ret_t ret = rcl_publish_batch(&publisher, ros_messages, 3u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(3u, published_count);
+  EXPECT_EQ(RCL_RET_OK, rcl_publish_batch(&publisher, ros_messages, 0u, nullptr, nullptr));
+
+  rcl_publisher_t publisher_zero_init = rcl_get_zero_initialized_publisher();
+  EXPECT_EQ(
+    RCL_RET_PUBLISHER_INVALID,
+    rcl_publish_batch(&publisher_zero_init, ros_messages, 3u, &published_count, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_publish_batch(&publisher, nullptr, 3u, &published_count, nullptr));
+  rcl_reset_error();
+  // Nothing is published when any message is missing.
+  ros_messages[2] = nullptr;
+  {
+    size_t publish_calls = 0u;
+    auto mock = mocking_utils::patch(
+      "lib:rcl", rmw_publish, [&](auto, auto, auto) {
+        ++publish_calls;
+        return RMW_RET_OK;
+      });
+    EXPECT_EQ(
+      RCL_RET_INVALID_ARGUMENT,
+      rcl_publish_batch(&publisher, ros_messages, 3u, &published_count, nullptr));
+    rcl_reset_error();
+    EXPECT_EQ(0u, publish_calls);
+  }
+
+  // The serialized variant.
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_serialized_message_t serialized_msgs[2];
+  for (size_t i = 0u; i < 2u; ++i) {
+    serialized_msgs[i] = rmw_get_zero_initialized_serialized_message();
+    ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_msgs[i], 0u, &allocator));
+    ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msgs[i], ts, &serialized_msgs[i]));
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (auto & serialized_msg : serialized_msgs) {
+      EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_msg));
+    }
+  });
+  const rcl_serialized_message_t * serialized_messages[2] = {
+    &serialized_msgs[0], &serialized_msgs[1]};
+  ret = rcl_publish_serialized_message_batch(
+    &publisher, serialized_messages, 2u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, published_count);
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_publish_serialized_message_batch(&publisher, nullptr, 2u, &published_count, nullptr));
+  rcl_reset_error();
+}
+
+// Mocking rmw_publish and rmw_publish_serialized_message to fail in the middle of a batch
+TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_mock_publish_batch) {
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  const void * ros_messages[4] = {&msg, &msg, &msg, &msg};
+  size_t publish_calls = 0u;
+  {
+    auto mock = mocking_utils::patch(
+      "lib:rcl", rmw_publish, [&](auto, auto, auto) {
+        return ++publish_calls > 2u ? RMW_RET_ERROR : RMW_RET_OK;
+      });
+    size_t published_count = 0u;
+    rcl_ret_t ret = rcl_publish_batch(&publisher, ros_messages, 4u, &published_count, nullptr);
+    EXPECT_EQ(RCL_RET_ERROR, ret);
+    EXPECT_TRUE(rcl_error_is_set());
+    rcl_reset_error();
+    EXPECT_EQ(2u, published_count);
+    EXPECT_EQ(3u, publish_calls);
+  }
+
+  rcl_serialized_message_t serialized_msg = rmw_get_zero_initialized_serialized_message();
+  const rcl_serialized_message_t * serialized_messages[2] = {&serialized_msg, &serialized_msg};
+  auto mock = mocking_utils::patch_and_return(
+    "lib:rcl", rmw_publish_serialized_message, RMW_RET_BAD_ALLOC);
+  size_t published_count = 1u;
+  rcl_ret_t ret = rcl_publish_serialized_message_batch(
+    &publisher, serialized_messages, 2u, &published_count, nullptr);
+  EXPECT_EQ(RCL_RET_BAD_ALLOC, ret);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+  EXPECT_EQ(0u, published_count);
+}
+
 // Define dummy comparison operators for rcutils_allocator_t type for use with the Mimick Library
 MOCKING_UTILS_BOOL_OPERATOR_RETURNS_FALSE(rcutils_allocator_t, ==)
 MOCKING_UTILS_BOOL_OPERATOR_RETURNS_FALSE(rcutils_allocator_t, <)
@@ -757,6 +957,42 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_mock_loaned_fun
 }
 
 // Tests mocking ini/fini functions for specific failures
+// Mocking rmw_publish to make publishing a message of the publisher message pool fail
+TEST_F(CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION), test_mock_publish_pool_message) {
+  if (rcl_publisher_can_loan_messages(&publisher)) {
+    return;
+  }
+  rcl_message_init_function_t init_function = [](void * msg) {
+      return test_msgs__msg__BasicTypes__init(static_cast<test_msgs__msg__BasicTypes *>(msg));
+    };
+  rcl_message_fini_function_t fini_function = [](void * msg) {
+      test_msgs__msg__BasicTypes__fini(static_cast<test_msgs__msg__BasicTypes *>(msg));
+    };
+  rcl_ret_t ret = rcl_publisher_init_message_pool(
+    &publisher, sizeof(test_msgs__msg__BasicTypes), init_function, fini_function, 1u);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  void * msg = nullptr;
+  ret = rcl_borrow_loaned_message(&publisher, ts, &msg);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  {
+    auto mock = mocking_utils::patch_and_return("lib:rcl", rmw_publish, RMW_RET_ERROR);
+    // A message which is not loaned by the pool is rejected before reaching rmw_publish.
+    test_msgs__msg__BasicTypes foreign;
+    EXPECT_EQ(
+      RCL_RET_INVALID_ARGUMENT, rcl_publish_loaned_message(&publisher, &foreign, nullptr));
+    rcl_reset_error();
+    EXPECT_EQ(RCL_RET_ERROR, rcl_publish_loaned_message(&publisher, msg, nullptr));
+    rcl_reset_error();
+  }
+  // The message is still loaned, so it is returned rather than loaned again.
+  void * other = nullptr;
+  EXPECT_EQ(
+    RCL_RET_PUBLISHER_MESSAGE_POOL_EXHAUSTED, rcl_borrow_loaned_message(&publisher, ts, &other));
+  rcl_reset_error();
+  ret = rcl_return_loaned_message_from_publisher(&publisher, msg);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+}
+
 TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_mocks_fail_publisher_init) {
   rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
   const rosidl_message_type_support_t * ts =
@@ -825,3 +1061,48 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_mock_publisher_
   ret = rcl_publisher_fini(&publisher, this->node_ptr);
   EXPECT_EQ(RCL_RET_ERROR, ret) << rcl_get_error_string().str;
 }
+
+// Compare the throughput of publishing small messages one by one and in batches.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST_F(
+  CLASSNAME(TestPublisherFixtureInit, RMW_IMPLEMENTATION),
+  DISABLED_test_publish_batch_throughput) {
+  const size_t kNumMessages = 20000u;
+  const size_t kBatchSize = 100u;
+  std::vector<test_msgs__msg__BasicTypes> msgs(kBatchSize);
+  std::vector<const void *> ros_messages(kBatchSize);
+  for (size_t i = 0u; i < kBatchSize; ++i) {
+    test_msgs__msg__BasicTypes__init(&msgs[i]);
+    msgs[i].int64_value = static_cast<int64_t>(i);
+    ros_messages[i] = &msgs[i];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (auto & msg : msgs) {
+      test_msgs__msg__BasicTypes__fini(&msg);
+    }
+  });
+
+  auto single_start = std::chrono::steady_clock::now();
+  for (size_t i = 0u; i < kNumMessages; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_publish(&publisher, ros_messages[i % kBatchSize], nullptr)) <<
+      rcl_get_error_string().str;
+  }
+  auto single_elapsed = std::chrono::steady_clock::now() - single_start;
+
+  auto batch_start = std::chrono::steady_clock::now();
+  for (size_t i = 0u; i < kNumMessages; i += kBatchSize) {
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_publish_batch(
+        &publisher, ros_messages.data(), kBatchSize, nullptr, nullptr)) <<
+      rcl_get_error_string().str;
+  }
+  auto batch_elapsed = std::chrono::steady_clock::now() - batch_start;
+
+  std::stringstream ss;
+  ss << "messages published per second: one by one " <<
+    kNumMessages / std::chrono::duration<double>(single_elapsed).count() <<
+    ", in batches of " << kBatchSize << " " <<
+    kNumMessages / std::chrono::duration<double>(batch_elapsed).count();
+  RCUTILS_LOG_INFO_NAMED(ROS_PACKAGE_NAME, "%s", ss.str().c_str());
+}
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 #include "rcl/service.h"
 #include "rcl/rcl.h"
 
@@ -21,6 +23,7 @@
 
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
 #include "rcl/error_handling.h"
+#include "rcutils/logging_macros.h"
 #include "rmw/validate_namespace.h"
 
 #include "wait_for_entity_helpers.hpp"
@@ -224,6 +227,760 @@ TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_nominal)
   test_msgs__srv__BasicTypes_Response__fini(&client_response);
 }
 
+/* Test the counters of the requests and responses of a service and a client.
+ */
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_statistics) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, BasicTypes);
+  const char * topic = "statistics";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_service_statistics_t service_statistics;
+  rcl_client_statistics_t client_statistics;
+  ret = rcl_service_get_statistics(&service, &service_statistics);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    // rcl was built without statistics.
+    rcl_reset_error();
+    EXPECT_EQ(RCL_RET_UNSUPPORTED, rcl_client_get_statistics(&client, &client_statistics));
+    rcl_reset_error();
+    return;
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_SERVICE_INVALID, rcl_service_get_statistics(nullptr, &service_statistics));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_CLIENT_INVALID, rcl_client_get_statistics(nullptr, &client_statistics));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_client_get_statistics(&client, nullptr));
+  rcl_reset_error();
+  ASSERT_TRUE(wait_for_server_to_be_available(this->node_ptr, &client, 10, 1000));
+
+  test_msgs__srv__BasicTypes_Request request;
+  test_msgs__srv__BasicTypes_Request__init(&request);
+  test_msgs__srv__BasicTypes_Response response;
+  test_msgs__srv__BasicTypes_Response__init(&response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+  });
+  // The C __init methods leave bool fields uninitialized, see test_service_nominal.
+  request.bool_value = false;
+  response.bool_value = false;
+  int64_t sequence_number;
+  ret = rcl_send_request(&client, &request, &sequence_number);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_for_service_to_be_ready(&service, context_ptr, 10, 100));
+  rmw_service_info_t header;
+  ret = rcl_take_request_with_info(&service, &header, &request);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_SERVICE_TAKE_FAILED, rcl_take_request_with_info(&service, &header, &request));
+  ret = rcl_send_response(&service, &header.request_id, &response);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_for_client_to_be_ready(&client, context_ptr, 10, 100));
+  ret = rcl_take_response_with_info(&client, &header, &response);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_CLIENT_TAKE_FAILED, rcl_take_response_with_info(&client, &header, &response));
+
+  ret = rcl_service_get_statistics(&service, &service_statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, service_statistics.request_count);
+  EXPECT_EQ(1u, service_statistics.response_count);
+  EXPECT_EQ(1u, service_statistics.take_failed_count);
+  ret = rcl_client_get_statistics(&client, &client_statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, client_statistics.request_count);
+  EXPECT_EQ(1u, client_statistics.response_count);
+  EXPECT_EQ(1u, client_statistics.take_failed_count);
+}
+
+/* Test taking requests and sending responses in batches.
+ */
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_batched_requests) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, BasicTypes);
+  const char * topic = "batched";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_TRUE(wait_for_server_to_be_available(this->node_ptr, &client, 10, 1000));
+
+  constexpr size_t kNumRequests = 3u;
+  constexpr size_t kBatchSize = 5u;
+  test_msgs__srv__BasicTypes_Request requests[kBatchSize];
+  test_msgs__srv__BasicTypes_Response responses[kBatchSize];
+  void * request_ptrs[kBatchSize];
+  void * response_ptrs[kBatchSize];
+  rmw_service_info_t headers[kBatchSize];
+  for (size_t i = 0u; i < kBatchSize; ++i) {
+    test_msgs__srv__BasicTypes_Request__init(&requests[i]);
+    test_msgs__srv__BasicTypes_Response__init(&responses[i]);
+    // The C __init methods leave bool fields uninitialized, see test_service_nominal.
+    requests[i].bool_value = false;
+    responses[i].bool_value = false;
+    request_ptrs[i] = &requests[i];
+    response_ptrs[i] = &responses[i];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kBatchSize; ++i) {
+      test_msgs__srv__BasicTypes_Request__fini(&requests[i]);
+      test_msgs__srv__BasicTypes_Response__fini(&responses[i]);
+    }
+  });
+
+  size_t taken_count = 42u;
+  EXPECT_EQ(
+    RCL_RET_SERVICE_INVALID,
+    rcl_take_requests(nullptr, kBatchSize, headers, request_ptrs, &taken_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_take_requests(&service, kBatchSize, nullptr, request_ptrs, &taken_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_take_requests(&service, kBatchSize, headers, nullptr, &taken_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_take_requests(&service, kBatchSize, headers, request_ptrs, nullptr));
+  rcl_reset_error();
+  request_ptrs[kBatchSize - 1u] = nullptr;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_take_requests(&service, kBatchSize, headers, request_ptrs, &taken_count));
+  rcl_reset_error();
+  request_ptrs[kBatchSize - 1u] = &requests[kBatchSize - 1u];
+  EXPECT_EQ(42u, taken_count);
+  EXPECT_EQ(
+    RCL_RET_SERVICE_TAKE_FAILED,
+    rcl_take_requests(&service, kBatchSize, headers, request_ptrs, &taken_count));
+  EXPECT_EQ(0u, taken_count);
+  EXPECT_EQ(RCL_RET_OK, rcl_take_requests(&service, 0u, headers, request_ptrs, &taken_count));
+  EXPECT_EQ(0u, taken_count);
+
+  test_msgs__srv__BasicTypes_Request client_request;
+  test_msgs__srv__BasicTypes_Request__init(&client_request);
+  test_msgs__srv__BasicTypes_Response client_response;
+  test_msgs__srv__BasicTypes_Response__init(&client_response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&client_request);
+    test_msgs__srv__BasicTypes_Response__fini(&client_response);
+  });
+  client_request.bool_value = false;
+  client_response.bool_value = false;
+  int64_t sequence_numbers[kNumRequests];
+  for (size_t i = 0u; i < kNumRequests; ++i) {
+    client_request.uint8_value = 1;
+    client_request.uint32_value = static_cast<uint32_t>(i);
+    ret = rcl_send_request(&client, &client_request, &sequence_numbers[i]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // The requests may not all be there when the service is first ready.
+  size_t total_taken = 0u;
+  for (size_t tries = 0u; total_taken < kNumRequests && tries < 10u; ++tries) {
+    ASSERT_TRUE(wait_for_service_to_be_ready(&service, context_ptr, 10, 100));
+    ret = rcl_take_requests(
+      &service, kBatchSize - total_taken, &headers[total_taken], &request_ptrs[total_taken],
+      &taken_count);
+    if (RCL_RET_SERVICE_TAKE_FAILED == ret) {
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    total_taken += taken_count;
+  }
+  ASSERT_EQ(kNumRequests, total_taken);
+  for (size_t i = 0u; i < kNumRequests; ++i) {
+    EXPECT_EQ(sequence_numbers[i], headers[i].request_id.sequence_number);
+    EXPECT_EQ(i, requests[i].uint32_value);
+    responses[i].uint64_value = requests[i].uint8_value + requests[i].uint32_value;
+  }
+
+  size_t sent_count = 42u;
+  EXPECT_EQ(
+    RCL_RET_SERVICE_INVALID,
+    rcl_send_responses(nullptr, kNumRequests, headers, response_ptrs, &sent_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_send_responses(&service, kNumRequests, nullptr, response_ptrs, &sent_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_send_responses(&service, kNumRequests, headers, nullptr, &sent_count));
+  rcl_reset_error();
+  EXPECT_EQ(42u, sent_count);
+  ret = rcl_send_responses(&service, kNumRequests, headers, response_ptrs, &sent_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(kNumRequests, sent_count);
+
+  size_t received = 0u;
+  for (size_t tries = 0u; received < kNumRequests && tries < 10u; ++tries) {
+    ASSERT_TRUE(wait_for_client_to_be_ready(&client, context_ptr, 10, 100));
+    rmw_service_info_t header;
+    while (rcl_take_response_with_info(&client, &header, &client_response) == RCL_RET_OK) {
+      EXPECT_EQ(
+        static_cast<uint64_t>(1 + header.request_id.sequence_number - sequence_numbers[0]),
+        client_response.uint64_value);
+      ++received;
+    }
+  }
+  EXPECT_EQ(kNumRequests, received);
+
+  {
+    auto mock = mocking_utils::patch_and_return(
+      "lib:rcl", rmw_send_response, RMW_RET_ERROR);
+    ret = rcl_send_responses(&service, kNumRequests, headers, response_ptrs, &sent_count);
+    EXPECT_EQ(RCL_RET_ERROR, ret);
+    EXPECT_TRUE(rcl_error_is_set());
+    rcl_reset_error();
+    EXPECT_EQ(0u, sent_count);
+  }
+}
+
+// Measure the request/response throughput of a service answering bursts of requests in batches.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), DISABLED_batched_requests_throughput) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, BasicTypes);
+  const char * topic = "batched_throughput";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_TRUE(wait_for_server_to_be_available(this->node_ptr, &client, 10, 1000));
+
+  constexpr size_t kNumRequests = 1000u;
+  // Bursts fit the history depth of the default QoS of services, so no request is dropped.
+  constexpr size_t kBurstSize = 10u;
+  constexpr size_t kBatchSize = 32u;
+  test_msgs__srv__BasicTypes_Request requests[kBatchSize];
+  test_msgs__srv__BasicTypes_Response responses[kBatchSize];
+  void * request_ptrs[kBatchSize];
+  void * response_ptrs[kBatchSize];
+  rmw_service_info_t headers[kBatchSize];
+  for (size_t i = 0u; i < kBatchSize; ++i) {
+    test_msgs__srv__BasicTypes_Request__init(&requests[i]);
+    test_msgs__srv__BasicTypes_Response__init(&responses[i]);
+    // The C __init methods leave bool fields uninitialized, see test_service_nominal.
+    requests[i].bool_value = false;
+    responses[i].bool_value = false;
+    request_ptrs[i] = &requests[i];
+    response_ptrs[i] = &responses[i];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kBatchSize; ++i) {
+      test_msgs__srv__BasicTypes_Request__fini(&requests[i]);
+      test_msgs__srv__BasicTypes_Response__fini(&responses[i]);
+    }
+  });
+  test_msgs__srv__BasicTypes_Request client_request;
+  test_msgs__srv__BasicTypes_Request__init(&client_request);
+  test_msgs__srv__BasicTypes_Response client_response;
+  test_msgs__srv__BasicTypes_Response__init(&client_response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&client_request);
+    test_msgs__srv__BasicTypes_Response__fini(&client_response);
+  });
+  client_request.bool_value = false;
+  client_response.bool_value = false;
+  client_request.uint8_value = 1;
+
+  int64_t first_sequence_number = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t sent = 0u; sent < kNumRequests; sent += kBurstSize) {
+    for (size_t i = 0u; i < kBurstSize; ++i) {
+      client_request.uint32_value = static_cast<uint32_t>(sent + i);
+      int64_t sequence_number;
+      ret = rcl_send_request(&client, &client_request, &sequence_number);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      if (0u == sent + i) {
+        first_sequence_number = sequence_number;
+      }
+    }
+    size_t answered = 0u;
+    while (answered < kBurstSize) {
+      ASSERT_TRUE(wait_for_service_to_be_ready(&service, context_ptr, 10, 100));
+      size_t taken_count = 0u;
+      ret = rcl_take_requests(&service, kBatchSize, headers, request_ptrs, &taken_count);
+      if (RCL_RET_SERVICE_TAKE_FAILED == ret) {
+        continue;
+      }
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      for (size_t i = 0u; i < taken_count; ++i) {
+        responses[i].uint64_value = requests[i].uint8_value + requests[i].uint32_value;
+      }
+      ret = rcl_send_responses(&service, taken_count, headers, response_ptrs, NULL);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      answered += taken_count;
+    }
+    size_t received = 0u;
+    while (received < kBurstSize) {
+      ASSERT_TRUE(wait_for_client_to_be_ready(&client, context_ptr, 10, 100));
+      rmw_service_info_t header;
+      while ((ret = rcl_take_response_with_info(&client, &header, &client_response)) ==
+        RCL_RET_OK)
+      {
+        // The values of the request k of the bursts sum up to k + 1.
+        EXPECT_EQ(
+          static_cast<uint64_t>(1 + header.request_id.sequence_number - first_sequence_number),
+          client_response.uint64_value);
+        ++received;
+      }
+      ASSERT_EQ(RCL_RET_CLIENT_TAKE_FAILED, ret) << rcl_get_error_string().str;
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  RCUTILS_LOG_INFO_NAMED(
+    ROS_PACKAGE_NAME, "requests answered per second, in bursts of %zu: %f", kBurstSize,
+    kNumRequests / std::chrono::duration<double>(elapsed).count());
+}
+
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_client_request_window) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, BasicTypes);
+  const char * topic = "request_window";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  size_t in_flight_count = 0u;
+  EXPECT_EQ(RCL_RET_NOT_INIT, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  rcl_reset_error();
+  rcl_message_init_function_t init_function = [](void * msg) {
+      return test_msgs__srv__BasicTypes_Response__init(
+        static_cast<test_msgs__srv__BasicTypes_Response *>(msg));
+    };
+  rcl_message_fini_function_t fini_function = [](void * msg) {
+      test_msgs__srv__BasicTypes_Response__fini(
+        static_cast<test_msgs__srv__BasicTypes_Response *>(msg));
+    };
+  const size_t response_size = sizeof(test_msgs__srv__BasicTypes_Response);
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_client_init_request_window(
+      &client, 0u, response_size, init_function, fini_function));
+  rcl_reset_error();
+  ret = rcl_client_init_request_window(&client, 2u, response_size, init_function, fini_function);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_ALREADY_INIT, rcl_client_init_request_window(
+      &client, 2u, response_size, init_function, fini_function));
+  rcl_reset_error();
+  ASSERT_TRUE(wait_for_server_to_be_available(this->node_ptr, &client, 10, 1000));
+
+  test_msgs__srv__BasicTypes_Request request;
+  test_msgs__srv__BasicTypes_Request__init(&request);
+  test_msgs__srv__BasicTypes_Response response;
+  test_msgs__srv__BasicTypes_Response__init(&response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+  });
+  // The C __init methods leave bool fields uninitialized, see test_service_nominal.
+  request.bool_value = false;
+  response.bool_value = false;
+
+  // Fill the window, which then refuses more requests.
+  int64_t sequence_numbers[2];
+  for (int32_t i = 0; i < 2; ++i) {
+    request.int32_value = i + 1;
+    ret = rcl_send_request(&client, &request, &sequence_numbers[i]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  int64_t sequence_number;
+  EXPECT_EQ(
+    RCL_RET_CLIENT_REQUEST_WINDOW_FULL, rcl_send_request(&client, &request, &sequence_number));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  EXPECT_EQ(2u, in_flight_count);
+
+  // Answer both requests in order.
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(wait_for_service_to_be_ready(&service, context_ptr, 10, 100));
+    rmw_service_info_t header;
+    ret = rcl_take_request_with_info(&service, &header, &request);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    response.int64_value = request.int32_value;
+    ret = rcl_send_response(&service, &header.request_id, &response);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // Take the second response first, which keeps the first one for later.
+  rmw_service_info_t response_header;
+  ret = RCL_RET_CLIENT_TAKE_FAILED;
+  for (size_t tries = 0u; RCL_RET_CLIENT_TAKE_FAILED == ret && tries < 10u; ++tries) {
+    ASSERT_TRUE(wait_for_client_to_be_ready(&client, context_ptr, 10, 100));
+    ret = rcl_client_take_response_for(
+      &client, sequence_numbers[1], &response_header, &response);
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(sequence_numbers[1], response_header.request_id.sequence_number);
+  EXPECT_EQ(2, response.int64_value);
+  ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  EXPECT_EQ(1u, in_flight_count);
+  {
+    // The kept response makes the client ready without blocking.
+    rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+    ret = rcl_wait_set_init(
+      &wait_set, 0, 0, 0, 1, 0, 0, this->context_ptr, rcl_get_default_allocator());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rcl_ret_t ret = rcl_wait_set_fini(&wait_set);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    });
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_client(&wait_set, &client, NULL));
+    auto start = std::chrono::steady_clock::now();
+    ret = rcl_wait(&wait_set, RCL_S_TO_NS(5));
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_EQ(&client, wait_set.clients[0]);
+  }
+  ret = rcl_client_take_response_for(&client, sequence_numbers[0], &response_header, &response);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(sequence_numbers[0], response_header.request_id.sequence_number);
+  EXPECT_EQ(1, response.int64_value);
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_client_take_response_for(
+      &client, sequence_numbers[0], &response_header, &response));
+  rcl_reset_error();
+
+  // A cancelled request leaves the window.
+  ret = rcl_send_request(&client, &request, &sequence_number);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_client_cancel_request(&client, sequence_number));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_client_cancel_request(&client, sequence_number));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  EXPECT_EQ(0u, in_flight_count);
+
+  // The slot is reserved before sending, and given back if sending fails.
+  ret = rcl_send_request(&client, &request, &sequence_number);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const int64_t tracked_sequence_number = sequence_number;
+  {
+    auto mock = mocking_utils::patch_and_return("lib:rcl", rmw_send_request, RMW_RET_ERROR);
+    EXPECT_EQ(RCL_RET_ERROR, rcl_send_request(&client, &request, &sequence_number));
+    rcl_reset_error();
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  EXPECT_EQ(1u, in_flight_count);
+  // A request the middleware numbers differently is sent but not tracked if its slot is taken,
+  // the window of 2 requests has 2 slots.
+  int64_t given_sequence_number = tracked_sequence_number + 2;
+  {
+    auto mock = mocking_utils::patch(
+      "lib:rcl", rmw_send_request, [&](auto, auto, int64_t * sequence_id) {
+        *sequence_id = given_sequence_number;
+        return RMW_RET_OK;
+      });
+    EXPECT_EQ(
+      RCL_RET_CLIENT_REQUEST_NOT_TRACKED, rcl_send_request(&client, &request, &sequence_number));
+    rcl_reset_error();
+    EXPECT_EQ(given_sequence_number, sequence_number);
+    ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+    EXPECT_EQ(1u, in_flight_count);
+    // Otherwise it is tracked by its number.
+    given_sequence_number = tracked_sequence_number + 5;
+    ret = rcl_send_request(&client, &request, &sequence_number);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(given_sequence_number, sequence_number);
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  EXPECT_EQ(2u, in_flight_count);
+  EXPECT_EQ(RCL_RET_OK, rcl_client_cancel_request(&client, given_sequence_number));
+  EXPECT_EQ(RCL_RET_OK, rcl_client_cancel_request(&client, tracked_sequence_number));
+}
+
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_client_request_timeout) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, BasicTypes);
+  const char * topic = "request_timeout";
+
+  // The service never answers, so the requests can only time out.
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  EXPECT_EQ(RCL_RET_NOT_INIT, rcl_client_set_default_request_timeout(&client, 0));
+  rcl_reset_error();
+  rcl_message_init_function_t init_function = [](void * msg) {
+      return test_msgs__srv__BasicTypes_Response__init(
+        static_cast<test_msgs__srv__BasicTypes_Response *>(msg));
+    };
+  rcl_message_fini_function_t fini_function = [](void * msg) {
+      test_msgs__srv__BasicTypes_Response__fini(
+        static_cast<test_msgs__srv__BasicTypes_Response *>(msg));
+    };
+  ret = rcl_client_init_request_window(
+    &client, 4u, sizeof(test_msgs__srv__BasicTypes_Response), init_function, fini_function);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const int64_t request_timeout = RCL_MS_TO_NS(10);
+  ASSERT_EQ(RCL_RET_OK, rcl_client_set_default_request_timeout(&client, request_timeout));
+  ASSERT_TRUE(wait_for_server_to_be_available(this->node_ptr, &client, 10, 1000));
+
+  test_msgs__srv__BasicTypes_Request request;
+  test_msgs__srv__BasicTypes_Request__init(&request);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+  });
+  // The C __init methods leave bool fields uninitialized, see test_service_nominal.
+  request.bool_value = false;
+  int64_t sequence_numbers[2];
+  for (int64_t & sequence_number : sequence_numbers) {
+    ret = rcl_send_request(&client, &request, &sequence_number);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  // The second request never expires.
+  ret = rcl_client_set_request_timeout(&client, sequence_numbers[1], -1);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_client_set_request_timeout(&client, 42, -1));
+  rcl_reset_error();
+
+  int64_t expired[4];
+  size_t expired_count = 42u;
+  ret = rcl_client_sweep_expired_requests(&client, expired, 4u, &expired_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, expired_count);
+
+  // Waiting without timeout wakes up when the first request expires.
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, 0, 0, 0, 1, 0, 0, this->context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_client(&wait_set, &client, NULL));
+  rcl_wait_set_ready_entity_t ready_entity;
+  size_t ready_count = 0u;
+  ret = rcl_wait_ex(&wait_set, -1, &ready_entity, 1u, &ready_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(&client, wait_set.clients[0]);
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(RCL_WAIT_SET_CLIENT, ready_entity.type);
+  EXPECT_EQ(0u, ready_entity.index);
+  EXPECT_TRUE(ready_entity.client_timed_out);
+  ret = rcl_client_sweep_expired_requests(&client, expired, 4u, &expired_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, expired_count);
+  EXPECT_EQ(sequence_numbers[0], expired[0]);
+  size_t in_flight_count = 0u;
+  ASSERT_EQ(RCL_RET_OK, rcl_client_get_in_flight_count(&client, &in_flight_count));
+  EXPECT_EQ(1u, in_flight_count);
+
+  // Nothing expires anymore.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_client(&wait_set, &client, NULL));
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, 2 * request_timeout));
+}
+
+TEST_F(
+  CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION),
+  test_client_request_timeout_edge_triggered) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, BasicTypes);
+  const char * topic = "request_timeout_edge_triggered";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_message_init_function_t init_function = [](void * msg) {
+      return test_msgs__srv__BasicTypes_Response__init(
+        static_cast<test_msgs__srv__BasicTypes_Response *>(msg));
+    };
+  rcl_message_fini_function_t fini_function = [](void * msg) {
+      test_msgs__srv__BasicTypes_Response__fini(
+        static_cast<test_msgs__srv__BasicTypes_Response *>(msg));
+    };
+  ret = rcl_client_init_request_window(
+    &client, 4u, sizeof(test_msgs__srv__BasicTypes_Response), init_function, fini_function);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const int64_t request_timeout = RCL_MS_TO_NS(10);
+  ASSERT_EQ(RCL_RET_OK, rcl_client_set_default_request_timeout(&client, request_timeout));
+  ASSERT_TRUE(wait_for_server_to_be_available(this->node_ptr, &client, 10, 1000));
+
+  test_msgs__srv__BasicTypes_Request request;
+  test_msgs__srv__BasicTypes_Request__init(&request);
+  test_msgs__srv__BasicTypes_Response response;
+  test_msgs__srv__BasicTypes_Response__init(&response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+  });
+  // The C __init methods leave bool fields uninitialized, see test_service_nominal.
+  request.bool_value = false;
+  response.bool_value = false;
+  int64_t sequence_numbers[2];
+  for (int64_t & sequence_number : sequence_numbers) {
+    ret = rcl_send_request(&client, &request, &sequence_number);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  // Only the first request expires, the second one is answered late.
+  ret = rcl_client_set_request_timeout(&client, sequence_numbers[1], -1);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, 0, 0, 0, 1, 0, 0, this->context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_client(&wait_set, &client, NULL));
+  ret = rcl_wait_set_set_edge_triggered(&wait_set, true);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // The expired request makes the client ready, and is swept.
+  ret = rcl_wait(&wait_set, -1);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  bool is_ready = false;
+  ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_CLIENT, 0, &is_ready);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(is_ready);
+  int64_t expired[4];
+  size_t expired_count = 0u;
+  ret = rcl_client_sweep_expired_requests(&client, expired, 4u, &expired_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, expired_count);
+  EXPECT_EQ(sequence_numbers[0], expired[0]);
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, 2 * request_timeout));
+
+  // Nothing was taken from the client, so it is still armed for the response.
+  rmw_service_info_t header;
+  do {
+    ASSERT_TRUE(wait_for_service_to_be_ready(&service, context_ptr, 10, 100));
+    ret = rcl_take_request_with_info(&service, &header, &request);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  } while (sequence_numbers[1] != header.request_id.sequence_number);
+  response.int64_value = 42;
+  ret = rcl_send_response(&service, &header.request_id, &response);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  is_ready = false;
+  for (size_t attempt = 0; attempt < 10 && !is_ready; ++attempt) {
+    ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+    ASSERT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_CLIENT, 0, &is_ready);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  ASSERT_TRUE(is_ready);
+  rmw_service_info_t response_header;
+  ret = rcl_client_take_response_for(&client, sequence_numbers[1], &response_header, &response);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(42, response.int64_value);
+}
+
 /* Basic nominal test of a service with rcl_take_response
  */
 TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_without_info) {
@@ -385,6 +385,381 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription
   }
 }
 
+/* Test that an edge triggered wait set reports a subscription once until it is drained.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_edge_triggered) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  constexpr char topic[] = "rcl_test_subscription_edge_triggered_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, 1, 0, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  ret = rcl_wait_set_add_subscription(&wait_set, &subscription, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_set_edge_triggered(&wait_set, true);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(rcl_wait_set_is_edge_triggered(&wait_set));
+  EXPECT_TRUE(rcl_wait_set_is_persistent(&wait_set));
+
+  auto publish = [&publisher](int64_t value) {
+      test_msgs__msg__BasicTypes msg;
+      test_msgs__msg__BasicTypes__init(&msg);
+      msg.int64_value = value;
+      rcl_ret_t ret = rcl_publish(&publisher, &msg, nullptr);
+      test_msgs__msg__BasicTypes__fini(&msg);
+      return ret;
+    };
+  auto wait_until_ready = [&wait_set]() {
+      bool is_ready = false;
+      for (size_t attempt = 0; attempt < 10 && !is_ready; ++attempt) {
+        rcl_ret_t ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+        if (ret != RCL_RET_OK && ret != RCL_RET_TIMEOUT) {
+          return false;
+        }
+        ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_SUBSCRIPTION, 0, &is_ready);
+        if (ret != RCL_RET_OK) {
+          return false;
+        }
+      }
+      return is_ready;
+    };
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+
+  ASSERT_EQ(RCL_RET_OK, publish(1)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, publish(2)) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_until_ready());
+  ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  // Not drained yet, but already reported, so the subscription is left out.
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(10));
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  bool is_ready = true;
+  ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_SUBSCRIPTION, 0, &is_ready);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_FALSE(is_ready);
+
+  // Draining the subscription re-arms it.
+  do {
+    ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+  } while (RCL_RET_OK == ret);
+  ASSERT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, ret) << rcl_get_error_string().str;
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, publish(3)) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_until_ready());
+  ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(3, msg.int64_value);
+
+  // Disabling edge triggering keeps the wait set persistent, clearing it drops both.
+  ret = rcl_wait_set_set_edge_triggered(&wait_set, false);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_FALSE(rcl_wait_set_is_edge_triggered(&wait_set));
+  EXPECT_TRUE(rcl_wait_set_is_persistent(&wait_set));
+  ret = rcl_wait_set_set_edge_triggered(&wait_set, true);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_clear(&wait_set);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_FALSE(rcl_wait_set_is_edge_triggered(&wait_set));
+  EXPECT_FALSE(rcl_wait_set_is_persistent(&wait_set));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_edge_triggered(nullptr, true));
+  rcl_reset_error();
+}
+
+/* Check that the slots of a persistent wait set past the added subscriptions are never ready.
+ */
+TEST_F(
+  CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION),
+  test_subscription_persistent_wait_set_unused_slots) {
+  rcl_ret_t ret;
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  constexpr char topic[] = "rcl_test_subscription_persistent_unused_slots_chatter";
+  constexpr size_t kNumSubscriptions = 2u;
+  rcl_subscription_t subscriptions[kNumSubscriptions];
+  for (size_t i = 0u; i < kNumSubscriptions; ++i) {
+    subscriptions[i] = rcl_get_zero_initialized_subscription();
+    rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+    ret = rcl_subscription_init(
+      &subscriptions[i], this->node_ptr, ts, topic, &subscription_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumSubscriptions; ++i) {
+      rcl_ret_t ret = rcl_subscription_fini(&subscriptions[i], this->node_ptr);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+  rcl_guard_condition_t guard_condition = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_condition, context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition));
+  });
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, kNumSubscriptions, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  // Persist every subscription first, so that the last slot held one before.
+  for (size_t i = 0u; i < kNumSubscriptions; ++i) {
+    ret = rcl_wait_set_add_subscription(&wait_set, &subscriptions[i], nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set)) << rcl_get_error_string().str;
+  ret = rcl_wait_set_add_subscription(&wait_set, &subscriptions[0], nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(&wait_set, &guard_condition, nullptr));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_condition));
+  rcl_wait_set_ready_entity_t ready_entities[kNumSubscriptions + 1u];
+  size_t ready_count = 0u;
+  ret = rcl_wait_ex(
+    &wait_set, RCL_MS_TO_NS(100), ready_entities, kNumSubscriptions + 1u, &ready_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(1u, ready_count);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, ready_entities[0].type);
+  EXPECT_EQ(0u, ready_entities[0].index);
+  for (size_t i = 0u; i < kNumSubscriptions; ++i) {
+    bool is_ready = true;
+    ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_SUBSCRIPTION, i, &is_ready);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_FALSE(is_ready);
+  }
+}
+
+/* Test taking into the messages of a subscription message pool.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_message_pool) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  constexpr char topic[] = "rcl_test_subscription_message_pool_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  subscription_options.qos.depth = 3;
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  rcl_message_init_function_t init_function = [](void * msg) {
+      return test_msgs__msg__Strings__init(static_cast<test_msgs__msg__Strings *>(msg));
+    };
+  rcl_message_fini_function_t fini_function = [](void * msg) {
+      test_msgs__msg__Strings__fini(static_cast<test_msgs__msg__Strings *>(msg));
+    };
+  void * msg = nullptr;
+  EXPECT_EQ(RCL_RET_NOT_INIT, rcl_take_into_pool(&subscription, &msg, nullptr, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_subscription_init_message_pool(
+      &subscription, 0u, init_function, fini_function, 0u));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_subscription_init_message_pool(
+      &subscription, sizeof(test_msgs__msg__Strings), nullptr, fini_function, 0u));
+  rcl_reset_error();
+  // The pool is sized by the QoS depth.
+  ret = rcl_subscription_init_message_pool(
+    &subscription, sizeof(test_msgs__msg__Strings), init_function, fini_function, 0u);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_ALREADY_INIT, rcl_subscription_init_message_pool(
+      &subscription, sizeof(test_msgs__msg__Strings), init_function, fini_function, 0u));
+  rcl_reset_error();
+
+  auto publish = [&publisher](const char * value) {
+      test_msgs__msg__Strings msg;
+      test_msgs__msg__Strings__init(&msg);
+      EXPECT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, value));
+      rcl_ret_t ret = rcl_publish(&publisher, &msg, nullptr);
+      test_msgs__msg__Strings__fini(&msg);
+      return ret;
+    };
+  auto string_value = [](void * msg) {
+      const rosidl_runtime_c__String & value =
+        static_cast<test_msgs__msg__Strings *>(msg)->string_value;
+      return std::string(value.data, value.size);
+    };
+  ASSERT_EQ(RCL_RET_OK, publish("first")) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, publish("second")) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, publish("third")) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 100));
+  void * msgs[3] = {nullptr, nullptr, nullptr};
+  for (void *& borrowed : msgs) {
+    ret = rcl_take_into_pool(&subscription, &borrowed, nullptr, nullptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  EXPECT_EQ("first", string_value(msgs[0]));
+  EXPECT_EQ("second", string_value(msgs[1]));
+  EXPECT_EQ("third", string_value(msgs[2]));
+  EXPECT_NE(msgs[0], msgs[1]);
+  EXPECT_NE(msgs[1], msgs[2]);
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_MESSAGE_POOL_EXHAUSTED,
+    rcl_take_into_pool(&subscription, &msg, nullptr, nullptr));
+  rcl_reset_error();
+
+  // A returned message is lent again, once something is taken into it.
+  ret = rcl_return_message_to_pool(&subscription, msgs[1]);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_return_message_to_pool(&subscription, msgs[1]));
+  rcl_reset_error();
+  test_msgs__msg__Strings foreign;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_return_message_to_pool(&subscription, &foreign));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_TAKE_FAILED, rcl_take_into_pool(&subscription, &msg, nullptr, nullptr));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, publish("fourth")) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 100));
+  rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+  ret = rcl_take_into_pool(&subscription, &msg, &message_info, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(msgs[1], msg);
+  EXPECT_EQ("fourth", string_value(msg));
+  // Messages still borrowed are finalized along with the subscription.
+}
+
+/* Test taking from several subscriptions at once, some of which are skipped.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_take_many) {
+  rcl_ret_t ret;
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const char * topics[2] = {
+    "rcl_test_subscription_take_many_chatter_0", "rcl_test_subscription_take_many_chatter_1"};
+  rcl_publisher_t publishers[2];
+  rcl_subscription_t subscriptions[2];
+  for (size_t i = 0u; i < 2u; ++i) {
+    publishers[i] = rcl_get_zero_initialized_publisher();
+    rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+    ret = rcl_publisher_init(&publishers[i], this->node_ptr, ts, topics[i], &publisher_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    subscriptions[i] = rcl_get_zero_initialized_subscription();
+    rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+    ret = rcl_subscription_init(
+      &subscriptions[i], this->node_ptr, ts, topics[i], &subscription_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < 2u; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscriptions[i], this->node_ptr));
+      EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publishers[i], this->node_ptr));
+    }
+  });
+  for (size_t i = 0u; i < 2u; ++i) {
+    ASSERT_TRUE(wait_for_established_subscription(&publishers[i], 10, 100));
+    test_msgs__msg__BasicTypes msg;
+    test_msgs__msg__BasicTypes__init(&msg);
+    msg.int64_value = static_cast<int64_t>(i) + 10;
+    ret = rcl_publish(&publishers[i], &msg, nullptr);
+    test_msgs__msg__BasicTypes__fini(&msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscriptions[i], context_ptr, 10, 100));
+  }
+
+  test_msgs__msg__BasicTypes msgs[3];
+  for (auto & msg : msgs) {
+    test_msgs__msg__BasicTypes__init(&msg);
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (auto & msg : msgs) {
+      test_msgs__msg__BasicTypes__fini(&msg);
+    }
+  });
+  const rcl_subscription_t * entries[3] = {&subscriptions[0], nullptr, &subscriptions[1]};
+  void * ros_messages[3] = {&msgs[0], &msgs[1], &msgs[2]};
+  rmw_message_info_t message_infos[3];
+  rcl_ret_t results[3];
+  size_t taken_count = 0u;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_take_many(nullptr, ros_messages, message_infos, 3u, results, &taken_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_take_many(entries, ros_messages, message_infos, 3u, nullptr, &taken_count));
+  rcl_reset_error();
+
+  ret = rcl_take_many(entries, ros_messages, message_infos, 3u, results, &taken_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, taken_count);
+  EXPECT_EQ(RCL_RET_OK, results[0]);
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, results[1]);
+  EXPECT_EQ(RCL_RET_OK, results[2]);
+  EXPECT_EQ(10, msgs[0].int64_value);
+  EXPECT_EQ(11, msgs[2].int64_value);
+
+  // Drained subscriptions are reported per entry, an invalid one stops the takes.
+  rcl_subscription_t zero_init_subscription = rcl_get_zero_initialized_subscription();
+  entries[1] = &zero_init_subscription;
+  results[2] = RCL_RET_OK;
+  ret = rcl_take_many(entries, ros_messages, nullptr, 3u, results, &taken_count);
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_INVALID, ret);
+  EXPECT_TRUE(rcl_error_is_set());
+  rcl_reset_error();
+  EXPECT_EQ(0u, taken_count);
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, results[0]);
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_INVALID, results[1]);
+  EXPECT_EQ(RCL_RET_OK, results[2]);
+}
+
 /* Basic nominal test of a subscription taking a sequence.
  */
 TEST_F(
@@ -555,6 +930,101 @@ TEST_F(
   }
 }
 
+/* Test draining a subscription with a time budget.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_take_budget) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  constexpr char topic[] = "rcl_test_subscription_take_budget_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  const size_t size = 20u;
+  auto allocator = rcutils_get_default_allocator();
+  rmw_message_info_sequence_t message_infos;
+  ASSERT_EQ(RMW_RET_OK, rmw_message_info_sequence_init(&message_infos, size, &allocator));
+  rmw_message_sequence_t messages;
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&messages, size, &allocator));
+  auto seq = test_msgs__msg__BasicTypes__Sequence__create(size);
+  ASSERT_NE(nullptr, seq);
+  for (size_t ii = 0; ii < size; ++ii) {
+    messages.data[ii] = &seq->data[ii];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rmw_message_info_sequence_fini(&message_infos);
+    rmw_message_sequence_fini(&messages);
+    test_msgs__msg__BasicTypes__Sequence__destroy(seq);
+  });
+  bool drained = true;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_take_sequence_with_budget(
+      &subscription, size, -1, &messages, &message_infos, &drained, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_take_sequence_with_budget(
+      &subscription, size + 1u, RCL_MS_TO_NS(10), &messages, &message_infos, &drained, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_INVALID, rcl_take_sequence_with_budget(
+      nullptr, size, RCL_MS_TO_NS(10), &messages, &message_infos, &drained, nullptr));
+  rcl_reset_error();
+
+  const int64_t kNumMessages = 10;
+  for (int64_t i = 0; i < kNumMessages; ++i) {
+    test_msgs__msg__BasicTypes msg;
+    test_msgs__msg__BasicTypes__init(&msg);
+    msg.int64_value = i;
+    ret = rcl_publish(&publisher, &msg, nullptr);
+    test_msgs__msg__BasicTypes__fini(&msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 100));
+  // Give a brief moment for publications to go through.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  // Reaching the count does not drain the subscription.
+  ret = rcl_take_sequence_with_budget(
+    &subscription, 3u, RCL_S_TO_NS(1), &messages, &message_infos, &drained, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(3u, messages.size);
+  EXPECT_EQ(3u, message_infos.size);
+  EXPECT_FALSE(drained);
+  // With no budget a single batch is taken, which finds the subscription drained.
+  ret = rcl_take_sequence_with_budget(
+    &subscription, size, 0, &messages, &message_infos, &drained, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(7u, messages.size);
+  EXPECT_EQ(7u, message_infos.size);
+  EXPECT_TRUE(drained);
+  for (size_t ii = 0; ii < messages.size; ++ii) {
+    EXPECT_EQ(static_cast<int64_t>(ii) + 3, seq->data[ii].int64_value);
+  }
+  ret = rcl_take_sequence_with_budget(
+    &subscription, size, RCL_S_TO_NS(1), &messages, &message_infos, &drained, nullptr);
+  EXPECT_EQ(RCL_RET_SUBSCRIPTION_TAKE_FAILED, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, messages.size);
+  EXPECT_TRUE(drained);
+}
+
 /* Basic nominal test of a subscription with take_serialize msg
  */
 TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_serialized) {
@@ -631,6 +1101,102 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription
   }
 }
 
+/* Test the counters of the messages published and taken.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_statistics) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcutils_allocator_t allocator = rcl_get_default_allocator();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  constexpr char topic[] = "rcl_test_subscription_statistics_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_publisher_statistics_t publisher_statistics;
+  rcl_subscription_statistics_t subscription_statistics;
+  ret = rcl_subscription_get_statistics(&subscription, &subscription_statistics);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    // rcl was built without statistics.
+    rcl_reset_error();
+    EXPECT_EQ(
+      RCL_RET_UNSUPPORTED, rcl_publisher_get_statistics(&publisher, &publisher_statistics));
+    rcl_reset_error();
+    return;
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, subscription_statistics.message_count);
+  EXPECT_EQ(0u, subscription_statistics.take_failed_count);
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_INVALID,
+    rcl_subscription_get_statistics(nullptr, &subscription_statistics));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_subscription_get_statistics(&subscription, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_PUBLISHER_INVALID, rcl_publisher_get_statistics(nullptr, &publisher_statistics));
+  rcl_reset_error();
+  ASSERT_TRUE(wait_for_established_subscription(&publisher, 10, 100));
+
+  test_msgs__msg__Strings msg;
+  test_msgs__msg__Strings__init(&msg);
+  rcl_serialized_message_t serialized_msg = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_msg, 0u, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Strings__fini(&msg);
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_msg));
+  });
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, "testing"));
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msg, ts, &serialized_msg));
+
+  // One message published and taken as is, one serialized.
+  ret = rcl_publish(&publisher, &msg, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 100));
+  ret = rcl_take(&subscription, &msg, nullptr, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_SUBSCRIPTION_TAKE_FAILED, rcl_take(&subscription, &msg, nullptr, nullptr));
+  ret = rcl_publish_serialized_message(&publisher, &serialized_msg, nullptr);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_TRUE(wait_for_subscription_to_be_ready(&subscription, context_ptr, 10, 100));
+  rcl_serialized_message_t serialized_msg_rcv = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_msg_rcv, 0u, &allocator));
+  ret = rcl_take_serialized_message(&subscription, &serialized_msg_rcv, nullptr, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(serialized_msg.buffer_length, serialized_msg_rcv.buffer_length);
+  EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_msg_rcv));
+
+  ret = rcl_publisher_get_statistics(&publisher, &publisher_statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, publisher_statistics.message_count);
+  EXPECT_EQ(1u, publisher_statistics.serialized_message_count);
+  EXPECT_EQ(serialized_msg.buffer_length, publisher_statistics.serialized_byte_count);
+  EXPECT_EQ(0u, publisher_statistics.publish_failed_count);
+  ret = rcl_subscription_get_statistics(&subscription, &subscription_statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, subscription_statistics.message_count);
+  EXPECT_EQ(1u, subscription_statistics.serialized_message_count);
+  EXPECT_EQ(serialized_msg.buffer_length, subscription_statistics.serialized_byte_count);
+  EXPECT_EQ(1u, subscription_statistics.take_failed_count);
+}
+
 /* Basic test for subscription loan functions
  */
 TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_loaned) {
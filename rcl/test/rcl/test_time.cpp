@@ -17,12 +17,14 @@
 #include <inttypes.h>
 
 #include <chrono>
+#include <sstream>
 #include <thread>
 
 #include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
 #include "rcl/error_handling.h"
 #include "rcl/time.h"
+#include "rcutils/logging_macros.h"
 
 #include "./allocator_testing_utils.h"
 
@@ -725,9 +727,8 @@ TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), add_remove_add_jump_callback) {
   EXPECT_EQ(RCL_RET_BAD_ALLOC, rcl_clock_add_jump_callback(&clock, threshold, cb, user_data3));
   rcl_reset_error();
 
-  // Remove callback but fail to shrink storage
-  EXPECT_EQ(RCL_RET_BAD_ALLOC, rcl_clock_remove_jump_callback(&clock, cb, user_data1));
-  rcl_reset_error();
+  // Removing a callback does not allocate
+  EXPECT_EQ(RCL_RET_OK, rcl_clock_remove_jump_callback(&clock, cb, user_data1));
 
   set_failing_allocator_is_failing(failing_allocator, false);
 
@@ -787,3 +788,325 @@ TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), fail_ros_time_override) {
   EXPECT_EQ(RCL_RET_ERROR, rcl_set_ros_time_override(&ros_clock, set_point));
   rcl_reset_error();
 }
+
+static void count_callback(const rcl_time_jump_t * time_jump, bool before_jump, void * user_data)
+{
+  (void)time_jump;
+  if (before_jump) {
+    ++(*static_cast<size_t *>(user_data));
+  }
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), many_jump_callbacks_thresholds) {
+  const size_t kNumCallbacks = 1000u;
+  rcl_clock_t ros_clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_ret_t ret = rcl_ros_clock_init(&ros_clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&ros_clock));
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&ros_clock));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, RCL_S_TO_NS(100)));
+
+  // Callback i needs a jump of at least i microseconds forward or i / 2 microseconds backward.
+  size_t calls[kNumCallbacks] = {0u};
+  for (size_t i = 0u; i < kNumCallbacks; ++i) {
+    rcl_jump_threshold_t threshold;
+    threshold.on_clock_change = (0u == i % 3u);
+    threshold.min_forward.nanoseconds = RCL_US_TO_NS(static_cast<int64_t>(i));
+    threshold.min_backward.nanoseconds = -RCL_US_TO_NS(static_cast<int64_t>(i / 2));
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_clock_add_jump_callback(&ros_clock, threshold, count_callback, &calls[i])) <<
+      rcl_get_error_string().str;
+  }
+  // Remove every fourth callback, in an order which moves callbacks around.
+  for (size_t i = kNumCallbacks; i > 0u; --i) {
+    if (0u == (i - 1) % 4u) {
+      EXPECT_EQ(
+        RCL_RET_OK, rcl_clock_remove_jump_callback(&ros_clock, count_callback, &calls[i - 1]));
+    }
+  }
+  EXPECT_EQ(kNumCallbacks - kNumCallbacks / 4u, ros_clock.num_jump_callbacks);
+
+  auto expect_calls = [&](auto should_be_called) {
+      for (size_t i = 0u; i < kNumCallbacks; ++i) {
+        const bool removed = (0u == i % 4u);
+        EXPECT_EQ(!removed && should_be_called(i) ? 1u : 0u, calls[i]) << "callback " << i;
+        calls[i] = 0u;
+      }
+    };
+
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, RCL_S_TO_NS(100) + RCL_US_TO_NS(300)));
+  expect_calls([](size_t i) {return i <= 300u;});
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, RCL_S_TO_NS(100)));
+  expect_calls([](size_t i) {return i / 2u <= 300u;});
+  ASSERT_EQ(RCL_RET_OK, rcl_disable_ros_time_override(&ros_clock));
+  expect_calls([](size_t i) {return 0u == i % 3u;});
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), attached_ros_clocks) {
+  const size_t kNumClocks = 5u;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t source;
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init(&source, &allocator)) << rcl_get_error_string().str;
+  rcl_clock_t system_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_system_clock_init(&system_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_system_clock_fini(&system_clock));
+  });
+
+  rcl_clock_t clock;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_init_attached(nullptr, &source, &allocator));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_init_attached(&clock, nullptr, &allocator));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_init_attached(&clock, &source, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_init_attached(&clock, &system_clock, &allocator));
+  rcl_reset_error();
+
+  rcl_clock_t clocks[kNumClocks];
+  size_t calls[kNumClocks] = {0u};
+  rcl_jump_threshold_t threshold;
+  threshold.on_clock_change = true;
+  threshold.min_forward.nanoseconds = 1;
+  threshold.min_backward.nanoseconds = -1;
+  for (size_t i = 0u; i < kNumClocks; ++i) {
+    ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init_attached(&clocks[i], &source, &allocator)) <<
+      rcl_get_error_string().str;
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_clock_add_jump_callback(&clocks[i], threshold, count_callback, &calls[i])) <<
+      rcl_get_error_string().str;
+  }
+  // The source can go away before the clocks attached to it.
+  EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&source));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumClocks; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clocks[i]));
+    }
+  });
+
+  // Enabling, setting and disabling the override through one clock changes all of them.
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clocks[0]));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clocks[kNumClocks - 1], RCL_S_TO_NS(42)));
+  for (size_t i = 0u; i < kNumClocks; ++i) {
+    bool is_enabled = false;
+    EXPECT_EQ(RCL_RET_OK, rcl_is_enabled_ros_time_override(&clocks[i], &is_enabled));
+    EXPECT_TRUE(is_enabled);
+    rcl_time_point_value_t now = 0;
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[i], &now));
+    EXPECT_EQ(RCL_S_TO_NS(42), now);
+    // Called once for the activation and once for the jump.
+    EXPECT_EQ(2u, calls[i]);
+    calls[i] = 0u;
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_disable_ros_time_override(&clocks[2]));
+  for (size_t i = 0u; i < kNumClocks; ++i) {
+    bool is_enabled = true;
+    EXPECT_EQ(RCL_RET_OK, rcl_is_enabled_ros_time_override(&clocks[i], &is_enabled));
+    EXPECT_FALSE(is_enabled);
+    EXPECT_EQ(1u, calls[i]);
+  }
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), attached_ros_clocks_concurrent) {
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t source;
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init(&source, &allocator)) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&source));
+  });
+  size_t calls = 0u;
+  rcl_jump_threshold_t threshold;
+  threshold.on_clock_change = true;
+  threshold.min_forward.nanoseconds = 1;
+  threshold.min_backward.nanoseconds = -1;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_clock_add_jump_callback(&source, threshold, count_callback, &calls)) <<
+    rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&source));
+  calls = 0u;
+
+  // Clocks are attached and finalized while the time of their source is set.
+  const size_t kNumIterations = 1000u;
+  std::thread attach_thread([&source, &allocator]() {
+      for (size_t i = 0u; i < kNumIterations; ++i) {
+        rcl_clock_t clock;
+        EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_init_attached(&clock, &source, &allocator));
+        EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&clock));
+      }
+    });
+  for (size_t i = 0u; i < kNumIterations; ++i) {
+    const int64_t seconds = static_cast<int64_t>(i) + 1;
+    EXPECT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&source, RCL_S_TO_NS(seconds)));
+  }
+  attach_thread.join();
+  EXPECT_EQ(kNumIterations, calls);
+  rcl_time_point_value_t now = 0;
+  EXPECT_EQ(RCL_RET_OK, rcl_clock_get_now(&source, &now));
+  EXPECT_EQ(RCL_S_TO_NS(static_cast<int64_t>(kNumIterations)), now);
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), coarse_time) {
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_clock_enable_coarse_time(nullptr));
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_clock_uses_coarse_time(nullptr));
+
+  rcl_clock_t ros_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init(&ros_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&ros_clock));
+  });
+  EXPECT_EQ(RCL_RET_UNSUPPORTED, rcl_clock_enable_coarse_time(&ros_clock));
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_clock_uses_coarse_time(&ros_clock));
+
+  rcl_clock_t steady_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_steady_clock_init(&steady_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_steady_clock_fini(&steady_clock));
+  });
+  rcl_clock_t coarse_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_steady_clock_init(&coarse_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_steady_clock_fini(&coarse_clock));
+  });
+  rcl_ret_t ret = rcl_clock_enable_coarse_time(&coarse_clock);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    rcl_reset_error();
+    EXPECT_FALSE(rcl_clock_uses_coarse_time(&coarse_clock));
+    return;
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(rcl_clock_uses_coarse_time(&coarse_clock));
+  EXPECT_FALSE(rcl_clock_uses_coarse_time(&steady_clock));
+  EXPECT_EQ(RCL_STEADY_TIME, coarse_clock.type);
+
+  // The coarse clock lags the precise one by at most a tick.
+  rcl_time_point_value_t precise_now = 0;
+  rcl_time_point_value_t coarse_now = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&coarse_clock, &coarse_now));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&steady_clock, &precise_now));
+  EXPECT_LE(coarse_now, precise_now);
+  EXPECT_LT(precise_now - coarse_now, RCL_MS_TO_NS(50));
+}
+
+// Measure the cost of reading each kind of clock.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), DISABLED_clock_get_now_cost) {
+  const size_t kCalls = 1000000u;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t clocks[5];
+  const char * names[5] = {"ros", "system", "steady", "coarse system", "coarse steady"};
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init(&clocks[0], &allocator));
+  ASSERT_EQ(RCL_RET_OK, rcl_system_clock_init(&clocks[1], &allocator));
+  ASSERT_EQ(RCL_RET_OK, rcl_steady_clock_init(&clocks[2], &allocator));
+  ASSERT_EQ(RCL_RET_OK, rcl_system_clock_init(&clocks[3], &allocator));
+  ASSERT_EQ(RCL_RET_OK, rcl_steady_clock_init(&clocks[4], &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (rcl_clock_t & clock : clocks) {
+      EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock));
+    }
+  });
+  size_t clock_count = 5u;
+  if (
+    RCL_RET_OK != rcl_clock_enable_coarse_time(&clocks[3]) ||
+    RCL_RET_OK != rcl_clock_enable_coarse_time(&clocks[4]))
+  {
+    rcl_reset_error();
+    clock_count = 3u;  // Coarse time is not available.
+  }
+
+  std::stringstream ss;
+  ss << "rcl_clock_get_now cost over " << kCalls << " calls:";
+  for (size_t c = 0u; c < clock_count; ++c) {
+    rcl_time_point_value_t now = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0u; i < kCalls; ++i) {
+      ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clocks[c], &now));
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+    ss << " " << names[c] << " " << static_cast<double>(elapsed.count()) / kCalls << " ns/call;";
+  }
+  RCUTILS_LOG_INFO_NAMED(ROS_PACKAGE_NAME, "%s", ss.str().c_str());
+}
+
+TEST(CLASSNAME(rcl_time, RMW_IMPLEMENTATION), ros_clock_rate) {
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t ros_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init(&ros_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&ros_clock));
+  });
+  rcl_clock_t attached_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_init_attached(&attached_clock, &ros_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_fini(&attached_clock));
+  });
+  rcl_clock_t steady_clock;
+  ASSERT_EQ(RCL_RET_OK, rcl_steady_clock_init(&steady_clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_steady_clock_fini(&steady_clock));
+  });
+
+  double rate = 0.0;
+  EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_get_rate(&ros_clock, &rate));
+  EXPECT_EQ(1.0, rate);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_set_rate(nullptr, 2.0));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_get_rate(&ros_clock, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_ERROR, rcl_ros_clock_set_rate(&steady_clock, 2.0));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_set_rate(&ros_clock, 0.0));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_set_rate(&ros_clock, -2.0));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_ros_clock_set_rate(&ros_clock, 1e9));
+  rcl_reset_error();
+
+  // The rate is shared by attached clocks.
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_set_rate(&attached_clock, 20.0));
+  EXPECT_EQ(RCL_RET_OK, rcl_ros_clock_get_rate(&ros_clock, &rate));
+  EXPECT_EQ(20.0, rate);
+
+  // Only overridden ROS time is scaled.
+  rcl_duration_value_t wall_duration = 0;
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_get_wall_duration(&ros_clock, RCL_S_TO_NS(2), &wall_duration));
+  EXPECT_EQ(RCL_S_TO_NS(2), wall_duration);
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_get_wall_duration(&steady_clock, RCL_S_TO_NS(2), &wall_duration));
+  EXPECT_EQ(RCL_S_TO_NS(2), wall_duration);
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&ros_clock));
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_get_wall_duration(&ros_clock, RCL_S_TO_NS(2), &wall_duration));
+  EXPECT_EQ(RCL_MS_TO_NS(100), wall_duration);
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_get_wall_duration(&ros_clock, -RCL_S_TO_NS(2), &wall_duration));
+  EXPECT_EQ(-RCL_MS_TO_NS(100), wall_duration);
+  EXPECT_EQ(RCL_RET_OK, rcl_clock_get_wall_duration(&ros_clock, INT64_MAX, &wall_duration));
+  EXPECT_EQ(INT64_MAX, wall_duration);
+
+  // Slower than real time saturates instead of overflowing.
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_set_rate(&ros_clock, 0.01));
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_get_wall_duration(&ros_clock, INT64_MAX / 2, &wall_duration));
+  EXPECT_EQ(INT64_MAX, wall_duration);
+}
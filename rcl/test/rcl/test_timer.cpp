@@ -13,8 +13,11 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
+#include <sstream>
 #include <thread>
+#include <vector>
 
 #include "rcl/timer.h"
 
@@ -22,6 +25,7 @@
 
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
 #include "rcl/error_handling.h"
+#include "rcutils/logging_macros.h"
 
 #include "./allocator_testing_utils.h"
 
@@ -880,3 +884,412 @@ TEST_F(TestPreInitTimer, test_time_since_last_call) {
   ASSERT_EQ(RCL_RET_OK, rcl_timer_get_time_since_last_call(&timer, &time_sice_next_call_end));
   EXPECT_GT(time_sice_next_call_end, time_sice_next_call_start);
 }
+
+TEST_F(TestPreInitTimer, test_timer_get_next_call_time) {
+  int64_t next_call_time = 0;
+  int64_t time_until_next_call = 0;
+  rcl_time_point_value_t now = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_get_now(&clock, &now));
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_time_until_next_call(&timer, &time_until_next_call));
+  EXPECT_LE(next_call_time - now, RCL_S_TO_NS(1));
+  EXPECT_GE(next_call_time - now, time_until_next_call);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_call(&timer)) << rcl_get_error_string().str;
+  int64_t next_call_time_after_call = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time_after_call));
+  EXPECT_GT(next_call_time_after_call, next_call_time);
+
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_next_call_time(nullptr, &next_call_time));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_next_call_time(&timer, nullptr));
+  rcl_reset_error();
+  rcl_timer_t zero_timer = rcl_get_zero_initialized_timer();
+  EXPECT_EQ(RCL_RET_TIMER_INVALID, rcl_timer_get_next_call_time(&zero_timer, &next_call_time));
+  rcl_reset_error();
+}
+
+TEST_F(TestPreInitTimer, test_timer_at_given_time) {
+  int64_t next_call_time = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+
+  int64_t time_until_next_call = 0;
+  bool is_ready = true;
+  ASSERT_EQ(
+    RCL_RET_OK,
+    rcl_timer_get_time_until_next_call_at(&timer, next_call_time - 10, &time_until_next_call));
+  EXPECT_EQ(10, time_until_next_call);
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_is_ready_at(&timer, next_call_time - 10, &is_ready));
+  EXPECT_FALSE(is_ready);
+  ASSERT_EQ(
+    RCL_RET_OK,
+    rcl_timer_get_time_until_next_call_at(&timer, next_call_time, &time_until_next_call));
+  EXPECT_EQ(0, time_until_next_call);
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_is_ready_at(&timer, next_call_time, &is_ready));
+  EXPECT_TRUE(is_ready);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&timer)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_is_ready_at(&timer, next_call_time, &is_ready));
+  EXPECT_FALSE(is_ready);
+
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_is_ready_at(nullptr, 0, &is_ready));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_is_ready_at(&timer, 0, nullptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_timer_get_time_until_next_call_at(nullptr, 0, &time_until_next_call));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_get_time_until_next_call_at(&timer, 0, nullptr));
+  rcl_reset_error();
+  rcl_timer_t zero_timer = rcl_get_zero_initialized_timer();
+  EXPECT_EQ(RCL_RET_TIMER_INVALID, rcl_timer_is_ready_at(&zero_timer, 0, &is_ready));
+  rcl_reset_error();
+}
+
+TEST_F(TestTimerFixture, test_kernel_wakeup_unsupported) {
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_init(RCL_ROS_TIME, &clock, &allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(
+      &timer, &clock, this->context_ptr, RCL_MS_TO_NS(1), nullptr, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ(RCL_RET_UNSUPPORTED, rcl_timer_enable_kernel_wakeup(&timer));
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_timer_uses_kernel_wakeup(&timer));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_timer_enable_kernel_wakeup(nullptr));
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_timer_uses_kernel_wakeup(nullptr));
+}
+
+TEST_F(TestTimerFixture, test_shared_guard_condition) {
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  // Initialized before sharing is enabled, so it keeps its own guard condition.
+  rcl_timer_t own_timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(
+      &own_timer, &clock, this->context_ptr, RCL_S_TO_NS(10), nullptr, allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&own_timer)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_clock_enable_shared_timer_guard_condition(&clock, this->context_ptr)) <<
+    rcl_get_error_string().str;
+  EXPECT_EQ(
+    RCL_RET_OK, rcl_clock_enable_shared_timer_guard_condition(&clock, this->context_ptr)) <<
+    rcl_get_error_string().str;
+
+  rcl_timer_t timers[3];
+  for (rcl_timer_t & timer : timers) {
+    timer = rcl_get_zero_initialized_timer();
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_timer_init(
+        &timer, &clock, this->context_ptr, RCL_S_TO_NS(10), nullptr, allocator)) <<
+      rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (rcl_timer_t & timer : timers) {
+      EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+    }
+  });
+  EXPECT_FALSE(rcl_timer_uses_shared_guard_condition(&own_timer));
+  rcl_guard_condition_t * shared_guard_condition = rcl_timer_get_guard_condition(&timers[0]);
+  ASSERT_NE(nullptr, shared_guard_condition);
+  EXPECT_NE(shared_guard_condition, rcl_timer_get_guard_condition(&own_timer));
+  for (rcl_timer_t & timer : timers) {
+    EXPECT_TRUE(rcl_timer_uses_shared_guard_condition(&timer));
+    EXPECT_EQ(shared_guard_condition, rcl_timer_get_guard_condition(&timer));
+  }
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_init(
+      &wait_set, 0, 0, 4, 0, 0, 0, this->context_ptr, allocator)) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &own_timer, NULL));
+  for (rcl_timer_t & timer : timers) {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, NULL));
+  }
+  // Resetting any timer of the clock wakes the wait set through the shared guard condition.
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&timers[1])) << rcl_get_error_string().str;
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&wait_set, RCL_S_TO_NS(5))) << rcl_get_error_string().str;
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  for (size_t i = 0u; i < wait_set.size_of_timers; ++i) {
+    EXPECT_EQ(nullptr, wait_set.timers[i]);
+  }
+
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_clock_enable_shared_timer_guard_condition(nullptr, this->context_ptr));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_clock_enable_shared_timer_guard_condition(&clock, nullptr));
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_timer_uses_shared_guard_condition(nullptr));
+}
+
+// Wait on a 1 kHz steady timer and return how late each wake up was, in nanoseconds.
+static std::vector<int64_t>
+measure_wakeup_lateness(rcl_context_t * context, bool kernel_wakeup, size_t iterations)
+{
+  std::vector<int64_t> lateness;
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_ret_t ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(&timer, &clock, context, RCL_MS_TO_NS(1), nullptr, allocator);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  if (kernel_wakeup) {
+    ret = rcl_timer_enable_kernel_wakeup(&timer);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_TRUE(rcl_timer_uses_kernel_wakeup(&timer));
+  }
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&wait_set, 0, 0, 1, 0, 0, 0, context, allocator);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+
+  while (lateness.size() < iterations) {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, NULL)) <<
+      rcl_get_error_string().str;
+    int64_t next_call_time = 0;
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timer, &next_call_time));
+    ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+    if (RCL_RET_OK != ret) {
+      ADD_FAILURE() << rcl_get_error_string().str;
+      break;
+    }
+    if (NULL == wait_set.timers[0]) {
+      continue;  // Woken up early, e.g. by the guard condition of the previous call.
+    }
+    rcl_time_point_value_t now = 0;
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_get_now(&clock, &now));
+    lateness.push_back(now - next_call_time);
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_call(&timer)) << rcl_get_error_string().str;
+  }
+  return lateness;
+}
+
+TEST_F(TestTimerFixture, test_kernel_wakeup) {
+#ifdef __linux__
+  const size_t kIterations = 10u;
+  for (bool kernel_wakeup : {false, true}) {
+    std::vector<int64_t> lateness =
+      measure_wakeup_lateness(this->context_ptr, kernel_wakeup, kIterations);
+    ASSERT_EQ(kIterations, lateness.size());
+    // A timer is never ready before its deadline.
+    EXPECT_GE(*std::min_element(lateness.begin(), lateness.end()), 0);
+  }
+#else
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(
+      &timer, &clock, this->context_ptr, RCL_MS_TO_NS(1), nullptr, allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  EXPECT_EQ(RCL_RET_UNSUPPORTED, rcl_timer_enable_kernel_wakeup(&timer));
+  rcl_reset_error();
+#endif
+}
+
+// Compare how late a 1 kHz timer wakes up with a computed timeout and with a kernel timer.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST_F(TestTimerFixture, DISABLED_test_kernel_wakeup_jitter) {
+#ifdef __linux__
+  const size_t kIterations = 500u;
+  for (bool kernel_wakeup : {false, true}) {
+    std::vector<int64_t> lateness =
+      measure_wakeup_lateness(this->context_ptr, kernel_wakeup, kIterations);
+    ASSERT_EQ(kIterations, lateness.size());
+    std::sort(lateness.begin(), lateness.end());
+    int64_t sum = 0;
+    for (int64_t value : lateness) {
+      sum += value;
+    }
+    std::stringstream ss;
+    ss << (kernel_wakeup ? "kernel timer" : "computed timeout") << " wake up lateness at 1 kHz:" <<
+      " mean " << sum / static_cast<int64_t>(lateness.size()) << "ns," <<
+      " p50 " << lateness[lateness.size() / 2] << "ns," <<
+      " p99 " << lateness[lateness.size() * 99 / 100] << "ns," <<
+      " max " << lateness.back() << "ns";
+    RCUTILS_LOG_INFO_NAMED("test_timer", "%s", ss.str().c_str());
+  }
+#endif
+}
+
+TEST_F(TestTimerFixture, test_kernel_wakeup_ready_timer_not_called) {
+#ifdef __linux__
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_init(
+      &timer, &clock, this->context_ptr, RCL_MS_TO_NS(1), nullptr, allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_enable_kernel_wakeup(&timer)) << rcl_get_error_string().str;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_init(
+      &wait_set, 0, 0, 1, 0, 0, 0, this->context_ptr, allocator)) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+
+  // Wait until the timer is reported ready, without calling it.
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, NULL));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait(&wait_set, RCL_S_TO_NS(1))) << rcl_get_error_string().str;
+  while (NULL == wait_set.timers[0]) {
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, NULL));
+    ASSERT_EQ(RCL_RET_OK, rcl_wait(&wait_set, RCL_S_TO_NS(1))) << rcl_get_error_string().str;
+  }
+
+  // Its kernel timer fired already, yet the timer is due so the next wait does not block.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, NULL));
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&wait_set, RCL_S_TO_NS(5))) << rcl_get_error_string().str;
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  EXPECT_EQ(&timer, wait_set.timers[0]);
+#endif
+}
+
+TEST_F(TestTimerFixture, test_timer_call_ready_batch) {
+  const size_t kNumTimers = 4u;
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ASSERT_EQ(RCL_RET_OK, rcl_clock_init(RCL_ROS_TIME, &clock, &allocator)) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(1))) <<
+    rcl_get_error_string().str;
+
+  // Timer i fires every (i + 1) seconds, the last one is canceled.
+  rcl_timer_t timers[kNumTimers];
+  for (size_t i = 0u; i < kNumTimers; ++i) {
+    timers[i] = rcl_get_zero_initialized_timer();
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_timer_init(
+        &timers[i], &clock, this->context_ptr, RCL_S_TO_NS(i + 1),
+        0u == i ? &callback_function : nullptr, allocator)) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumTimers; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timers[i])) << rcl_get_error_string().str;
+    }
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&timers[kNumTimers - 1])) << rcl_get_error_string().str;
+
+  const rcl_timer_t * batch[kNumTimers + 1] = {
+    &timers[0], nullptr, &timers[1], &timers[2], &timers[3]};
+  rcl_timer_batch_call_t calls[kNumTimers + 1];
+  size_t call_count = 42u;
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_MS_TO_NS(3500))) <<
+    rcl_get_error_string().str;
+  times_called = 0;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_call_ready_batch(batch, kNumTimers + 1, calls, &call_count)) <<
+    rcl_get_error_string().str;
+  // Callbacks are left to the caller.
+  EXPECT_EQ(0, times_called);
+  ASSERT_EQ(2u, call_count);
+  EXPECT_EQ(&timers[0], calls[0].timer);
+  EXPECT_EQ(&callback_function, calls[0].callback);
+  EXPECT_EQ(RCL_MS_TO_NS(2500), calls[0].time_since_last_call);
+  EXPECT_EQ(&timers[1], calls[1].timer);
+  EXPECT_EQ(nullptr, calls[1].callback);
+  EXPECT_EQ(RCL_MS_TO_NS(2500), calls[1].time_since_last_call);
+
+  // Same next call times as if the timers had been called one by one.
+  int64_t next_call_time = 0;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timers[0], &next_call_time));
+  EXPECT_EQ(RCL_S_TO_NS(4), next_call_time);
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timers[1], &next_call_time));
+  EXPECT_EQ(RCL_S_TO_NS(5), next_call_time);
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_get_next_call_time(&timers[2], &next_call_time));
+  EXPECT_EQ(RCL_S_TO_NS(4), next_call_time);
+
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_timer_call_ready_batch(batch, kNumTimers + 1, calls, &call_count)) <<
+    rcl_get_error_string().str;
+  EXPECT_EQ(0u, call_count);
+
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_timer_call_ready_batch(nullptr, 0u, calls, &call_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_timer_call_ready_batch(batch, 1u, nullptr, &call_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_timer_call_ready_batch(batch, 1u, calls, nullptr));
+  rcl_reset_error();
+  rcl_timer_t zero_timer = rcl_get_zero_initialized_timer();
+  const rcl_timer_t * invalid_batch[1] = {&zero_timer};
+  EXPECT_EQ(
+    RCL_RET_TIMER_INVALID, rcl_timer_call_ready_batch(invalid_batch, 1u, calls, &call_count));
+  rcl_reset_error();
+}
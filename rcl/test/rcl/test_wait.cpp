@@ -103,7 +103,10 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), test_failed_resize) {
   EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
 
   set_failing_allocator_is_failing(allocator, true);
+  // Shrinking, or keeping the size, reuses the capacity.
   ret = rcl_wait_set_resize(&wait_set, 0, 1, 0, 0, 0, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_resize(&wait_set, 0, 2, 0, 0, 0, 0);
   EXPECT_EQ(RCL_RET_BAD_ALLOC, ret);
   rcl_reset_error();
 
@@ -210,6 +213,55 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), negative_timeout) {
   EXPECT_LE(diff, RCL_MS_TO_NS(10) + TOLERANCE);
 }
 
+// Test rcl_wait with a timer on ROS time running faster than wall time
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), accelerated_ros_time_timeout) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 0, 1, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_ros_clock_init(&clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_clock_fini(&clock);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&clock));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&clock, RCL_S_TO_NS(1)));
+  // Replaying at 10 times real time.
+  ASSERT_EQ(RCL_RET_OK, rcl_ros_clock_set_rate(&clock, 10.0)) << rcl_get_error_string().str;
+
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, RCL_S_TO_NS(1), nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_timer_fini(&timer);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ret = rcl_wait_set_add_timer(&wait_set, &timer, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  std::chrono::steady_clock::time_point before_sc = std::chrono::steady_clock::now();
+  ret = rcl_wait(&wait_set, -1);
+  std::chrono::steady_clock::time_point after_sc = std::chrono::steady_clock::now();
+  // Woken up by the timer timeout, although nothing set the ROS time, so it is not ready yet.
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(nullptr, wait_set.timers[0]);
+  // The one second of ROS time is expected to take a tenth of a second of wall time.
+  int64_t diff = std::chrono::duration_cast<std::chrono::nanoseconds>(after_sc - before_sc).count();
+  EXPECT_LE(diff, RCL_MS_TO_NS(100) + TOLERANCE);
+}
+
 // Test rcl_wait with a timeout value of 0 (non-blocking)
 TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), zero_timeout) {
   rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
@@ -588,6 +640,172 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), guard_condition) {
   EXPECT_LE(std::abs(diff - trigger_diff.count()), TOLERANCE);
 }
 
+// Check the counters of the waits on a wait set
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), wait_statistics) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_statistics_t statistics;
+  ret = rcl_wait_set_get_statistics(&wait_set, &statistics);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    // rcl was built without statistics.
+    rcl_reset_error();
+    return;
+  }
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, statistics.wait_count);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_get_statistics(nullptr, &statistics));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_get_statistics(&wait_set, nullptr));
+  rcl_reset_error();
+
+  rcl_guard_condition_t guard_cond = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_cond, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_guard_condition_fini(&guard_cond);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  // An empty wait set fails, then one wait times out and one is woken up.
+  EXPECT_EQ(RCL_RET_WAIT_SET_EMPTY, rcl_wait(&wait_set, 0));
+  rcl_reset_error();
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const int64_t timeout = RCL_MS_TO_NS(10);
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, timeout));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_cond));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&wait_set, timeout));
+
+  ret = rcl_wait_set_get_statistics(&wait_set, &statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(3u, statistics.wait_count);
+  EXPECT_EQ(1u, statistics.ready_wakeup_count);
+  EXPECT_EQ(1u, statistics.timeout_wakeup_count);
+  EXPECT_EQ(1u, statistics.error_count);
+  EXPECT_GE(statistics.wait_duration_ns, static_cast<uint64_t>(timeout));
+  EXPECT_GE(statistics.max_wait_duration_ns, static_cast<uint64_t>(timeout));
+  EXPECT_LE(statistics.max_wait_duration_ns, statistics.wait_duration_ns);
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), wait_profile) {
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret =
+    rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_profile_t profile;
+  ret = rcl_wait_set_get_profile(&wait_set, &profile);
+  if (RCL_RET_UNSUPPORTED == ret) {
+    // rcl was built without statistics.
+    rcl_reset_error();
+    return;
+  }
+  EXPECT_EQ(RCL_RET_NOT_INIT, ret);
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_NOT_INIT, rcl_wait_set_reset_profile(&wait_set));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_set_profiling(nullptr, true));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_profiling(&wait_set, true));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_get_profile(&wait_set, nullptr));
+  rcl_reset_error();
+
+  rcl_guard_condition_t guard_cond = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_cond, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_guard_condition_fini(&guard_cond);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  // One wait times out and one is woken up by the guard condition.
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const int64_t timeout = RCL_MS_TO_NS(10);
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, timeout));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_cond));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_cond, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&wait_set, timeout));
+
+  ret = rcl_wait_set_get_profile(&wait_set, &profile);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, profile.timeout_count);
+  EXPECT_EQ(0u, profile.spurious_count);
+  EXPECT_EQ(1u, profile.ready_counts[RCL_WAIT_SET_GUARD_CONDITION]);
+  EXPECT_EQ(0u, profile.ready_counts[RCL_WAIT_SET_SUBSCRIPTION]);
+  uint64_t blocked_count = 0u;
+  uint64_t overshoot_count = 0u;
+  for (size_t i = 0u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    blocked_count += profile.blocked.counts[i];
+    overshoot_count += profile.overshoot.counts[i];
+  }
+  EXPECT_EQ(2u, blocked_count);
+  EXPECT_EQ(1u, overshoot_count);
+  // The wait which timed out blocked for at least the timeout.
+  uint64_t longest_blocked = 0u;
+  ret = rcl_wait_set_histogram_percentile(&profile.blocked, 100.0, &longest_blocked);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_GE(longest_blocked, static_cast<uint64_t>(timeout));
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_reset_profile(&wait_set));
+  ret = rcl_wait_set_get_profile(&wait_set, &profile);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, profile.timeout_count);
+  EXPECT_EQ(0u, profile.ready_counts[RCL_WAIT_SET_GUARD_CONDITION]);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_set_profiling(&wait_set, false));
+  EXPECT_EQ(RCL_RET_NOT_INIT, rcl_wait_set_get_profile(&wait_set, &profile));
+  rcl_reset_error();
+}
+
+TEST(WaitSetHistogramTest, buckets_and_percentiles) {
+  for (size_t i = 1u; i < RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT; ++i) {
+    EXPECT_LT(
+      rcl_wait_set_histogram_bucket_lower_bound(i - 1u),
+      rcl_wait_set_histogram_bucket_lower_bound(i));
+  }
+  EXPECT_EQ(7u, rcl_wait_set_histogram_bucket_lower_bound(7u));
+  EXPECT_EQ(UINT64_MAX, rcl_wait_set_histogram_bucket_lower_bound(
+      RCL_WAIT_SET_HISTOGRAM_BUCKET_COUNT));
+
+  rcl_wait_set_histogram_t histogram = {};
+  uint64_t value = 42u;
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_histogram_percentile(&histogram, 50.0, &value));
+  EXPECT_EQ(0u, value);
+  histogram.counts[3] = 50u;
+  histogram.counts[20] = 50u;
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_histogram_percentile(&histogram, 50.0, &value));
+  EXPECT_EQ(3u, value);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_histogram_percentile(&histogram, 99.0, &value));
+  EXPECT_EQ(rcl_wait_set_histogram_bucket_lower_bound(21u) - 1u, value);
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_histogram_percentile(&histogram, 101.0, &value));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_histogram_percentile(nullptr, 50.0, &value));
+  rcl_reset_error();
+}
+
 // Check that index arguments are properly set when adding entities
 TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), add_with_index) {
   const size_t kNumEntities = 3u;
@@ -776,3 +994,633 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), wait_set_test_maybe_in
     }
   });
 }
+
+// Check that a persistent wait set can be waited on repeatedly without being rebuilt
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), persistent_wait_set) {
+  const size_t kNumEntities = 3u;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &wait_set, 0, kNumEntities, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  EXPECT_FALSE(rcl_wait_set_is_persistent(&wait_set));
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_persist(nullptr));
+  rcl_reset_error();
+
+  rcl_guard_condition_t guard_conditions[kNumEntities];
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], NULL);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumEntities; ++i) {
+      ret = rcl_guard_condition_fini(&guard_conditions[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+
+  ret = rcl_wait_set_persist(&wait_set);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(rcl_wait_set_is_persistent(&wait_set));
+
+  for (size_t spin = 0u; spin < 2 * kNumEntities; ++spin) {
+    const size_t triggered = spin % kNumEntities;
+    ret = rcl_trigger_guard_condition(&guard_conditions[triggered]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    for (size_t i = 0u; i < kNumEntities; ++i) {
+      // Entities are not pruned from a persistent wait set.
+      EXPECT_EQ(&guard_conditions[i], wait_set.guard_conditions[i]);
+      bool is_ready = false;
+      ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, i, &is_ready);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_EQ(i == triggered, is_ready);
+    }
+  }
+
+  bool is_ready = false;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, kNumEntities, &is_ready));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_SUBSCRIPTION, 0u, &is_ready));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, 0u, nullptr));
+  rcl_reset_error();
+
+  // Clearing the wait set drops the snapshot.
+  ret = rcl_wait_set_clear(&wait_set);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_FALSE(rcl_wait_set_is_persistent(&wait_set));
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[0], NULL);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_trigger_guard_condition(&guard_conditions[0]);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, 0u, &is_ready);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(is_ready);
+}
+
+// Check that a wait set pruned by rcl_wait() has to be filled again before it is made persistent
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), persist_after_wait) {
+  const size_t kNumGuardConditions = 2u;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t clock;
+  rcl_ret_t ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(&timer, &clock, this->context_ptr, RCL_S_TO_NS(100), nullptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  rcl_guard_condition_t guard_conditions[kNumGuardConditions];
+  for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_conditions[i]));
+    }
+  });
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, 0, kNumGuardConditions, 1, 0, 0, 0, context_ptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  auto fill = [&]() {
+      for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+        ASSERT_EQ(
+          RCL_RET_OK, rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], NULL));
+      }
+      ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_timer(&wait_set, &timer, NULL));
+    };
+
+  // Nothing is ready, so rcl_wait() sets every entity to NULL.
+  fill();
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, 0)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_WAIT_SET_INVALID, rcl_wait_set_persist(&wait_set));
+  rcl_reset_error();
+  EXPECT_FALSE(rcl_wait_set_is_persistent(&wait_set));
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set)) << rcl_get_error_string().str;
+  fill();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+  // Every wait passes the same entities, with the timer's guard condition moved only once.
+  for (size_t spin = 0u; spin < 2 * kNumGuardConditions; ++spin) {
+    const size_t triggered = spin % kNumGuardConditions;
+    ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[triggered]));
+    ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    bool is_ready = true;
+    for (size_t i = 0u; i < kNumGuardConditions; ++i) {
+      ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, i, &is_ready);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_EQ(i == triggered, is_ready);
+    }
+    ret = rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_TIMER, 0u, &is_ready);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_FALSE(is_ready);
+  }
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, 0)) << rcl_get_error_string().str;
+}
+
+// Check that spinning a wait set reused across spins allocates nothing
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), steady_state_spin_allocations) {
+  const size_t kNumGuardConditions = 8u;
+  std::vector<rcl_guard_condition_t> guard_conditions(kNumGuardConditions);
+  for (auto & guard_condition : guard_conditions) {
+    guard_condition = rcl_get_zero_initialized_guard_condition();
+    rcl_ret_t ret = rcl_guard_condition_init(
+      &guard_condition, this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (auto & guard_condition : guard_conditions) {
+      EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition));
+    }
+  });
+  rcl_allocator_t allocator = get_counting_allocator();
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &wait_set, 0, kNumGuardConditions, 0, 0, 0, 0, context_ptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  // Warm up the persistent storage once.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+
+  // Spin like a dynamic executor, whose entities come and go between spins.
+  const size_t allocations = get_counting_allocator_allocations(allocator);
+  for (size_t spin = 0u; spin < 100u; ++spin) {
+    const size_t num_entities = 1u + spin % kNumGuardConditions;
+    ret = rcl_wait_set_resize(&wait_set, 0, num_entities, 0, 0, 0, 0);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    for (size_t i = 0u; i < num_entities; ++i) {
+      ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], NULL);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+    ret = rcl_wait(&wait_set, 0);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set)) << rcl_get_error_string().str;
+    for (size_t i = 0u; i < num_entities; ++i) {
+      ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], NULL);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+    ret = rcl_wait(&wait_set, 0);
+    ASSERT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+  }
+  EXPECT_EQ(allocations, get_counting_allocator_allocations(allocator));
+
+  // Only growing past the capacity allocates, which shrinking gives back.
+  ret = rcl_wait_set_resize(&wait_set, 0, 2 * kNumGuardConditions, 0, 0, 0, 0);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_LT(allocations, get_counting_allocator_allocations(allocator));
+  EXPECT_EQ(2 * kNumGuardConditions, wait_set.size_of_guard_conditions);
+  ret = rcl_wait_set_resize(&wait_set, 0, 1, 0, 0, 0, 0);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_shrink_to_fit(&wait_set)) << rcl_get_error_string().str;
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[0], NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&wait_set, 0)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_shrink_to_fit(nullptr));
+  rcl_reset_error();
+}
+
+// Compare the per-spin cost of a wait set rebuilt on every spin with a persistent one.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), DISABLED_persistent_wait_set_spin_cost) {
+  const size_t kNumSpins = 100u;
+  for (size_t num_entities : {10u, 100u, 400u}) {
+    std::vector<rcl_guard_condition_t> guard_conditions(num_entities);
+    for (auto & guard_condition : guard_conditions) {
+      guard_condition = rcl_get_zero_initialized_guard_condition();
+      rcl_ret_t ret = rcl_guard_condition_init(
+        &guard_condition, this->context_ptr, rcl_guard_condition_get_default_options());
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+    rcl_ret_t ret = rcl_wait_set_init(
+      &wait_set, 0, num_entities, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+      for (auto & guard_condition : guard_conditions) {
+        EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition));
+      }
+    });
+
+    auto rebuild_start = std::chrono::steady_clock::now();
+    for (size_t spin = 0u; spin < kNumSpins; ++spin) {
+      ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set)) << rcl_get_error_string().str;
+      for (auto & guard_condition : guard_conditions) {
+        ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_condition, NULL);
+        ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      }
+      ret = rcl_wait(&wait_set, 0);
+      ASSERT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+    }
+    auto rebuild_end = std::chrono::steady_clock::now();
+
+    // The last wait pruned the wait set, so fill it once more before making it persistent.
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set)) << rcl_get_error_string().str;
+    for (auto & guard_condition : guard_conditions) {
+      ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_condition, NULL);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+    auto persistent_start = std::chrono::steady_clock::now();
+    for (size_t spin = 0u; spin < kNumSpins; ++spin) {
+      ret = rcl_wait(&wait_set, 0);
+      ASSERT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+    }
+    auto persistent_end = std::chrono::steady_clock::now();
+
+    std::stringstream ss;
+    ss << num_entities << " entities: " <<
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+      rebuild_end - rebuild_start).count() / kNumSpins << "ns per rebuilt spin, " <<
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+      persistent_end - persistent_start).count() / kNumSpins << "ns per persistent spin";
+    RCUTILS_LOG_INFO_NAMED(ROS_PACKAGE_NAME, "%s", ss.str().c_str());
+  }
+}
+
+// Check that rcl_wait_ex lists exactly the ready entities
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), wait_ex_ready_entities) {
+  const size_t kNumEntities = 5u;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(
+    &wait_set, 0, kNumEntities, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_guard_condition_t guard_conditions[kNumEntities];
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    guard_conditions[i] = rcl_get_zero_initialized_guard_condition();
+    ret = rcl_guard_condition_init(
+      &guard_conditions[i], this->context_ptr, rcl_guard_condition_get_default_options());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], NULL);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumEntities; ++i) {
+      ret = rcl_guard_condition_fini(&guard_conditions[i]);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  });
+
+  rcl_wait_set_ready_entity_t ready_entities[kNumEntities];
+  size_t ready_count = 42u;
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_ex(&wait_set, 0, ready_entities, kNumEntities - 1, &ready_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_ex(&wait_set, 0, nullptr, kNumEntities, &ready_count));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_ex(&wait_set, 0, ready_entities, kNumEntities, nullptr));
+  rcl_reset_error();
+
+  ret = rcl_wait_ex(&wait_set, 0, ready_entities, kNumEntities, &ready_count);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, ready_count);
+
+  ret = rcl_wait_set_clear(&wait_set);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[i], NULL);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[1]));
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[3]));
+  ret = rcl_wait_ex(&wait_set, RCL_MS_TO_NS(100), ready_entities, kNumEntities, &ready_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(2u, ready_count);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, ready_entities[0].type);
+  EXPECT_EQ(1u, ready_entities[0].index);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, ready_entities[1].type);
+  EXPECT_EQ(3u, ready_entities[1].index);
+}
+
+// Check that only the due timers are reported ready when timers of several clocks are waited on
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), timers_on_multiple_clocks) {
+  const size_t kNumRosTimers = 8u;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_clock_t ros_clock;
+  rcl_ret_t ret = rcl_clock_init(RCL_ROS_TIME, &ros_clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&ros_clock)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&ros_clock)) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, 0)) << rcl_get_error_string().str;
+  rcl_clock_t steady_clock;
+  ret = rcl_clock_init(RCL_STEADY_TIME, &steady_clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&steady_clock)) << rcl_get_error_string().str;
+  });
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(
+    &wait_set, 0, 0, kNumRosTimers + 1, 0, 0, 0, context_ptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+
+  // Interleave the clocks, timer i of the ROS clock fires every (i + 1) seconds.
+  rcl_timer_t ros_timers[kNumRosTimers];
+  rcl_timer_t steady_timer = rcl_get_zero_initialized_timer();
+  for (size_t i = 0u; i < kNumRosTimers; ++i) {
+    ros_timers[i] = rcl_get_zero_initialized_timer();
+    ret = rcl_timer_init(
+      &ros_timers[i], &ros_clock, this->context_ptr, RCL_S_TO_NS(i + 1), nullptr, allocator);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_add_timer(&wait_set, &ros_timers[i], NULL);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    if (kNumRosTimers / 2 == i) {
+      ret = rcl_timer_init(
+        &steady_timer, &steady_clock, this->context_ptr, RCL_S_TO_NS(100), nullptr, allocator);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      ret = rcl_wait_set_add_timer(&wait_set, &steady_timer, NULL);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    }
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0u; i < kNumRosTimers; ++i) {
+      EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&ros_timers[i])) << rcl_get_error_string().str;
+    }
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&steady_timer)) << rcl_get_error_string().str;
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+
+  // Returns the indices of the ROS timers reported ready.
+  auto ready_ros_timers = [&]() {
+      std::vector<size_t> ready;
+      for (size_t i = 0u; i < wait_set.size_of_timers; ++i) {
+        bool is_ready = false;
+        EXPECT_EQ(
+          RCL_RET_OK, rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_TIMER, i, &is_ready));
+        if (is_ready) {
+          EXPECT_NE(&steady_timer, wait_set.timers[i]);
+          ready.push_back(i > kNumRosTimers / 2 ? i - 1 : i);
+        }
+      }
+      return ready;
+    };
+
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(ready_ros_timers().empty());
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, RCL_MS_TO_NS(2500)));
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(std::vector<size_t>({0u, 1u}), ready_ros_timers());
+
+  // Calling the ready timers moves their deadlines past the ones of the timers not called yet.
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_call(&ros_timers[0])) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_call(&ros_timers[1])) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, RCL_MS_TO_NS(3500)));
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(std::vector<size_t>({0u, 2u}), ready_ros_timers());
+
+  // Cancelled timers are never ready.
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&ros_timers[0])) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_cancel(&ros_timers[2])) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&ros_clock, RCL_MS_TO_NS(4500)));
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(std::vector<size_t>({1u, 3u}), ready_ros_timers());
+
+  // Resetting a timer pushes its deadline back.
+  ASSERT_EQ(RCL_RET_OK, rcl_timer_reset(&ros_timers[3])) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, 0);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(std::vector<size_t>({1u}), ready_ros_timers());
+}
+
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), spin_budget) {
+  rcl_guard_condition_t guard_condition = rcl_get_zero_initialized_guard_condition();
+  rcl_ret_t ret = rcl_guard_condition_init(
+    &guard_condition, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  int64_t spin_budget = 0;
+  EXPECT_EQ(
+    RCL_RET_WAIT_SET_INVALID,
+    rcl_wait_set_set_spin_budget(&wait_set, RCL_US_TO_NS(50), RCL_WAIT_SET_SPIN_RELAX_NONE));
+  rcl_reset_error();
+  ret = rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition));
+  });
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_set_spin_budget(nullptr, RCL_US_TO_NS(50), RCL_WAIT_SET_SPIN_RELAX_NONE));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT,
+    rcl_wait_set_set_spin_budget(&wait_set, -1, RCL_WAIT_SET_SPIN_RELAX_NONE));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, rcl_wait_set_get_spin_budget(&wait_set, nullptr));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_spin_budget(&wait_set, &spin_budget));
+  EXPECT_EQ(0, spin_budget);
+
+  ret = rcl_wait_set_set_spin_budget(&wait_set, RCL_MS_TO_NS(5), RCL_WAIT_SET_SPIN_RELAX_PAUSE);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(&wait_set, &guard_condition, NULL));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+
+  // The budget does not extend the timeout.
+  auto before = std::chrono::steady_clock::now();
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait(&wait_set, RCL_MS_TO_NS(1))) << rcl_get_error_string().str;
+  auto elapsed = std::chrono::steady_clock::now() - before;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(5));
+  bool is_ready = true;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, 0, &is_ready));
+  EXPECT_FALSE(is_ready);
+
+  // Blocking takes over once the budget is spent.
+  ret = rcl_wait_set_set_spin_budget(&wait_set, RCL_US_TO_NS(100), RCL_WAIT_SET_SPIN_RELAX_YIELD);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  std::thread trigger_thread([&guard_condition]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      EXPECT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_condition));
+    });
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+  trigger_thread.join();
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_is_ready(&wait_set, RCL_WAIT_SET_GUARD_CONDITION, 0, &is_ready));
+  EXPECT_TRUE(is_ready);
+
+  // The budget is kept when the wait set is cleared.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_get_spin_budget(&wait_set, &spin_budget));
+  EXPECT_EQ(RCL_US_TO_NS(100), spin_budget);
+}
+
+// Measure how late rcl_wait() returns after a guard condition is triggered from another
+// thread, when blocking right away and when spinning first.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), DISABLED_spin_then_block_latency) {
+  const size_t kNumSamples = 500u;
+  const std::chrono::microseconds kTriggerPeriod(200);
+  rcl_guard_condition_t guard_condition = rcl_get_zero_initialized_guard_condition();
+  rcl_ret_t ret = rcl_guard_condition_init(
+    &guard_condition, this->context_ptr, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition));
+  });
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(&wait_set, &guard_condition, NULL));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_persist(&wait_set)) << rcl_get_error_string().str;
+
+  struct Strategy
+  {
+    const char * name;
+    int64_t spin_budget;
+    rcl_wait_set_spin_relax_t relax;
+  };
+  const Strategy strategies[] = {
+    {"block", 0, RCL_WAIT_SET_SPIN_RELAX_NONE},
+    {"spin 50us + pause", RCL_US_TO_NS(50), RCL_WAIT_SET_SPIN_RELAX_PAUSE},
+    {"spin 1ms + pause", RCL_MS_TO_NS(1), RCL_WAIT_SET_SPIN_RELAX_PAUSE},
+    {"spin 1ms + yield", RCL_MS_TO_NS(1), RCL_WAIT_SET_SPIN_RELAX_YIELD},
+  };
+  // Upper bounds of the histogram buckets in microseconds, the last one is unbounded.
+  const int64_t kBuckets[] = {5, 10, 20, 50, 100};
+  const size_t kNumBuckets = sizeof(kBuckets) / sizeof(kBuckets[0]) + 1u;
+  for (const Strategy & strategy : strategies) {
+    ret = rcl_wait_set_set_spin_budget(&wait_set, strategy.spin_budget, strategy.relax);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    std::atomic<int64_t> triggered_at(0);
+    std::atomic<bool> woken(true);
+    std::atomic<bool> stop(false);
+    // Only the main thread asserts, the trigger thread collects its results.
+    std::vector<rcl_ret_t> trigger_results;
+    trigger_results.reserve(kNumSamples);
+    std::thread trigger_thread([&]() {
+        for (size_t sample = 0u; sample < kNumSamples; ++sample) {
+          while (!woken && !stop) {
+            std::this_thread::yield();
+          }
+          if (stop) {
+            break;
+          }
+          woken = false;
+          std::this_thread::sleep_for(kTriggerPeriod);
+          triggered_at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+          trigger_results.push_back(rcl_trigger_guard_condition(&guard_condition));
+        }
+      });
+    std::vector<int64_t> latencies;
+    latencies.reserve(kNumSamples);
+    std::vector<rcl_ret_t> wait_results;
+    wait_results.reserve(kNumSamples);
+    while (latencies.size() < kNumSamples) {
+      ret = rcl_wait(&wait_set, RCL_S_TO_NS(1));
+      wait_results.push_back(ret);
+      if (RCL_RET_OK != ret) {
+        break;
+      }
+      int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+      latencies.push_back(now - triggered_at);
+      woken = true;
+    }
+    stop = true;
+    trigger_thread.join();
+    for (rcl_ret_t result : trigger_results) {
+      ASSERT_EQ(RCL_RET_OK, result);
+    }
+    for (rcl_ret_t result : wait_results) {
+      ASSERT_EQ(RCL_RET_OK, result) << rcl_get_error_string().str;
+    }
+    ASSERT_EQ(kNumSamples, latencies.size());
+
+    std::sort(latencies.begin(), latencies.end());
+    std::vector<size_t> histogram(kNumBuckets, 0u);
+    for (int64_t latency : latencies) {
+      size_t bucket = 0u;
+      while (bucket < kNumBuckets - 1u && RCL_NS_TO_US(latency) >= kBuckets[bucket]) {
+        ++bucket;
+      }
+      ++histogram[bucket];
+    }
+    std::stringstream ss;
+    ss << strategy.name << ": wakeup latency p50 " << RCL_NS_TO_US(latencies[kNumSamples / 2]) <<
+      "us, p99 " << RCL_NS_TO_US(latencies[kNumSamples * 99 / 100]) << "us, max " <<
+      RCL_NS_TO_US(latencies.back()) << "us, histogram";
+    for (size_t bucket = 0u; bucket < kNumBuckets; ++bucket) {
+      if (bucket < kNumBuckets - 1u) {
+        ss << " <" << kBuckets[bucket] << "us: " << histogram[bucket];
+      } else {
+        ss << " >=" << kBuckets[bucket - 1u] << "us: " << histogram[bucket];
+      }
+    }
+    RCUTILS_LOG_INFO_NAMED(ROS_PACKAGE_NAME, "%s", ss.str().c_str());
+  }
+}
@@ -0,0 +1,345 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+#include "rcl/wait_set_group.h"
+
+#include "rcutils/logging_macros.h"
+
+#ifdef RMW_IMPLEMENTATION
+# define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
+# define CLASSNAME(NAME, SUFFIX) CLASSNAME_(NAME, SUFFIX)
+#else
+# define CLASSNAME(NAME, SUFFIX) NAME
+#endif
+
+class CLASSNAME (WaitSetGroupTestFixture, RMW_IMPLEMENTATION) : public ::testing::Test
+{
+public:
+  rcl_context_t * context_ptr;
+  void SetUp()
+  {
+    rcl_ret_t ret;
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+    });
+    this->context_ptr = new rcl_context_t;
+    *this->context_ptr = rcl_get_zero_initialized_context();
+    ret = rcl_init(0, nullptr, &init_options, this->context_ptr);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  void TearDown()
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(this->context_ptr)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(this->context_ptr)) << rcl_get_error_string().str;
+    delete this->context_ptr;
+  }
+
+  void init_guard_conditions(std::vector<rcl_guard_condition_t> & guard_conditions)
+  {
+    for (auto & guard_condition : guard_conditions) {
+      guard_condition = rcl_get_zero_initialized_guard_condition();
+      ASSERT_EQ(
+        RCL_RET_OK, rcl_guard_condition_init(
+          &guard_condition, this->context_ptr, rcl_guard_condition_get_default_options())) <<
+        rcl_get_error_string().str;
+    }
+  }
+
+  void fini_guard_conditions(std::vector<rcl_guard_condition_t> & guard_conditions)
+  {
+    for (auto & guard_condition : guard_conditions) {
+      EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition)) <<
+        rcl_get_error_string().str;
+    }
+  }
+};
+
+TEST_F(CLASSNAME(WaitSetGroupTestFixture, RMW_IMPLEMENTATION), init_fini) {
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_wait_set_group_t group = rcl_get_zero_initialized_wait_set_group();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_group_init(nullptr, 2u, context_ptr, allocator));
+  rcl_reset_error();
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_group_init(&group, 0u, context_ptr, allocator));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_NOT_INIT, rcl_wait_set_group_init(&group, 2u, nullptr, allocator));
+  rcl_reset_error();
+
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_init(&group, 2u, context_ptr, allocator)) <<
+    rcl_get_error_string().str;
+  EXPECT_EQ(2u, group.shard_count);
+  EXPECT_EQ(
+    RCL_RET_ALREADY_INIT, rcl_wait_set_group_init(&group, 2u, context_ptr, allocator));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_fini(&group)) << rcl_get_error_string().str;
+  EXPECT_EQ(nullptr, group.impl);
+  // Finalizing a zero initialized group does nothing.
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_fini(&group)) << rcl_get_error_string().str;
+
+  rcl_wait_set_group_work_t work;
+  bool taken = false;
+  EXPECT_EQ(
+    RCL_RET_WAIT_SET_INVALID, rcl_wait_set_group_take_work(&group, 0u, &work, &taken));
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_WAIT_SET_INVALID, rcl_wait_set_group_wait(&group, 0u, 0));
+  rcl_reset_error();
+}
+
+TEST_F(CLASSNAME(WaitSetGroupTestFixture, RMW_IMPLEMENTATION), shard_and_steal) {
+  const size_t kNumEntities = 4u;
+  std::vector<rcl_guard_condition_t> guard_conditions(kNumEntities);
+  init_guard_conditions(guard_conditions);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    fini_guard_conditions(guard_conditions);
+  });
+  rcl_wait_set_group_t group = rcl_get_zero_initialized_wait_set_group();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_group_init(&group, 2u, context_ptr, rcl_get_default_allocator())) <<
+    rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_fini(&group)) << rcl_get_error_string().str;
+  });
+
+  // Entities are spread evenly over the shards.
+  std::vector<size_t> shards(kNumEntities);
+  size_t per_shard[2] = {0u, 0u};
+  for (size_t i = 0u; i < kNumEntities; ++i) {
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_wait_set_group_add(
+        &group, RCL_WAIT_SET_GUARD_CONDITION, &guard_conditions[i], &shards[i])) <<
+      rcl_get_error_string().str;
+    ASSERT_LT(shards[i], 2u);
+    ++per_shard[shards[i]];
+  }
+  EXPECT_EQ(2u, per_shard[0]);
+  EXPECT_EQ(2u, per_shard[1]);
+  EXPECT_EQ(
+    RCL_RET_INVALID_ARGUMENT, rcl_wait_set_group_add(
+      &group, RCL_WAIT_SET_GUARD_CONDITION, &guard_conditions[0], nullptr));
+  rcl_reset_error();
+
+  // Nothing ready yet.
+  const size_t owner = shards[0];
+  const size_t thief = 1u - owner;
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait_set_group_wait(&group, owner, 0));
+  rcl_reset_error();
+  rcl_wait_set_group_work_t work;
+  bool taken = true;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, owner, &work, &taken));
+  EXPECT_FALSE(taken);
+
+  // The other shard steals the ready entity from the queue of its owner.
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_wait(&group, owner, RCL_MS_TO_NS(100))) <<
+    rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, thief, &work, &taken));
+  ASSERT_TRUE(taken);
+  EXPECT_EQ(RCL_WAIT_SET_GUARD_CONDITION, work.type);
+  EXPECT_EQ(&guard_conditions[0], work.entity);
+  EXPECT_EQ(owner, work.shard);
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, thief, &work, &taken));
+  EXPECT_FALSE(taken);
+
+  // Until its work is done the entity is not waited on, even if triggered again.
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+  EXPECT_EQ(RCL_RET_TIMEOUT, rcl_wait_set_group_wait(&group, owner, 0));
+  rcl_reset_error();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_work_done(&group, thief, &work));
+  // Work done by another shard wakes the owner up, which then sees the entity again.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_wait(&group, owner, RCL_MS_TO_NS(100)));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, owner, &work, &taken));
+  ASSERT_TRUE(taken);
+  EXPECT_EQ(&guard_conditions[0], work.entity);
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_work_done(&group, owner, &work));
+
+  // Interrupting wakes every shard without queuing anything.
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_interrupt(&group));
+  for (size_t shard = 0u; shard < 2u; ++shard) {
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_wait(&group, shard, RCL_MS_TO_NS(100)));
+    ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, shard, &work, &taken));
+    EXPECT_FALSE(taken);
+  }
+
+  // A removed entity is dropped from the queue it is in.
+  ASSERT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_conditions[0]));
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_wait(&group, owner, RCL_MS_TO_NS(100)));
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_group_remove(
+      &group, RCL_WAIT_SET_GUARD_CONDITION, &guard_conditions[0])) << rcl_get_error_string().str;
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, owner, &work, &taken));
+  EXPECT_FALSE(taken);
+  EXPECT_EQ(
+    RCL_RET_ERROR, rcl_wait_set_group_remove(
+      &group, RCL_WAIT_SET_GUARD_CONDITION, &guard_conditions[0]));
+  rcl_reset_error();
+  // Its entry is reused, on the shard which now has the fewest entities.
+  size_t shard = 0u;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_wait_set_group_add(
+      &group, RCL_WAIT_SET_GUARD_CONDITION, &guard_conditions[0], &shard));
+  EXPECT_EQ(owner, shard);
+}
+
+// Simulated cost of handling a ready entity, e.g. deserializing and running a callback.
+static void spin_for(std::chrono::microseconds duration)
+{
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+// Compare the throughput of one thread waiting on one wait set with worker threads waiting
+// on the shards of a wait set group, while all the entities are kept busy.
+// This is a benchmark which only logs its results, run it with --gtest_also_run_disabled_tests.
+TEST_F(CLASSNAME(WaitSetGroupTestFixture, RMW_IMPLEMENTATION), DISABLED_throughput) {
+  const size_t kNumEntities = 64u;
+  const size_t kNumWorkers = 4u;
+  const size_t kNumItems = 4000u;
+  const std::chrono::microseconds kWorkCost(20);
+  std::vector<rcl_guard_condition_t> guard_conditions(kNumEntities);
+  init_guard_conditions(guard_conditions);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    fini_guard_conditions(guard_conditions);
+  });
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> handled(0u);
+  auto producer = [&]() {
+      while (!done) {
+        for (auto & guard_condition : guard_conditions) {
+          EXPECT_EQ(RCL_RET_OK, rcl_trigger_guard_condition(&guard_condition));
+        }
+        std::this_thread::yield();
+      }
+    };
+
+  // Single wait set, one thread.
+  double single_rate = 0.0;
+  {
+    rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_wait_set_init(
+        &wait_set, 0, kNumEntities, 0, 0, 0, 0, context_ptr, rcl_get_default_allocator()));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set));
+    });
+    done = false;
+    handled = 0u;
+    std::thread producer_thread(producer);
+    auto start = std::chrono::steady_clock::now();
+    while (handled < kNumItems) {
+      EXPECT_EQ(RCL_RET_OK, rcl_wait_set_clear(&wait_set));
+      for (auto & guard_condition : guard_conditions) {
+        EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(&wait_set, &guard_condition, NULL));
+      }
+      rcl_ret_t ret = rcl_wait(&wait_set, RCL_MS_TO_NS(10));
+      if (RCL_RET_OK != ret) {
+        rcl_reset_error();
+        continue;
+      }
+      for (size_t i = 0u; i < kNumEntities; ++i) {
+        if (wait_set.guard_conditions[i]) {
+          spin_for(kWorkCost);
+          ++handled;
+        }
+      }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    done = true;
+    producer_thread.join();
+    single_rate = handled / std::chrono::duration<double>(elapsed).count();
+  }
+
+  // Wait set group, one thread per shard.
+  double group_rate = 0.0;
+  size_t stolen_count = 0u;
+  {
+    rcl_wait_set_group_t group = rcl_get_zero_initialized_wait_set_group();
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_wait_set_group_init(
+        &group, kNumWorkers, context_ptr, rcl_get_default_allocator()));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_fini(&group));
+    });
+    for (auto & guard_condition : guard_conditions) {
+      ASSERT_EQ(
+        RCL_RET_OK, rcl_wait_set_group_add(
+          &group, RCL_WAIT_SET_GUARD_CONDITION, &guard_condition, nullptr));
+    }
+    done = false;
+    handled = 0u;
+    std::atomic<size_t> stolen(0u);
+    auto worker = [&](size_t shard) {
+        while (handled < kNumItems) {
+          rcl_wait_set_group_work_t work;
+          bool taken = false;
+          EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_take_work(&group, shard, &work, &taken));
+          if (!taken) {
+            if (RCL_RET_OK != rcl_wait_set_group_wait(&group, shard, RCL_MS_TO_NS(10))) {
+              rcl_reset_error();
+            }
+            continue;
+          }
+          spin_for(kWorkCost);
+          ++handled;
+          if (work.shard != shard) {
+            ++stolen;
+          }
+          EXPECT_EQ(RCL_RET_OK, rcl_wait_set_group_work_done(&group, shard, &work));
+        }
+      };
+    std::thread producer_thread(producer);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t shard = 0u; shard < kNumWorkers; ++shard) {
+      workers.emplace_back(worker, shard);
+    }
+    for (auto & worker_thread : workers) {
+      worker_thread.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    done = true;
+    producer_thread.join();
+    group_rate = handled / std::chrono::duration<double>(elapsed).count();
+    stolen_count = stolen;
+  }
+
+  std::stringstream ss;
+  ss << "entities handled per second with " << kNumEntities << " entities: single wait set " <<
+    single_rate << ", wait set group of " << kNumWorkers << " shards " << group_rate <<
+    " (" << stolen_count << " stolen)";
+  RCUTILS_LOG_INFO_NAMED(ROS_PACKAGE_NAME, "%s", ss.str().c_str());
+}